@@ -0,0 +1,600 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_daemon.c
+ *
+ *  Acquisition daemon owning the serial ports of all SPS30. It starts the
+ *  measurement on every port and reads one sample per port and second.
+ *  Clients connect to a Unix domain socket, see sps30_daemon_protocol.h,
+ *  instead of opening the serial ports themselves. All transactions run on
+ *  the main thread in the order of the device schedule, so no two commands
+ *  ever share a serial line.
+ *
+ *  Usage: sps30_daemon [-s socket] [-m shm_name] device...
+ *
+ *  The devices are assigned port indices in the given order. Devices which
+ *  cannot be opened or started are retried every SPS30_DAEMON_RESTART_MS.
+ *  With -m the latest values are also published to a shared memory table,
+ *  see sps30_latest_shm.h.
+ */
+
+/* Enable sigaction and getopt functions */
+#define _DEFAULT_SOURCE
+
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_cleaning.h"
+#include "sps30_daemon_protocol.h"
+#include "sps30_fast_start.h"
+#include "sps30_health.h"
+#include "sps30_hooks.h"
+#include "sps30_latest.h"
+#include "sps30_latest_shm.h"
+#include "sps30_uart.h"
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef SPS30_DAEMON_MAX_CLIENTS
+#define SPS30_DAEMON_MAX_CLIENTS 32
+#endif
+
+/** Commands waiting per port for its next slot in the schedule */
+#ifndef SPS30_DAEMON_QUEUE_SIZE
+#define SPS30_DAEMON_QUEUE_SIZE 8
+#endif
+
+/** Period of the schedule, the SPS30 provides new values every second */
+#define SPS30_DAEMON_PERIOD_MS 1000
+
+#define SPS30_DAEMON_START_TIMEOUT_MS 10000
+
+/** Interval at which ports are started again whose start failed */
+#ifndef SPS30_DAEMON_RESTART_MS
+#define SPS30_DAEMON_RESTART_MS 10000
+#endif
+
+struct sps30_daemon_job {
+    int16_t client;  //< index of the client, -1 after it disconnected
+    struct sps30_daemon_request request;
+};
+
+struct sps30_daemon_port {
+    bool opened;                 //< the serial port was opened
+    bool running;                //< the measurement was started
+    uint64_t restart_us;         //< next start attempt while not running
+    bool has_sample;             //< latest holds a sample
+    struct sps30_sample latest;  //< last sample read
+    uint16_t jobs;               //< commands queued
+    struct sps30_daemon_job queue[SPS30_DAEMON_QUEUE_SIZE];
+};
+
+struct sps30_daemon_client {
+    int fd;            //< -1 for a free slot
+    uint32_t dropped;  //< messages dropped because the client was too slow
+    bool subscribed[SENSIRION_UART_MAX_PORTS];
+};
+
+static struct sps30_daemon_port daemon_ports[SENSIRION_UART_MAX_PORTS];
+static struct sps30_daemon_client daemon_clients[SPS30_DAEMON_MAX_CLIENTS];
+static uint16_t daemon_port_count;
+static char* const* daemon_devices;
+static volatile sig_atomic_t daemon_stop;
+
+static void sps30_daemon_signal(int signal_number) {
+    (void)signal_number;
+    daemon_stop = 1;
+}
+
+static void sps30_daemon_close_client(int16_t client) {
+    uint16_t port;
+    uint16_t i;
+
+    close(daemon_clients[client].fd);
+    daemon_clients[client].fd = -1;
+    /* queued commands still run, their replies are discarded */
+    for (port = 0; port < daemon_port_count; port++) {
+        for (i = 0; i < daemon_ports[port].jobs; i++) {
+            if (daemon_ports[port].queue[i].client == client) {
+                daemon_ports[port].queue[i].client = -1;
+            }
+        }
+    }
+}
+
+/* never blocks, a client which does not keep up loses messages */
+static void sps30_daemon_send(int16_t client,
+                              const struct sps30_daemon_message* message) {
+    struct sps30_daemon_client* c = &daemon_clients[client];
+
+    if (send(c->fd, message, sizeof(*message), MSG_DONTWAIT | MSG_NOSIGNAL) ==
+        (ssize_t)sizeof(*message)) {
+        return;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        c->dropped++;
+        return;
+    }
+    sps30_daemon_close_client(client);
+}
+
+static void sps30_daemon_reply(int16_t client,
+                               const struct sps30_daemon_request* request,
+                               int16_t error, uint32_t value,
+                               const struct sps30_sample* sample) {
+    struct sps30_daemon_message message;
+
+    memset(&message, 0, sizeof(message));
+    message.type = SPS30_DAEMON_REPLY;
+    message.port = request->port;
+    message.command = request->command;
+    message.error = error;
+    message.tag = request->tag;
+    message.value = value;
+    if (sample != NULL) {
+        message.sample = *sample;
+    }
+    sps30_daemon_send(client, &message);
+}
+
+static void sps30_daemon_subscribe(int16_t client, uint16_t port,
+                                   bool subscribed) {
+    uint16_t i;
+
+    for (i = 0; i < daemon_port_count; i++) {
+        if (port == SPS30_DAEMON_ALL_PORTS || port == i) {
+            daemon_clients[client].subscribed[i] = subscribed;
+        }
+    }
+}
+
+static void
+sps30_daemon_handle_request(int16_t client,
+                            const struct sps30_daemon_request* request) {
+    struct sps30_daemon_port* port;
+    struct sps30_daemon_job* job;
+
+    if (request->port >= daemon_port_count &&
+        !(request->port == SPS30_DAEMON_ALL_PORTS &&
+          (request->command == SPS30_DAEMON_SUBSCRIBE ||
+           request->command == SPS30_DAEMON_UNSUBSCRIBE))) {
+        sps30_daemon_reply(client, request,
+                           SENSIRION_SHDLC_ERR_INVALID_ARGUMENT, 0, NULL);
+        return;
+    }
+    switch (request->command) {
+        case SPS30_DAEMON_SUBSCRIBE:
+        case SPS30_DAEMON_UNSUBSCRIBE:
+            sps30_daemon_subscribe(client, request->port,
+                                   request->command == SPS30_DAEMON_SUBSCRIBE);
+            sps30_daemon_reply(client, request, NO_ERROR, 0, NULL);
+            return;
+        case SPS30_DAEMON_LATEST:
+            port = &daemon_ports[request->port];
+            if (!port->has_sample) {
+                sps30_daemon_reply(client, request,
+                                   SENSIRION_SHDLC_ERR_NO_DATA, 0, NULL);
+                return;
+            }
+            sps30_daemon_reply(client, request, NO_ERROR, 0, &port->latest);
+            return;
+        case SPS30_DAEMON_FAN_CLEANING:
+        case SPS30_DAEMON_READ_STATUS:
+            port = &daemon_ports[request->port];
+            if (!port->running || port->jobs >= SPS30_DAEMON_QUEUE_SIZE) {
+                sps30_daemon_reply(client, request,
+                                   SENSIRION_SHDLC_ERR_NO_DATA, 0, NULL);
+                return;
+            }
+            job = &port->queue[port->jobs++];
+            job->client = client;
+            job->request = *request;
+            return;
+        default:
+            sps30_daemon_reply(client, request,
+                               SENSIRION_SHDLC_ERR_NOT_SUPPORTED, 0, NULL);
+            return;
+    }
+}
+
+/* the queued commands of the selected port, in the order received */
+static void sps30_daemon_run_jobs(struct sps30_daemon_port* port) {
+    struct sps30_daemon_job* job;
+    uint32_t device_status;
+    uint8_t reserved;
+    int16_t error;
+    uint16_t i;
+
+    for (i = 0; i < port->jobs; i++) {
+        job = &port->queue[i];
+        device_status = 0;
+        if (job->request.command == SPS30_DAEMON_FAN_CLEANING) {
+            error = sps30_start_fan_cleaning();
+        } else {
+            error = sps30_read_device_status_register(
+                job->request.argument != 0, &device_status, &reserved);
+        }
+        (void)sps30_health_update(error);
+        if (job->client >= 0) {
+            sps30_daemon_reply(job->client, &job->request, error,
+                               device_status, NULL);
+        }
+    }
+    port->jobs = 0;
+}
+
+static void sps30_daemon_acquire(uint16_t index) {
+    struct sps30_daemon_port* port = &daemon_ports[index];
+    struct sps30_daemon_message message;
+    struct sps30_sample sample;
+    int16_t client;
+    int16_t error;
+
+    /* the values are not valid while the fan runs at full speed */
+    if (sps30_cleaning_is_active()) {
+        return;
+    }
+    error = sps30_sample_read(&sample);
+    (void)sps30_health_update(error);
+    if (error != NO_ERROR) {
+        return;
+    }
+    port->latest = sample;
+    port->has_sample = true;
+
+    memset(&message, 0, sizeof(message));
+    message.type = SPS30_DAEMON_SAMPLE;
+    message.port = index;
+    message.sample = sample;
+    for (client = 0; client < SPS30_DAEMON_MAX_CLIENTS; client++) {
+        if (daemon_clients[client].fd >= 0 &&
+            daemon_clients[client].subscribed[index]) {
+            sps30_daemon_send(client, &message);
+        }
+    }
+}
+
+/* start a port again, e.g. a sensor which was plugged in later */
+static void sps30_daemon_restart(uint16_t index) {
+    struct sps30_daemon_port* port = &daemon_ports[index];
+    struct sps30_fast_start_result result;
+    /* the first sample is read by the schedule, do not wait for it */
+    struct sps30_fast_start_config config = {true, NULL, 0};
+
+    port->restart_us = sensirion_uart_hal_get_time_usec() +
+                       (uint64_t)SPS30_DAEMON_RESTART_MS * 1000;
+    if (!port->opened) {
+        if (sensirion_uart_hal_init(daemon_devices[index]) != NO_ERROR) {
+            return;
+        }
+        port->opened = true;
+    }
+    (void)sps30_fast_start(&config, &result);
+    /* NO_DATA: the measurement runs, its first sample is not read yet */
+    if (result.error != NO_ERROR &&
+        result.error != SENSIRION_SHDLC_ERR_NO_DATA) {
+        return;
+    }
+    fprintf(stderr, "port %u: started %s\n", index, daemon_devices[index]);
+    port->running = true;
+}
+
+static void sps30_daemon_cycle(void) {
+    uint64_t now_us = sensirion_uart_hal_get_time_usec();
+    uint16_t i;
+
+    for (i = 0; i < daemon_port_count; i++) {
+        sensirion_uart_hal_select_port(i);
+        if (!daemon_ports[i].running) {
+            if (now_us >= daemon_ports[i].restart_us) {
+                sps30_daemon_restart(i);
+            }
+            continue;
+        }
+        sps30_daemon_run_jobs(&daemon_ports[i]);
+        sps30_daemon_acquire(i);
+    }
+}
+
+static void sps30_daemon_accept(int listen_fd) {
+    int16_t client;
+    int fd;
+
+    fd = accept(listen_fd, NULL, NULL);
+    if (fd < 0) {
+        return;
+    }
+    for (client = 0; client < SPS30_DAEMON_MAX_CLIENTS; client++) {
+        if (daemon_clients[client].fd < 0) {
+            memset(&daemon_clients[client], 0, sizeof(daemon_clients[client]));
+            daemon_clients[client].fd = fd;
+            return;
+        }
+    }
+    close(fd);
+}
+
+static void sps30_daemon_receive(int16_t client) {
+    struct sps30_daemon_request request;
+    ssize_t len;
+
+    len = recv(daemon_clients[client].fd, &request, sizeof(request),
+               MSG_DONTWAIT);
+    if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return;
+    }
+    if (len != (ssize_t)sizeof(request)) {
+        /* hang-up, error or a client speaking another protocol */
+        sps30_daemon_close_client(client);
+        return;
+    }
+    sps30_daemon_handle_request(client, &request);
+}
+
+/* serve the clients until the next slot of the schedule is due */
+static void sps30_daemon_serve(int listen_fd, uint64_t until_us) {
+    struct pollfd fds[SPS30_DAEMON_MAX_CLIENTS + 1];
+    int16_t owners[SPS30_DAEMON_MAX_CLIENTS + 1];
+    uint64_t now_us;
+    nfds_t count;
+    int16_t client;
+    nfds_t i;
+    int ready;
+
+    while (!daemon_stop) {
+        now_us = sensirion_uart_hal_get_time_usec();
+        if (now_us >= until_us) {
+            return;
+        }
+        fds[0].fd = listen_fd;
+        fds[0].events = POLLIN;
+        owners[0] = -1;
+        count = 1;
+        for (client = 0; client < SPS30_DAEMON_MAX_CLIENTS; client++) {
+            if (daemon_clients[client].fd >= 0) {
+                fds[count].fd = daemon_clients[client].fd;
+                fds[count].events = POLLIN;
+                owners[count] = client;
+                count++;
+            }
+        }
+        ready = poll(fds, count, (int)((until_us - now_us + 999) / 1000));
+        if (ready <= 0) {
+            continue;
+        }
+        if ((fds[0].revents & POLLIN) != 0) {
+            sps30_daemon_accept(listen_fd);
+        }
+        for (i = 1; i < count; i++) {
+            /* the client may have been closed by a reply in this loop */
+            if (fds[i].revents != 0 &&
+                daemon_clients[owners[i]].fd == fds[i].fd) {
+                sps30_daemon_receive(owners[i]);
+            }
+        }
+    }
+}
+
+/*
+ * Listen on the socket path. Fails with EADDRINUSE if another daemon
+ * answers on it, a socket left behind by a daemon which did not exit
+ * cleanly is replaced.
+ */
+static int sps30_daemon_listen(const char* path) {
+    /* bind() and connect() take the generic type of the address */
+    union {
+        struct sockaddr_un un;
+        struct sockaddr any;
+    } address;
+    int probe_fd;
+    int fd;
+
+    if (strlen(path) >= sizeof(address.un.sun_path)) {
+        return -1;
+    }
+    fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.un.sun_family = AF_UNIX;
+    strcpy(address.un.sun_path, path);
+    probe_fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (probe_fd < 0) {
+        close(fd);
+        return -1;
+    }
+    if (connect(probe_fd, &address.any, sizeof(address.un)) == 0) {
+        close(probe_fd);
+        close(fd);
+        errno = EADDRINUSE;
+        return -1;
+    }
+    /* nobody accepts on a stale socket */
+    if (errno == ECONNREFUSED) {
+        unlink(path);
+    }
+    close(probe_fd);
+    if (bind(fd, &address.any, sizeof(address.un)) != 0 ||
+        listen(fd, SPS30_DAEMON_MAX_CLIENTS) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* ports which fail to open or start are started again by the schedule */
+static void sps30_daemon_start(void) {
+    struct sps30_fast_start_result results[SENSIRION_UART_MAX_PORTS];
+    struct sps30_fast_start_config config = {
+        true, NULL, SPS30_DAEMON_START_TIMEOUT_MS};
+    uint16_t opened[SENSIRION_UART_MAX_PORTS];
+    uint64_t restart_us;
+    uint16_t count = 0;
+    uint16_t i;
+
+    for (i = 0; i < daemon_port_count; i++) {
+        sensirion_uart_hal_select_port(i);
+        if (sensirion_uart_hal_init(daemon_devices[i]) != NO_ERROR) {
+            fprintf(stderr, "port %u: cannot open %s\n", i, daemon_devices[i]);
+            continue;
+        }
+        daemon_ports[i].opened = true;
+        opened[count++] = i;
+    }
+    (void)sps30_fast_start_fleet(opened, count, &config, results);
+    restart_us = sensirion_uart_hal_get_time_usec() +
+                 (uint64_t)SPS30_DAEMON_RESTART_MS * 1000;
+    for (i = 0; i < daemon_port_count; i++) {
+        daemon_ports[i].restart_us = restart_us;
+    }
+    for (i = 0; i < count; i++) {
+        if (results[i].error != NO_ERROR) {
+            fprintf(stderr, "port %u: start failed with %i\n", opened[i],
+                    results[i].error);
+            continue;
+        }
+        daemon_ports[opened[i]].running = true;
+        daemon_ports[opened[i]].latest = results[i].sample;
+        daemon_ports[opened[i]].has_sample = true;
+    }
+}
+
+static void sps30_daemon_shutdown(void) {
+    int16_t client;
+    uint16_t i;
+
+    for (client = 0; client < SPS30_DAEMON_MAX_CLIENTS; client++) {
+        if (daemon_clients[client].fd >= 0) {
+            sps30_daemon_close_client(client);
+        }
+    }
+    for (i = 0; i < daemon_port_count; i++) {
+        sensirion_uart_hal_select_port(i);
+        if (daemon_ports[i].running) {
+            (void)sps30_stop_measurement();
+        }
+        if (daemon_ports[i].opened) {
+            (void)sensirion_uart_hal_free();
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* socket_path = SPS30_DAEMON_SOCKET_PATH;
+    const char* shm_name = NULL;
+    struct sps30_latest_table* table = NULL;
+    struct sigaction action;
+    uint64_t next_us;
+    int16_t client;
+    int listen_fd;
+    int option;
+
+    while ((option = getopt(argc, argv, "s:m:")) != -1) {
+        switch (option) {
+            case 's':
+                socket_path = optarg;
+                break;
+            case 'm':
+                shm_name = optarg;
+                break;
+            default:
+                fprintf(stderr,
+                        "usage: %s [-s socket] [-m shm_name] device...\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+    if (optind >= argc || argc - optind > SENSIRION_UART_MAX_PORTS) {
+        fprintf(stderr, "pass 1 to %u devices\n", SENSIRION_UART_MAX_PORTS);
+        return 1;
+    }
+    daemon_port_count = (uint16_t)(argc - optind);
+    daemon_devices = &argv[optind];
+    for (client = 0; client < SPS30_DAEMON_MAX_CLIENTS; client++) {
+        daemon_clients[client].fd = -1;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = sps30_daemon_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    /* before the shared memory, which a running daemon publishes to */
+    listen_fd = sps30_daemon_listen(socket_path);
+    if (listen_fd < 0) {
+        fprintf(stderr, "cannot listen on %s: %s\n", socket_path,
+                errno == EADDRINUSE ? "another daemon is running"
+                                    : strerror(errno));
+        return 1;
+    }
+    if (shm_name != NULL) {
+        if (sps30_latest_shm_create(shm_name, &table) != NO_ERROR) {
+            fprintf(stderr, "cannot create shared memory %s\n", shm_name);
+            close(listen_fd);
+            unlink(socket_path);
+            return 1;
+        }
+        sps30_latest_publish_to(table);
+    }
+
+    sps30_hooks_install();
+    sps30_daemon_start();
+    next_us = sensirion_uart_hal_get_time_usec();
+    while (!daemon_stop) {
+        next_us += (uint64_t)SPS30_DAEMON_PERIOD_MS * 1000;
+        /* after an overlong cycle, e.g. a recovery, do not catch up */
+        if (next_us < sensirion_uart_hal_get_time_usec()) {
+            next_us = sensirion_uart_hal_get_time_usec();
+        }
+        sps30_daemon_serve(listen_fd, next_us);
+        if (daemon_stop) {
+            break;
+        }
+        sps30_daemon_cycle();
+    }
+
+    sps30_daemon_shutdown();
+    close(listen_fd);
+    unlink(socket_path);
+    if (table != NULL) {
+        sps30_latest_publish_to(NULL);
+        sps30_latest_shm_close(table);
+    }
+    return 0;
+}
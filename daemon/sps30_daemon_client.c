@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_daemon_client.c
+ *
+ *  Command line client of sps30_daemon.
+ *
+ *  Usage: sps30_daemon_client [-s socket] command [port]
+ *
+ *  Commands are latest, status, clear-status, clean and subscribe. Without a
+ *  port subscribe streams the samples of all ports until interrupted, the
+ *  other commands use port 0.
+ */
+
+/* Enable getopt function */
+#define _DEFAULT_SOURCE
+
+#include "sensirion_common.h"
+#include "sps30_daemon_protocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static int sps30_daemon_client_connect(const char* path) {
+    union {
+        struct sockaddr_un un;
+        struct sockaddr any;
+    } address;
+    int fd;
+
+    if (strlen(path) >= sizeof(address.un.sun_path)) {
+        return -1;
+    }
+    fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.un.sun_family = AF_UNIX;
+    strcpy(address.un.sun_path, path);
+    if (connect(fd, &address.any, sizeof(address.un)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void
+sps30_daemon_client_print(const struct sps30_daemon_message* message) {
+    const struct sps30_sample* sample = &message->sample;
+
+    printf("port %u t %llu mc_1p0 %.2f mc_2p5 %.2f mc_4p0 %.2f mc_10p0 %.2f "
+           "nc_0p5 %.2f nc_1p0 %.2f nc_2p5 %.2f nc_4p0 %.2f nc_10p0 %.2f "
+           "typical_particle_size %.3f\n",
+           message->port, (unsigned long long)sample->timestamp_us,
+           sample->mc_1p0, sample->mc_2p5, sample->mc_4p0, sample->mc_10p0,
+           sample->nc_0p5, sample->nc_1p0, sample->nc_2p5, sample->nc_4p0,
+           sample->nc_10p0, sample->typical_particle_size);
+    /* streams are usually piped to another tool */
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
+    const char* socket_path = SPS30_DAEMON_SOCKET_PATH;
+    struct sps30_daemon_request request;
+    struct sps30_daemon_message message;
+    const char* command;
+    int option;
+    int fd;
+
+    while ((option = getopt(argc, argv, "s:")) != -1) {
+        if (option != 's') {
+            optind = argc;
+            break;
+        }
+        socket_path = optarg;
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-s socket] latest|status|clear-status|"
+                        "clean|subscribe [port]\n",
+                argv[0]);
+        return 1;
+    }
+    command = argv[optind];
+    memset(&request, 0, sizeof(request));
+    request.port = 0;
+    if (optind + 1 < argc) {
+        request.port = (uint16_t)strtoul(argv[optind + 1], NULL, 0);
+    } else if (strcmp(command, "subscribe") == 0) {
+        request.port = SPS30_DAEMON_ALL_PORTS;
+    }
+    if (strcmp(command, "latest") == 0) {
+        request.command = SPS30_DAEMON_LATEST;
+    } else if (strcmp(command, "status") == 0) {
+        request.command = SPS30_DAEMON_READ_STATUS;
+    } else if (strcmp(command, "clear-status") == 0) {
+        request.command = SPS30_DAEMON_READ_STATUS;
+        request.argument = 1;
+    } else if (strcmp(command, "clean") == 0) {
+        request.command = SPS30_DAEMON_FAN_CLEANING;
+    } else if (strcmp(command, "subscribe") == 0) {
+        request.command = SPS30_DAEMON_SUBSCRIBE;
+    } else {
+        fprintf(stderr, "unknown command %s\n", command);
+        return 1;
+    }
+
+    fd = sps30_daemon_client_connect(socket_path);
+    if (fd < 0) {
+        fprintf(stderr, "cannot connect to %s\n", socket_path);
+        return 1;
+    }
+    if (send(fd, &request, sizeof(request), 0) != (ssize_t)sizeof(request)) {
+        close(fd);
+        return 1;
+    }
+    while (recv(fd, &message, sizeof(message), 0) == (ssize_t)sizeof(message)) {
+        if (message.type == SPS30_DAEMON_SAMPLE) {
+            sps30_daemon_client_print(&message);
+            continue;
+        }
+        if (message.error != NO_ERROR) {
+            fprintf(stderr, "error %i\n", message.error);
+            close(fd);
+            return 1;
+        }
+        if (request.command == SPS30_DAEMON_LATEST) {
+            sps30_daemon_client_print(&message);
+        } else if (request.command == SPS30_DAEMON_READ_STATUS) {
+            printf("port %u device_status 0x%08x\n", message.port,
+                   (unsigned)message.value);
+        }
+        if (request.command != SPS30_DAEMON_SUBSCRIBE) {
+            break;
+        }
+    }
+    close(fd);
+    return 0;
+}
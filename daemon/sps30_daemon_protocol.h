@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_daemon_protocol.h
+ *
+ *  Messages between sps30_daemon and its clients. The daemon listens on a
+ *  Unix domain socket of type SOCK_SEQPACKET, so every request and every
+ *  message is one packet of the size of its struct, in host byte order.
+ *
+ *  A client sends struct sps30_daemon_request and receives
+ *  struct sps30_daemon_message: one reply per request, carrying the tag of
+ *  the request, and the samples of the ports it subscribed to. Latest values
+ *  and subscriptions are served from the daemon's memory without a
+ *  transaction on the UART. Fan cleaning and status reads are queued and run
+ *  in the next slot of the port in the device schedule, before its sample is
+ *  read.
+ */
+#ifndef SPS30_DAEMON_PROTOCOL_H
+#define SPS30_DAEMON_PROTOCOL_H
+
+#include "sensirion_config.h"
+#include "sps30_sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPS30_DAEMON_SOCKET_PATH "/tmp/sps30_daemon.sock"
+
+/** Port of SPS30_DAEMON_SUBSCRIBE and _UNSUBSCRIBE for all ports */
+#define SPS30_DAEMON_ALL_PORTS 0xffff
+
+typedef enum {
+    SPS30_DAEMON_SUBSCRIBE = 1,  //< stream the samples of the port
+    SPS30_DAEMON_UNSUBSCRIBE,    //< stop the stream of the port
+    SPS30_DAEMON_LATEST,         //< reply with the latest sample
+    SPS30_DAEMON_FAN_CLEANING,   //< sps30_start_fan_cleaning()
+    SPS30_DAEMON_READ_STATUS,    //< sps30_read_device_status_register()
+} sps30_daemon_command;
+
+typedef enum {
+    SPS30_DAEMON_REPLY = 1,  //< result of a request
+    SPS30_DAEMON_SAMPLE,     //< sample of a subscribed port
+} sps30_daemon_message_type;
+
+struct sps30_daemon_request {
+    uint16_t command;   //< sps30_daemon_command
+    uint16_t port;      //< UART port index of the daemon
+    uint32_t argument;  //< 1 to clear the register with _READ_STATUS
+    uint32_t tag;       //< chosen by the client, returned in the reply
+};
+
+struct sps30_daemon_message {
+    uint16_t type;               //< sps30_daemon_message_type
+    uint16_t port;               //< port of the request or sample
+    uint16_t command;            //< command of the request replied to
+    int16_t error;               //< NO_ERROR or error code of the command
+    uint32_t tag;                //< tag of the request replied to
+    uint32_t value;              //< device status register of _READ_STATUS
+    struct sps30_sample sample;  //< sample of _SAMPLE and _LATEST
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_DAEMON_PROTOCOL_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_recorder_file.c
+ */
+
+/* Enable clock_gettime function */
+#define _DEFAULT_SOURCE
+
+#include "sensirion_shdlc_recorder_file.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc_recorder.h"
+#include <stdio.h>
+#include <time.h>
+
+#if SENSIRION_SHDLC_FLIGHT_RECORDER
+
+int16_t sensirion_shdlc_recorder_write_file(uint16_t port, const char* path) {
+    struct sensirion_shdlc_recorder_entry
+        entries[SENSIRION_SHDLC_RECORDER_DEPTH];
+    struct sensirion_shdlc_recorder_file_header header;
+    char tmp_path[FILENAME_MAX];
+    FILE* file;
+    int written;
+
+    sensirion_common_copy_bytes(
+        (const uint8_t*)SENSIRION_SHDLC_RECORDER_FILE_MAGIC,
+        (uint8_t*)header.magic, sizeof(header.magic));
+    header.version = SENSIRION_SHDLC_RECORDER_FILE_VERSION;
+    header.port = port;
+    header.entry_size = sizeof(entries[0]);
+    header.frame_size = SENSIRION_SHDLC_RECORDER_FRAME_SIZE;
+    header.count = sensirion_shdlc_recorder_snapshot(
+        port, entries, SENSIRION_SHDLC_RECORDER_DEPTH);
+
+    written = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    if (written < 0 || (size_t)written >= sizeof(tmp_path)) {
+        return -1;
+    }
+    file = fopen(tmp_path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(entries, sizeof(entries[0]), header.count, file) !=
+            header.count) {
+        fclose(file);
+        remove(tmp_path);
+        return -1;
+    }
+    if (fclose(file) != 0 || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return -1;
+    }
+    return NO_ERROR;
+}
+
+void sensirion_shdlc_recorder_dump_to_directory(uint16_t port,
+                                                void* directory) {
+    char path[FILENAME_MAX];
+    struct timespec now;
+    int written;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    written = snprintf(path, sizeof(path), "%s/shdlc-port%u-%lld.%06ld.rec",
+                       (const char*)directory, port, (long long)now.tv_sec,
+                       now.tv_nsec / 1000);
+    if (written < 0 || (size_t)written >= sizeof(path)) {
+        return;
+    }
+    sensirion_shdlc_recorder_write_file(port, path);
+}
+
+#endif /* SENSIRION_SHDLC_FLIGHT_RECORDER */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_recorder_file.h
+ *
+ *  Writes the flight recorder of sensirion_shdlc_recorder.h to files. A dump
+ *  file starts with struct sensirion_shdlc_recorder_file_header followed by
+ *  the entries, oldest first, all in host byte order.
+ */
+#ifndef SENSIRION_SHDLC_RECORDER_FILE_H
+#define SENSIRION_SHDLC_RECORDER_FILE_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SENSIRION_SHDLC_RECORDER_FILE_MAGIC "SHFR"
+#define SENSIRION_SHDLC_RECORDER_FILE_VERSION 1
+
+struct sensirion_shdlc_recorder_file_header {
+    char magic[4];        //< SENSIRION_SHDLC_RECORDER_FILE_MAGIC
+    uint16_t version;     //< SENSIRION_SHDLC_RECORDER_FILE_VERSION
+    uint16_t port;        //< UART port index the entries belong to
+    uint16_t entry_size;  //< size of struct sensirion_shdlc_recorder_entry
+    uint16_t frame_size;  //< SENSIRION_SHDLC_RECORDER_FRAME_SIZE
+    uint32_t count;       //< number of entries following the header
+};
+
+/**
+ * sensirion_shdlc_recorder_write_file() - Write the recorded transactions of
+ *                                         a port to a file.
+ *
+ * The file is written next to path and renamed when complete, so readers
+ * never see a partial dump.
+ *
+ * @param port UART port index, see sensirion_uart_hal_select_port()
+ * @param path File to create or replace
+ *
+ * @return NO_ERROR on success, -1 if the file could not be written
+ */
+int16_t sensirion_shdlc_recorder_write_file(uint16_t port, const char* path);
+
+/**
+ * sensirion_shdlc_recorder_dump_to_directory() - Dump callback writing a new
+ *                                                file per dump.
+ *
+ * Register it with sensirion_shdlc_recorder_set_dump_callback() and a
+ * directory path as user data. Files are named
+ * shdlc-port<port>-<seconds>.<microseconds>.rec after the wall clock time.
+ *
+ * @param port      UART port index
+ * @param directory Directory path as const char*
+ */
+void sensirion_shdlc_recorder_dump_to_directory(uint16_t port,
+                                                void* directory);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SENSIRION_SHDLC_RECORDER_FILE_H
@@ -36,17 +36,61 @@
 #include "sensirion_common.h"
 #include "sensirion_config.h"
 #include <fcntl.h>
+#include <poll.h>
 #include <stdio.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
 
 /* Adapted from
  * http://www.raspberry-projects.com/pi/programming-in-c/uart-serial-port/using-the-uart
  */
 
-static int uart_fd = -1;
+/*
+ * Set to 1 to wait for response data with poll(2) instead of letting the
+ * SHDLC layer sleep between non-blocking reads.
+ */
+#ifndef SENSIRION_UART_HAL_POLL
+#define SENSIRION_UART_HAL_POLL 0
+#endif
+
+/* file descriptors of all ports, -1 if closed */
+static int uart_fds[SENSIRION_UART_MAX_PORTS];
+static bool uart_fds_initialized = false;
+static uint16_t uart_port = 0;
+
+static void sensirion_uart_hal_init_fds(void) {
+    uint16_t i;
+
+    if (uart_fds_initialized)
+        return;
+    for (i = 0; i < SENSIRION_UART_MAX_PORTS; i++)
+        uart_fds[i] = -1;
+    uart_fds_initialized = true;
+}
+
+int16_t sensirion_uart_hal_select_port(uint16_t port) {
+    if (port >= SENSIRION_UART_MAX_PORTS)
+        return -1;
+
+    sensirion_uart_hal_init_fds();
+    uart_port = port;
+    return 0;
+}
+
+uint16_t sensirion_uart_hal_get_selected_port(void) {
+    return uart_port;
+}
 
 int16_t sensirion_uart_hal_init(UartDescr port) {
+    int fd;
+
+    sensirion_uart_hal_init_fds();
+    if (uart_fds[uart_port] != -1) {
+        close(uart_fds[uart_port]);
+        uart_fds[uart_port] = -1;
+    }
+
     /*
      * The flags (defined in fcntl.h):
      * Access modes (use 1 of these):
@@ -62,8 +106,8 @@ int16_t sensirion_uart_hal_init(UartDescr port) {
      *      shall not cause the terminal device to become the controlling
      *      terminal for the process.
      */
-    uart_fd = open(port, O_RDWR | O_NOCTTY);
-    if (uart_fd == -1) {
+    fd = open(port, O_RDWR | O_NOCTTY);
+    if (fd == -1) {
         fprintf(stderr, "Error opening UART. Ensure it's not otherwise used\n");
         return -1;
     }
@@ -81,33 +125,74 @@ int16_t sensirion_uart_hal_init(UartDescr port) {
      *    PARODD - Odd parity (else even)
      */
     struct termios options;
-    tcgetattr(uart_fd, &options);
+    tcgetattr(fd, &options);
     options.c_cflag = B115200 | CS8 | CLOCAL | CREAD; /* set baud rate */
     options.c_iflag = IGNPAR;
     options.c_oflag = 0;
     options.c_lflag = 0;
-    tcflush(uart_fd, TCIFLUSH);
-    tcsetattr(uart_fd, TCSANOW, &options);
+    /* non-blocking reads: the SHDLC layer polls against its own deadline */
+    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = 0;
+    tcflush(fd, TCIFLUSH);
+    tcsetattr(fd, TCSANOW, &options);
+    uart_fds[uart_port] = fd;
     return 0;
 }
 
 int16_t sensirion_uart_hal_free() {
-    return close(uart_fd);
+    int16_t ret;
+
+    if (!uart_fds_initialized || uart_fds[uart_port] == -1)
+        return -1;
+
+    ret = close(uart_fds[uart_port]);
+    uart_fds[uart_port] = -1;
+    return ret;
 }
 
 int16_t sensirion_uart_hal_tx(uint16_t data_len, const uint8_t* data) {
-    if (uart_fd == -1)
+    if (!uart_fds_initialized || uart_fds[uart_port] == -1)
         return -1;
 
-    return write(uart_fd, (void*)data, data_len);
+    return write(uart_fds[uart_port], (void*)data, data_len);
 }
 
 int16_t sensirion_uart_hal_rx(uint16_t max_data_len, uint8_t* data) {
-    if (uart_fd == -1)
+    if (!uart_fds_initialized || uart_fds[uart_port] == -1)
+        return -1;
+
+    return read(uart_fds[uart_port], (void*)data, max_data_len);
+}
+
+int16_t sensirion_uart_hal_wait_rx_usec(uint32_t timeout_us) {
+#if SENSIRION_UART_HAL_POLL
+    struct pollfd pfd;
+    int ret;
+
+    if (!uart_fds_initialized || uart_fds[uart_port] == -1)
         return -1;
 
-    return read(uart_fd, (void*)data, max_data_len);
+    pfd.fd = uart_fds[uart_port];
+    pfd.events = POLLIN;
+    /* round up, poll(2) takes milliseconds */
+    ret = poll(&pfd, 1, (int)((timeout_us + 999) / 1000));
+    if (ret < 0)
+        return -1;
+    return ret > 0 ? 1 : 0;
+#else
+    (void)timeout_us;
+    return NOT_IMPLEMENTED_ERROR;
+#endif
 }
+
 void sensirion_uart_hal_sleep_usec(uint32_t useconds) {
     usleep(useconds);
 }
+
+uint64_t sensirion_uart_hal_get_time_usec(void) {
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        return 0;
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_uart_hotplug.c
+ */
+
+/* Enable strnlen function */
+#define _DEFAULT_SOURCE
+
+#include "sensirion_uart_hotplug.h"
+#include "sensirion_common.h"
+#include "sensirion_uart_hal.h"
+#include <errno.h>
+#include <glob.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* udev creates a node, then sets its permissions and adds the links */
+#define SENSIRION_UART_HOTPLUG_EVENTS                                          \
+    (IN_CREATE | IN_DELETE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO)
+
+struct sensirion_uart_hotplug_port {
+    bool watched;
+    bool connected;
+    dev_t device;  //< device number and inode of the open node, a new node
+    ino_t inode;   //< under the same path is a reconnected adapter
+    char path[SENSIRION_UART_HOTPLUG_PATH_SIZE];
+};
+
+static struct sensirion_uart_hotplug_port
+    hotplug_ports[SENSIRION_UART_MAX_PORTS];
+static int hotplug_fd = -1;
+static sensirion_uart_hotplug_callback hotplug_callback;
+static void* hotplug_user_data;
+
+int16_t sensirion_uart_hotplug_open(void) {
+    if (hotplug_fd != -1) {
+        return NO_ERROR;
+    }
+    hotplug_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    return hotplug_fd == -1 ? -1 : NO_ERROR;
+}
+
+void sensirion_uart_hotplug_close(void) {
+    uint16_t i;
+
+    for (i = 0; i < SENSIRION_UART_MAX_PORTS; i++) {
+        hotplug_ports[i].watched = false;
+    }
+    if (hotplug_fd != -1) {
+        close(hotplug_fd);
+        hotplug_fd = -1;
+    }
+}
+
+/*
+ * Watch the directory of the path, or its closest existing ancestor when the
+ * directory is created on demand like /dev/serial/by-id.
+ */
+static void
+sensirion_uart_hotplug_add_watch(const struct sensirion_uart_hotplug_port* p) {
+    char dir[SENSIRION_UART_HOTPLUG_PATH_SIZE];
+    char* slash;
+
+    if (hotplug_fd == -1) {
+        return;
+    }
+    sensirion_common_copy_bytes((const uint8_t*)p->path, (uint8_t*)dir,
+                                sizeof(dir));
+    while ((slash = strrchr(dir, '/')) != NULL) {
+        if (slash == dir) {
+            slash[1] = '\0';
+        } else {
+            slash[0] = '\0';
+        }
+        if (inotify_add_watch(hotplug_fd, dir, SENSIRION_UART_HOTPLUG_EVENTS) !=
+                -1 ||
+            errno != ENOENT || slash == dir) {
+            return;
+        }
+    }
+    /* a relative path without directory */
+    inotify_add_watch(hotplug_fd, ".", SENSIRION_UART_HOTPLUG_EVENTS);
+}
+
+static void sensirion_uart_hotplug_notify(uint16_t port, bool connected) {
+    if (hotplug_callback != NULL) {
+        hotplug_callback(port, connected, hotplug_user_data);
+    }
+}
+
+/* close a vanished or replaced device and open the present one */
+static int16_t sensirion_uart_hotplug_check(uint16_t port) {
+    struct sensirion_uart_hotplug_port* p = &hotplug_ports[port];
+    struct stat node;
+    bool present = stat(p->path, &node) == 0;
+    int16_t changes = 0;
+
+    if (p->connected && present && node.st_rdev == p->device &&
+        node.st_ino == p->inode) {
+        return 0;
+    }
+    if (p->connected) {
+        sensirion_uart_hal_select_port(port);
+        sensirion_uart_hal_free();
+        p->connected = false;
+        sensirion_uart_hotplug_notify(port, false);
+        changes++;
+    }
+    if (!present) {
+        return changes;
+    }
+    sensirion_uart_hal_select_port(port);
+    if (sensirion_uart_hal_init(p->path) != NO_ERROR) {
+        /* e.g. the permissions are not set yet, retried on the next event */
+        return changes;
+    }
+    p->device = node.st_rdev;
+    p->inode = node.st_ino;
+    p->connected = true;
+    sensirion_uart_hotplug_notify(port, true);
+    return (int16_t)(changes + 1);
+}
+
+int16_t sensirion_uart_hotplug_watch(uint16_t port, UartDescr path) {
+    struct sensirion_uart_hotplug_port* p;
+    uint16_t selected = sensirion_uart_hal_get_selected_port();
+    size_t len;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return -1;
+    }
+    p = &hotplug_ports[port];
+    len = strnlen(path, sizeof(p->path));
+    if (len == sizeof(p->path)) {
+        return -1;
+    }
+    sensirion_common_copy_bytes((const uint8_t*)path, (uint8_t*)p->path,
+                                (uint16_t)(len + 1));
+    p->watched = true;
+    p->connected = false;
+    sensirion_uart_hotplug_add_watch(p);
+    sensirion_uart_hotplug_check(port);
+    sensirion_uart_hal_select_port(selected);
+    return p->connected ? NO_ERROR : 1;
+}
+
+void sensirion_uart_hotplug_unwatch(uint16_t port) {
+    if (port < SENSIRION_UART_MAX_PORTS) {
+        hotplug_ports[port].watched = false;
+    }
+}
+
+void sensirion_uart_hotplug_set_callback(
+    sensirion_uart_hotplug_callback callback, void* user_data) {
+    hotplug_callback = callback;
+    hotplug_user_data = user_data;
+}
+
+int sensirion_uart_hotplug_get_fd(void) {
+    return hotplug_fd;
+}
+
+bool sensirion_uart_hotplug_is_connected(uint16_t port) {
+    return port < SENSIRION_UART_MAX_PORTS && hotplug_ports[port].watched &&
+           hotplug_ports[port].connected;
+}
+
+int16_t sensirion_uart_hotplug_process(uint32_t timeout_ms) {
+    union {
+        struct inotify_event event;
+        char bytes[4096];
+    } buffer;
+    uint16_t selected = sensirion_uart_hal_get_selected_port();
+    struct pollfd pfd;
+    int16_t changes = 0;
+    uint16_t i;
+    int ret;
+
+    if (hotplug_fd == -1) {
+        return -1;
+    }
+    pfd.fd = hotplug_fd;
+    pfd.events = POLLIN;
+    ret = poll(&pfd, 1, (int)timeout_ms);
+    if (ret < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    if (ret == 0) {
+        return 0;
+    }
+    /* any change in a watched directory rescans all ports */
+    while (read(hotplug_fd, &buffer, sizeof(buffer)) > 0) {
+    }
+    for (i = 0; i < SENSIRION_UART_MAX_PORTS; i++) {
+        if (!hotplug_ports[i].watched) {
+            continue;
+        }
+        /* directories created on demand get their own watch */
+        sensirion_uart_hotplug_add_watch(&hotplug_ports[i]);
+        changes = (int16_t)(changes + sensirion_uart_hotplug_check(i));
+    }
+    sensirion_uart_hal_select_port(selected);
+    return changes;
+}
+
+/* copy a path unless it is too long or the list is full */
+static uint16_t sensirion_uart_hotplug_add_path(
+    char paths[][SENSIRION_UART_HOTPLUG_PATH_SIZE], uint16_t count,
+    uint16_t max_paths, const char* path) {
+    size_t len = strnlen(path, SENSIRION_UART_HOTPLUG_PATH_SIZE);
+
+    if (count == max_paths || len == SENSIRION_UART_HOTPLUG_PATH_SIZE) {
+        return count;
+    }
+    sensirion_common_copy_bytes((const uint8_t*)path, (uint8_t*)paths[count],
+                                (uint16_t)(len + 1));
+    return (uint16_t)(count + 1);
+}
+
+uint16_t sensirion_uart_hotplug_enumerate(
+    char paths[][SENSIRION_UART_HOTPLUG_PATH_SIZE], uint16_t max_paths) {
+    struct stat node;
+    dev_t* linked_devices;
+    glob_t links;
+    glob_t nodes;
+    uint16_t count = 0;
+    size_t i;
+    size_t j;
+    bool linked;
+
+    if (glob("/dev/serial/by-id/*", 0, NULL, &links) != 0) {
+        links.gl_pathc = 0;
+    }
+    /* the devices the links point to, 0 for a dangling link */
+    linked_devices = (dev_t*)calloc(links.gl_pathc + 1, sizeof(dev_t));
+    for (i = 0; i < links.gl_pathc; i++) {
+        count = sensirion_uart_hotplug_add_path(paths, count, max_paths,
+                                                links.gl_pathv[i]);
+        if (linked_devices != NULL && stat(links.gl_pathv[i], &node) == 0) {
+            linked_devices[i] = node.st_rdev;
+        }
+    }
+    if (glob("/dev/ttyUSB*", 0, NULL, &nodes) != 0) {
+        nodes.gl_pathc = 0;
+    }
+    glob("/dev/ttyACM*", nodes.gl_pathc > 0 ? GLOB_APPEND : 0, NULL, &nodes);
+    for (i = 0; i < nodes.gl_pathc; i++) {
+        linked = false;
+        if (linked_devices != NULL && stat(nodes.gl_pathv[i], &node) == 0) {
+            for (j = 0; j < links.gl_pathc && !linked; j++) {
+                linked = linked_devices[j] == node.st_rdev;
+            }
+        }
+        if (!linked) {
+            count = sensirion_uart_hotplug_add_path(paths, count, max_paths,
+                                                    nodes.gl_pathv[i]);
+        }
+    }
+    free(linked_devices);
+    globfree(&links);
+    globfree(&nodes);
+    return count;
+}
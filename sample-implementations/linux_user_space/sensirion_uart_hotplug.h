@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_uart_hotplug.h
+ *
+ *  Hot-plug aware port management for USB-serial adapters. A watched port
+ *  remembers the device path it was opened with, e.g. /dev/ttyUSB0 or a link
+ *  in /dev/serial/by-id. The directories of the paths are watched with
+ *  inotify, and sensirion_uart_hotplug_process() closes a port whose device
+ *  disappeared and reopens it through sensirion_uart_hal_init() as soon as a
+ *  device appears under its path again.
+ *
+ *  The port index stays the same across a reconnect, so everything kept per
+ *  port, like counters, latency histograms, timeout estimates, retry policy
+ *  and the health watchdog of sps30_health.h, is preserved.
+ *
+ *  All functions must be called from the thread performing the transactions,
+ *  since reopening selects the port in the UART HAL.
+ */
+#ifndef SENSIRION_UART_HOTPLUG_H
+#define SENSIRION_UART_HOTPLUG_H
+
+#include "sensirion_config.h"
+#include "sensirion_uart_portdescriptor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Capacity of the device path of a port, including the terminating 0 */
+#ifndef SENSIRION_UART_HOTPLUG_PATH_SIZE
+#define SENSIRION_UART_HOTPLUG_PATH_SIZE 128
+#endif
+
+/**
+ * Called after a watched port was closed because its device disappeared
+ * (connected false) or reopened after it appeared again (connected true).
+ */
+typedef void (*sensirion_uart_hotplug_callback)(uint16_t port, bool connected,
+                                                void* user_data);
+
+/**
+ * sensirion_uart_hotplug_open() - Create the inotify instance of the port
+ *                                 manager.
+ *
+ * @return NO_ERROR on success, -1 if inotify is not available
+ */
+int16_t sensirion_uart_hotplug_open(void);
+
+/**
+ * sensirion_uart_hotplug_close() - Stop watching all ports. The ports stay
+ *                                  open.
+ */
+void sensirion_uart_hotplug_close(void);
+
+/**
+ * sensirion_uart_hotplug_watch() - Open a port and reopen it whenever its
+ *                                  device reappears.
+ *
+ * This replaces sensirion_uart_hal_select_port() and sensirion_uart_hal_init()
+ * for the port. A device which is not present yet is opened when it appears.
+ * The selected port of the UART HAL is not changed.
+ *
+ * @param port UART port index
+ * @param path Device path, copied
+ *
+ * @return NO_ERROR if the port was opened, 1 if it is watched but the device
+ *         is absent, -1 for an invalid port or a path which is too long
+ */
+int16_t sensirion_uart_hotplug_watch(uint16_t port, UartDescr path);
+
+/**
+ * sensirion_uart_hotplug_unwatch() - Stop watching a port. The port stays
+ *                                    open.
+ *
+ * @param port UART port index
+ */
+void sensirion_uart_hotplug_unwatch(uint16_t port);
+
+/**
+ * sensirion_uart_hotplug_set_callback() - Register a function notified of
+ *                                         every disconnect and reconnect.
+ *
+ * @param callback  Function to call, NULL to remove it
+ * @param user_data Passed to the callback
+ */
+void sensirion_uart_hotplug_set_callback(
+    sensirion_uart_hotplug_callback callback, void* user_data);
+
+/**
+ * sensirion_uart_hotplug_get_fd() - File descriptor which becomes readable
+ *                                   when device nodes change, to wait on it
+ *                                   together with other descriptors.
+ *
+ * @return inotify file descriptor, -1 if the port manager is not open
+ */
+int sensirion_uart_hotplug_get_fd(void);
+
+/**
+ * sensirion_uart_hotplug_is_connected() - Check whether the device of a
+ *                                         watched port is open.
+ *
+ * @param port UART port index
+ */
+bool sensirion_uart_hotplug_is_connected(uint16_t port);
+
+/**
+ * sensirion_uart_hotplug_process() - Wait for changes of device nodes and
+ *                                    close or reopen the affected ports.
+ *
+ * Call it in the acquisition loop instead of sleeping between measurements,
+ * so that a device is reopened within milliseconds after it reappeared.
+ *
+ * @param timeout_ms Maximum time to wait for a change, 0 to only check
+ *
+ * @return Number of ports closed or reopened, -1 on error
+ */
+int16_t sensirion_uart_hotplug_process(uint32_t timeout_ms);
+
+/**
+ * sensirion_uart_hotplug_enumerate() - List the USB-serial adapters present,
+ *                                      e.g. as candidates for
+ *                                      sps30_discovery_scan().
+ *
+ * The stable links in /dev/serial/by-id are listed first, followed by the
+ * /dev/ttyUSB* and /dev/ttyACM* nodes which none of these links points to.
+ *
+ * @param paths     Memory where the device paths are stored
+ * @param max_paths Capacity of paths
+ *
+ * @return Number of paths stored
+ */
+uint16_t sensirion_uart_hotplug_enumerate(
+    char paths[][SENSIRION_UART_HOTPLUG_PATH_SIZE], uint16_t max_paths);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SENSIRION_UART_HOTPLUG_H
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_latest_shm.c
+ */
+
+/* Enable shm_open and ftruncate functions */
+#define _DEFAULT_SOURCE
+
+#include "sps30_latest_shm.h"
+#include "sensirion_common.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int16_t sps30_latest_shm_create(const char* name,
+                                struct sps30_latest_table** table) {
+    void* memory;
+    int fd;
+
+    fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)sizeof(**table)) != 0) {
+        close(fd);
+        return -1;
+    }
+    memory = mmap(NULL, sizeof(**table), PROT_READ | PROT_WRITE, MAP_SHARED,
+                  fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return -1;
+    }
+    *table = (struct sps30_latest_table*)memory;
+    sps30_latest_init(*table);
+    return NO_ERROR;
+}
+
+int16_t sps30_latest_shm_open(const char* name,
+                              const struct sps30_latest_table** table) {
+    struct stat st;
+    void* memory;
+    int fd;
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(**table)) {
+        close(fd);
+        return -1;
+    }
+    memory = mmap(NULL, sizeof(**table), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return -1;
+    }
+    *table = (const struct sps30_latest_table*)memory;
+    if (sps30_latest_check(*table) != NO_ERROR) {
+        sps30_latest_shm_close(*table);
+        return -1;
+    }
+    return NO_ERROR;
+}
+
+void sps30_latest_shm_close(const struct sps30_latest_table* table) {
+    munmap((void*)table, sizeof(*table));
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_latest_shm.h
+ *
+ *  Places the latest-value table of sps30_latest.h in POSIX shared memory.
+ *  The process owning the serial ports creates the table and publishes to
+ *  it, any number of other processes map it read-only and call
+ *  sps30_latest_read() on it.
+ *
+ *  Readers must be built with the same SENSIRION_UART_MAX_PORTS as the
+ *  writer, sps30_latest_shm_open() rejects a table with another layout.
+ */
+#ifndef SPS30_LATEST_SHM_H
+#define SPS30_LATEST_SHM_H
+
+#include "sensirion_config.h"
+#include "sps30_latest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * sps30_latest_shm_create() - Create or take over a shared memory table and
+ *                             set it up empty.
+ *
+ * Readers which mapped the table of an earlier writer keep reading the same
+ * memory, so they need not reopen it when the writer restarts.
+ *
+ * @param name  Name of the shared memory object, e.g. "/sps30", see
+ *              shm_open(3)
+ * @param table Set to the mapped table, which is not yet published to, see
+ *              sps30_latest_publish_to()
+ *
+ * @return NO_ERROR on success, -1 if the table could not be created
+ */
+int16_t sps30_latest_shm_create(const char* name,
+                                struct sps30_latest_table** table);
+
+/**
+ * sps30_latest_shm_open() - Map an existing table read-only.
+ *
+ * @param name  Name of the shared memory object
+ * @param table Set to the mapped table
+ *
+ * @return NO_ERROR on success, -1 if the table does not exist, is too small
+ *         or has another layout
+ */
+int16_t sps30_latest_shm_open(const char* name,
+                              const struct sps30_latest_table** table);
+
+/**
+ * sps30_latest_shm_close() - Unmap a table of sps30_latest_shm_create() or
+ *                            sps30_latest_shm_open().
+ *
+ * The shared memory object remains until it is removed with shm_unlink(3).
+ *
+ * @param table Mapped table
+ */
+void sps30_latest_shm_close(const struct sps30_latest_table* table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_LATEST_SHM_H
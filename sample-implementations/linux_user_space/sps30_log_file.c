@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_log_file.c
+ */
+
+/* Enable ftruncate and fdatasync functions */
+#define _DEFAULT_SOURCE
+
+#include "sps30_log_file.h"
+#include "sensirion_common.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int16_t sps30_log_file_write(int fd, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    ssize_t written;
+
+    while (size > 0) {
+        written = write(fd, bytes, size);
+        if (written <= 0) {
+            return -1;
+        }
+        bytes += written;
+        size -= (size_t)written;
+    }
+    return NO_ERROR;
+}
+
+static int16_t sps30_log_file_create(struct sps30_log_file* file,
+                                     const struct sps30_log_header* header) {
+    if (ftruncate(file->fd, 0) != 0 ||
+        sps30_log_file_write(file->fd, header, sizeof(*header)) != NO_ERROR ||
+        fdatasync(file->fd) != 0) {
+        return -1;
+    }
+    file->size = sizeof(*header);
+    return NO_ERROR;
+}
+
+/* find the end of the valid records and the state to append against */
+static int16_t sps30_log_file_recover(struct sps30_log_file* file,
+                                      const struct sps30_log_header* header,
+                                      size_t size) {
+    struct sps30_log_reader reader;
+    struct sps30_log_record record;
+    void* memory;
+
+    memory = mmap(NULL, size, PROT_READ, MAP_SHARED, file->fd, 0);
+    if (memory == MAP_FAILED) {
+        return -1;
+    }
+    if (sps30_log_reader_init(&reader, (const uint8_t*)memory, size) !=
+            NO_ERROR ||
+        memcmp(&reader.header, header, sizeof(*header)) != 0) {
+        munmap(memory, size);
+        return -1;
+    }
+    /* stops at the end or at the first damaged record */
+    while (sps30_log_reader_next(&reader, &record) == NO_ERROR) {
+    }
+    munmap(memory, size);
+    file->codec = reader.codec;
+    file->size = reader.offset;
+    if (reader.offset < size &&
+        ftruncate(file->fd, (off_t)reader.offset) != 0) {
+        return -1;
+    }
+    return NO_ERROR;
+}
+
+int16_t sps30_log_file_open(struct sps30_log_file* file, const char* path,
+                            const struct sps30_log_header* header) {
+    struct stat st;
+    int16_t error;
+
+    file->fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (file->fd < 0) {
+        return -1;
+    }
+    sps30_log_codec_init(&file->codec, (sps30_log_format)header->format);
+    if (fstat(file->fd, &st) != 0) {
+        error = -1;
+    } else if ((size_t)st.st_size < sizeof(*header)) {
+        /* new, or the header itself was cut short */
+        error = sps30_log_file_create(file, header);
+    } else {
+        error = sps30_log_file_recover(file, header, (size_t)st.st_size);
+    }
+    if (error != NO_ERROR) {
+        close(file->fd);
+        file->fd = -1;
+    }
+    return error;
+}
+
+int16_t sps30_log_file_append(struct sps30_log_file* file,
+                              const struct sps30_log_record* record) {
+    struct sps30_log_codec codec = file->codec;
+    uint8_t buffer[SPS30_LOG_MAX_RECORD_SIZE];
+    uint8_t size;
+
+    size = sps30_log_encode(&codec, record, buffer);
+    if (sps30_log_file_write(file->fd, buffer, size) != NO_ERROR) {
+        /* drop a partial record, the next one is encoded as if it was not */
+        (void)ftruncate(file->fd, (off_t)file->size);
+        return -1;
+    }
+    file->codec = codec;
+    file->size += size;
+    return NO_ERROR;
+}
+
+int16_t sps30_log_file_sync(struct sps30_log_file* file) {
+    return fdatasync(file->fd) == 0 ? NO_ERROR : -1;
+}
+
+void sps30_log_file_close(struct sps30_log_file* file) {
+    (void)fdatasync(file->fd);
+    close(file->fd);
+    file->fd = -1;
+}
+
+int16_t sps30_log_file_map(const char* path, struct sps30_log_reader* reader) {
+    struct stat st;
+    void* memory;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return -1;
+    }
+    memory = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return -1;
+    }
+    if (sps30_log_reader_init(reader, (const uint8_t*)memory,
+                              (size_t)st.st_size) != NO_ERROR) {
+        munmap(memory, (size_t)st.st_size);
+        return -1;
+    }
+    return NO_ERROR;
+}
+
+void sps30_log_file_unmap(struct sps30_log_reader* reader) {
+    munmap((void*)reader->data, reader->size);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_log_file.h
+ *
+ *  Append-only files in the log format of sps30_log.h, one file per sensor.
+ *
+ *  Records are appended with a single write(2) each. A crash can leave the
+ *  last record incomplete, or zeroed space at the end of the file. Opening
+ *  the file for writing again reads all records, which also restores the
+ *  state the next record is encoded against, and cuts the file after the
+ *  last valid record. How much is lost in a power failure is up to the
+ *  application, see sps30_log_file_sync().
+ *
+ *  Readers map a file and stream through its records with
+ *  sps30_log_reader_next(), also while it is being written.
+ */
+#ifndef SPS30_LOG_FILE_H
+#define SPS30_LOG_FILE_H
+
+#include "sensirion_config.h"
+#include "sps30_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the members are private, use the functions below */
+struct sps30_log_file {
+    int fd;
+    uint64_t size;  //< end of the last complete record
+    struct sps30_log_codec codec;
+};
+
+/**
+ * sps30_log_file_open() - Open a log file for appending, creating it with
+ *                         the given header if it does not exist.
+ *
+ * @param file   File to open
+ * @param path   Path of the log file
+ * @param header Header of the log, an existing file must have the same
+ *               header, e.g. a replaced sensor needs a new file
+ *
+ * @return NO_ERROR on success, -1 if the file could not be opened or created,
+ *         or has another header
+ */
+int16_t sps30_log_file_open(struct sps30_log_file* file, const char* path,
+                            const struct sps30_log_header* header);
+
+/**
+ * sps30_log_file_append() - Append a record.
+ *
+ * @param file   Open file
+ * @param record Record to append
+ *
+ * @return NO_ERROR on success, -1 if the record could not be written. The
+ *         file still ends with the previous record then.
+ */
+int16_t sps30_log_file_append(struct sps30_log_file* file,
+                              const struct sps30_log_record* record);
+
+/**
+ * sps30_log_file_sync() - Make the appended records durable.
+ *
+ * Calling it after every record costs a flash write per sample, calling it
+ * every few minutes bounds the samples lost in a power failure.
+ *
+ * @param file Open file
+ *
+ * @return NO_ERROR on success, -1 on failure
+ */
+int16_t sps30_log_file_sync(struct sps30_log_file* file);
+
+/**
+ * sps30_log_file_close() - Sync and close a log file.
+ *
+ * @param file Open file
+ */
+void sps30_log_file_close(struct sps30_log_file* file);
+
+/**
+ * sps30_log_file_map() - Map a log file read-only and set up a reader.
+ *
+ * Records appended after the call are not seen, map the file again to
+ * follow it.
+ *
+ * @param path   Path of the log file
+ * @param reader Reader to set up
+ *
+ * @return NO_ERROR on success, -1 if the file could not be mapped or is not
+ *         a log
+ */
+int16_t sps30_log_file_map(const char* path, struct sps30_log_reader* reader);
+
+/**
+ * sps30_log_file_unmap() - Unmap the file of a reader.
+ *
+ * @param reader Reader set up by sps30_log_file_map()
+ */
+void sps30_log_file_unmap(struct sps30_log_reader* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_LOG_FILE_H
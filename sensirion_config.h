@@ -65,6 +65,95 @@
  * typedef unsigned char uint8_t;
  */
 
+/**
+ * Set to 1 to record per-command latency histograms of all SHDLC transactions,
+ * see sensirion_shdlc_latency.h. The histograms use about 1.1 kB of RAM per
+ * tracked command, 18 kB per port with the default of 16 commands, see
+ * SENSIRION_SHDLC_LATENCY_MAX_COMMANDS. When set to 0 the instrumentation is
+ * compiled out completely.
+ */
+#ifndef SENSIRION_SHDLC_LATENCY_HISTOGRAMS
+#define SENSIRION_SHDLC_LATENCY_HISTOGRAMS 0
+#endif
+
+/**
+ * Set to 1 to count the outcome of all SHDLC transactions per port, command
+ * and error code, see sensirion_shdlc_counters.h. The counters use about
+ * 1.1 kB of RAM per port. When set to 0 they are compiled out completely.
+ */
+#ifndef SENSIRION_SHDLC_COUNTERS
+#define SENSIRION_SHDLC_COUNTERS 0
+#endif
+
+/**
+ * Set to 1 to keep the last transactions of every port with their raw wire
+ * bytes in a flight recorder, see sensirion_shdlc_recorder.h. With the
+ * default depth the recorder uses about 1.7 kB of RAM per port. It is fed by
+ * the frame trace, which is enabled along with it.
+ */
+#ifndef SENSIRION_SHDLC_FLIGHT_RECORDER
+#define SENSIRION_SHDLC_FLIGHT_RECORDER 0
+#endif
+
+/**
+ * Set to 1 to be able to trace every SHDLC frame with its raw wire bytes, see
+ * sensirion_shdlc_trace.h. The capture buffer uses about 0.5 kB of RAM. When
+ * set to 0 the hook is compiled out completely.
+ */
+#ifndef SENSIRION_SHDLC_TRACE
+#define SENSIRION_SHDLC_TRACE SENSIRION_SHDLC_FLIGHT_RECORDER
+#endif
+#if SENSIRION_SHDLC_FLIGHT_RECORDER && !SENSIRION_SHDLC_TRACE
+#error "SENSIRION_SHDLC_FLIGHT_RECORDER requires SENSIRION_SHDLC_TRACE"
+#endif
+
+/**
+ * Set to 1 to derive response deadlines from the measured round-trip times of
+ * every port and command, see sensirion_shdlc_timeout.h. The estimates use
+ * about 0.4 kB of RAM per port. When set to 0 every response waits for the
+ * full timeout of its command.
+ */
+#ifndef SENSIRION_SHDLC_ADAPTIVE_TIMEOUT
+#define SENSIRION_SHDLC_ADAPTIVE_TIMEOUT 0
+#endif
+
+/**
+ * Full memory barrier for the lock-free statistics. On single core systems
+ * without preemption between the driver and the readers of the statistics it
+ * can be defined empty.
+ */
+#ifndef SENSIRION_MEMORY_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define SENSIRION_MEMORY_BARRIER() __sync_synchronize()
+#else
+#define SENSIRION_MEMORY_BARRIER()
+#endif
+#endif
+
+/**
+ * Size of a cache line. The lock-free sample ring of sps30_ring.h keeps the
+ * indices written by its producer and its consumer this far apart, so the two
+ * threads do not invalidate each other's cache line on every record.
+ */
+#ifndef SENSIRION_CACHE_LINE_SIZE
+#define SENSIRION_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * Aligns a type to SENSIRION_CACHE_LINE_SIZE, so that its padding separates
+ * the cache lines. Compilers without an alignment attribute may leave it
+ * empty, the ring then keeps the indices apart but may share a line with its
+ * neighbours.
+ */
+#ifndef SENSIRION_CACHE_ALIGNED
+#if defined(__GNUC__) || defined(__clang__)
+#define SENSIRION_CACHE_ALIGNED \
+    __attribute__((aligned(SENSIRION_CACHE_LINE_SIZE)))
+#else
+#define SENSIRION_CACHE_ALIGNED
+#endif
+#endif
+
 #ifndef __cplusplus
 
 /**
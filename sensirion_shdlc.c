@@ -32,19 +32,29 @@
 #include "sensirion_shdlc.h"
 #include "sensirion_common.h"
 #include "sensirion_config.h"
+#include "sensirion_shdlc_counters.h"
+#include "sensirion_shdlc_latency.h"
+#include "sensirion_shdlc_trace.h"
 #include "sensirion_uart_hal.h"
 
 #define SHDLC_START 0x7e
 #define SHDLC_STOP 0x7e
 
 #define SHDLC_MIN_TX_FRAME_SIZE 6
+/** address, command, state and data length */
+#define SHDLC_MISO_HEADER_SIZE 4
 /** start/stop + (4 header + 255 data) * 2 because of byte stuffing */
 #define SHDLC_FRAME_MAX_TX_FRAME_SIZE (2 + (4 + 255) * 2)
 
 /** start/stop + (5 header + 255 data) * 2 because of byte stuffing */
 #define SHDLC_FRAME_MAX_RX_FRAME_SIZE (2 + (5 + 255) * 2)
 
-#define RX_DELAY_US 20000
+/** response deadline of the frame based functions */
+#define SHDLC_RX_TIMEOUT_US 50000
+#define SHDLC_POLL_INTERVAL_US 1000
+
+/** bytes discarded per HAL call while draining */
+#define SHDLC_DRAIN_CHUNK_SIZE 16
 
 static uint8_t sensirion_shdlc_checksum(uint8_t header_sum, uint8_t data_len,
                                         const uint8_t* data) {
@@ -101,24 +111,103 @@ static uint8_t sensirion_shdlc_unstuff_byte(uint8_t data) {
     }
 }
 
+#if SENSIRION_SHDLC_COUNTERS || SENSIRION_SHDLC_TRACE
+int16_t sensirion_shdlc_hal_tx(uint16_t data_len, const uint8_t* data) {
+    int16_t ret = sensirion_uart_hal_tx(data_len, data);
+
+    sensirion_shdlc_counters_count_tx(ret, data);
+    sensirion_shdlc_trace_capture(ret, data);
+    return ret;
+}
+
+int16_t sensirion_shdlc_hal_rx(uint16_t max_data_len, uint8_t* data) {
+    int16_t ret = sensirion_uart_hal_rx(max_data_len, data);
+
+    sensirion_shdlc_counters_count_rx(ret, data);
+    sensirion_shdlc_trace_capture(ret, data);
+    return ret;
+}
+#endif
+
+static int16_t sensirion_shdlc_transmit(uint16_t len, const uint8_t* frame) {
+    int16_t ret;
+
+    sensirion_shdlc_trace_begin();
+    ret = sensirion_shdlc_hal_tx(len, frame);
+    if (ret >= 0) {
+        ret = ret == len ? NO_ERROR : SENSIRION_SHDLC_ERR_TX_INCOMPLETE;
+    }
+    sensirion_shdlc_trace_end(SENSIRION_SHDLC_TRACE_TX, ret);
+    return ret;
+}
+
+uint16_t sensirion_shdlc_drain_rx(void) {
+    uint8_t buffer[SHDLC_DRAIN_CHUNK_SIZE];
+    uint16_t discarded = 0;
+    int16_t ret;
+
+    /* a short read means nothing more is pending */
+    do {
+        /* only read what is pending, in case the HAL blocks in rx */
+        if (sensirion_uart_hal_wait_rx_usec(0) == 0) {
+            break;
+        }
+        ret = sensirion_shdlc_hal_rx(sizeof(buffer), buffer);
+        if (ret > 0) {
+            discarded = (uint16_t)(discarded + ret);
+        }
+    } while (ret == SHDLC_DRAIN_CHUNK_SIZE);
+    if (discarded > 0) {
+        sensirion_shdlc_counters_count_discarded(discarded);
+    }
+    return discarded;
+}
+
 int16_t sensirion_shdlc_xcv(uint8_t addr, uint8_t cmd, uint8_t tx_data_len,
                             const uint8_t* tx_data, uint8_t max_rx_data_len,
                             struct sensirion_shdlc_rx_header* rx_header,
                             uint8_t* rx_data) {
     int16_t ret;
+#if SENSIRION_SHDLC_LATENCY_HISTOGRAMS
+    uint64_t tx_start_us = sensirion_uart_hal_get_time_usec();
+#endif
+    uint64_t tx_timestamp_us;
 
+    sensirion_shdlc_drain_rx();
     ret = sensirion_shdlc_tx(addr, cmd, tx_data_len, tx_data);
-    if (ret != 0)
+    if (ret != 0) {
+        sensirion_shdlc_counters_record(cmd, ret, false, 0);
         return ret;
+    }
+    tx_timestamp_us = sensirion_uart_hal_get_time_usec();
+
+    ret = sensirion_shdlc_rx(max_rx_data_len, rx_header, rx_data);
+    rx_header->tx_timestamp_us = tx_timestamp_us;
+    if ((ret == NO_ERROR || ret == SENSIRION_SHDLC_ERR_EXECUTION_FAILURE) &&
+        (rx_header->addr != addr || rx_header->cmd != cmd)) {
+        ret = SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH;
+    }
 
-    sensirion_uart_hal_sleep_usec(RX_DELAY_US);
-    return sensirion_shdlc_rx(max_rx_data_len, rx_header, rx_data);
+    sensirion_shdlc_latency_record(cmd, SENSIRION_SHDLC_LATENCY_TX, tx_start_us,
+                                   tx_timestamp_us);
+    if (rx_header->rx_timestamp_us != 0) {
+        sensirion_shdlc_latency_record(cmd, SENSIRION_SHDLC_LATENCY_WAIT,
+                                       tx_timestamp_us,
+                                       rx_header->rx_timestamp_us);
+        sensirion_shdlc_latency_record(cmd, SENSIRION_SHDLC_LATENCY_RX,
+                                       rx_header->rx_timestamp_us,
+                                       sensirion_uart_hal_get_time_usec());
+    }
+    sensirion_shdlc_counters_record(cmd, ret,
+                                    ret == SENSIRION_SHDLC_ERR_MISSING_START &&
+                                        rx_header->rx_timestamp_us == 0,
+                                    0);
+    return ret;
 }
 
 int16_t sensirion_shdlc_tx(uint8_t addr, uint8_t cmd, uint8_t data_len,
                            const uint8_t* data) {
     uint16_t len = 0;
-    int16_t ret;
     uint8_t crc;
     uint8_t tx_frame_buf[SHDLC_FRAME_MAX_TX_FRAME_SIZE];
 
@@ -132,30 +221,80 @@ int16_t sensirion_shdlc_tx(uint8_t addr, uint8_t cmd, uint8_t data_len,
     len += sensirion_shdlc_stuff_data(1, &crc, tx_frame_buf + len);
     tx_frame_buf[len++] = SHDLC_STOP;
 
-    ret = sensirion_uart_hal_tx(len, tx_frame_buf);
-    if (ret < 0)
-        return ret;
-    if (ret != len)
-        return SENSIRION_SHDLC_ERR_TX_INCOMPLETE;
-    return 0;
+    return sensirion_shdlc_transmit(len, tx_frame_buf);
 }
 
-int16_t sensirion_shdlc_rx(uint8_t max_data_len,
-                           struct sensirion_shdlc_rx_header* rxh,
-                           uint8_t* data) {
+/*
+ * Read a frame up to its stop byte, polling until the response deadline. The
+ * time the first byte arrived is stored in first_byte_us, 0 if none did.
+ * Returns the number of bytes read or a negative error code of the HAL.
+ */
+static int16_t sensirion_shdlc_read_frame(uint16_t max_len, uint8_t* frame,
+                                          uint64_t* first_byte_us) {
+    uint64_t start_us = sensirion_uart_hal_get_time_usec();
+    uint32_t polls_left = SHDLC_RX_TIMEOUT_US / SHDLC_POLL_INTERVAL_US;
+    uint64_t elapsed_us;
+    uint16_t len = 0;
+    int16_t ret;
+
+    *first_byte_us = 0;
+    while (len < max_len) {
+        ret = sensirion_shdlc_hal_rx((uint16_t)(max_len - len), &frame[len]);
+        if (ret < 0) {
+            return len > 0 ? (int16_t)len : ret;
+        }
+        if (ret > 0) {
+            if (len == 0) {
+                *first_byte_us = sensirion_uart_hal_get_time_usec();
+            }
+            len = (uint16_t)(len + ret);
+            /* the decoder rejects a frame without start byte right away */
+            if (frame[0] != SHDLC_START ||
+                (len > 1 && frame[len - 1] == SHDLC_STOP)) {
+                break;
+            }
+            continue;
+        }
+        elapsed_us = sensirion_uart_hal_get_time_usec() - start_us;
+        if (polls_left == 0 || elapsed_us >= SHDLC_RX_TIMEOUT_US) {
+            break;
+        }
+        switch (sensirion_uart_hal_wait_rx_usec(
+            (uint32_t)(SHDLC_RX_TIMEOUT_US - elapsed_us))) {
+            case 1:
+                /* data arrived, waiting does not use up a poll */
+                break;
+            case 0:
+                polls_left--;
+                break;
+            default:
+                polls_left--;
+                sensirion_uart_hal_sleep_usec(SHDLC_POLL_INTERVAL_US);
+                break;
+        }
+    }
+    return (int16_t)len;
+}
+
+static int16_t sensirion_shdlc_receive(uint8_t max_data_len,
+                                       struct sensirion_shdlc_rx_header* rxh,
+                                       uint8_t* data) {
     int16_t len;
     uint16_t i;
     uint8_t rx_frame[SHDLC_FRAME_MAX_RX_FRAME_SIZE];
-    uint8_t* rx_header = (uint8_t*)rxh;
+    uint8_t rx_header[SHDLC_MISO_HEADER_SIZE];
     uint8_t j;
     uint8_t crc;
     uint8_t unstuff_next;
 
-    len = sensirion_uart_hal_rx(2 + (5 + (uint16_t)max_data_len) * 2, rx_frame);
+    len = sensirion_shdlc_read_frame(2 + (5 + (uint16_t)max_data_len) * 2,
+                                     rx_frame, &rxh->rx_timestamp_us);
+    rxh->tx_timestamp_us = 0;
     if (len < 1 || rx_frame[0] != SHDLC_START)
         return SENSIRION_SHDLC_ERR_MISSING_START;
 
-    for (unstuff_next = 0, i = 1, j = 0; j < sizeof(*rxh) && i < len - 2; ++i) {
+    for (unstuff_next = 0, i = 1, j = 0; j < sizeof(rx_header) && i < len - 2;
+         ++i) {
         if (unstuff_next) {
             rx_header[j++] = sensirion_shdlc_unstuff_byte(rx_frame[i]);
             unstuff_next = 0;
@@ -165,9 +304,14 @@ int16_t sensirion_shdlc_rx(uint8_t max_data_len,
                 rx_header[j++] = rx_frame[i];
         }
     }
-    if (j != sizeof(*rxh) || unstuff_next)
+    if (j != sizeof(rx_header) || unstuff_next)
         return SENSIRION_SHDLC_ERR_ENCODING_ERROR;
 
+    rxh->addr = rx_header[0];
+    rxh->cmd = rx_header[1];
+    rxh->state = rx_header[2];
+    rxh->data_len = rx_header[3];
+
     if (max_data_len < rxh->data_len)
         return SENSIRION_SHDLC_ERR_FRAME_TOO_LONG; /* more data than expected */
 
@@ -206,6 +350,17 @@ int16_t sensirion_shdlc_rx(uint8_t max_data_len,
     return 0;
 }
 
+int16_t sensirion_shdlc_rx(uint8_t max_data_len,
+                           struct sensirion_shdlc_rx_header* rxh,
+                           uint8_t* data) {
+    int16_t ret;
+
+    sensirion_shdlc_trace_begin();
+    ret = sensirion_shdlc_receive(max_data_len, rxh, data);
+    sensirion_shdlc_trace_end(SENSIRION_SHDLC_TRACE_RX, ret);
+    return ret;
+}
+
 static void sensirion_shdlc_stuff_byte(struct sensirion_shdlc_buffer* tx_frame,
                                        uint8_t data) {
     switch (data) {
@@ -309,16 +464,7 @@ void sensirion_shdlc_finish_frame(struct sensirion_shdlc_buffer* tx_frame) {
 
 int16_t sensirion_shdlc_tx_frame(struct sensirion_shdlc_buffer* tx_frame) {
 
-    int16_t tx_length;
-
-    tx_length = sensirion_uart_hal_tx(tx_frame->offset, tx_frame->data);
-    if (tx_length < 0) {
-        return tx_length;
-    }
-    if (tx_length != tx_frame->offset) {
-        return SENSIRION_SHDLC_ERR_TX_INCOMPLETE;
-    }
-    return NO_ERROR;
+    return sensirion_shdlc_transmit(tx_frame->offset, tx_frame->data);
 }
 
 static uint8_t
@@ -334,16 +480,19 @@ sensirion_shdlc_unstuff_next_byte(struct sensirion_shdlc_buffer* rx_frame) {
     return data;
 }
 
-int16_t sensirion_shdlc_rx_inplace(struct sensirion_shdlc_buffer* rx_frame,
-                                   uint8_t expected_data_length,
-                                   struct sensirion_shdlc_rx_header* header) {
+static int16_t
+sensirion_shdlc_receive_inplace(struct sensirion_shdlc_buffer* rx_frame,
+                                uint8_t expected_data_length,
+                                struct sensirion_shdlc_rx_header* header) {
     int16_t rx_length;
     uint16_t i;
     rx_frame->offset = 0;
     rx_frame->checksum = 0;
 
-    rx_length = sensirion_uart_hal_rx(
-        2 + (5 + (uint16_t)expected_data_length) * 2, rx_frame->data);
+    rx_length = sensirion_shdlc_read_frame(
+        2 + (5 + (uint16_t)expected_data_length) * 2, rx_frame->data,
+        &header->rx_timestamp_us);
+    header->tx_timestamp_us = 0;
     if (rx_length < 1 || rx_frame->data[rx_frame->offset++] != SHDLC_START) {
         return SENSIRION_SHDLC_ERR_MISSING_START;
     }
@@ -384,3 +533,15 @@ int16_t sensirion_shdlc_rx_inplace(struct sensirion_shdlc_buffer* rx_frame,
 
     return NO_ERROR;
 }
+
+int16_t sensirion_shdlc_rx_inplace(struct sensirion_shdlc_buffer* rx_frame,
+                                   uint8_t expected_data_length,
+                                   struct sensirion_shdlc_rx_header* header) {
+    int16_t ret;
+
+    sensirion_shdlc_trace_begin();
+    ret = sensirion_shdlc_receive_inplace(rx_frame, expected_data_length,
+                                          header);
+    sensirion_shdlc_trace_end(SENSIRION_SHDLC_TRACE_RX, ret);
+    return ret;
+}
@@ -33,6 +33,7 @@
 #define SENSIRION_SHDLC_H
 
 #include "sensirion_config.h"
+#include "sensirion_uart_hal.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +47,9 @@ extern "C" {
 #define SENSIRION_SHDLC_ERR_TX_INCOMPLETE -6
 #define SENSIRION_SHDLC_ERR_FRAME_TOO_LONG -7
 #define SENSIRION_SHDLC_ERR_EXECUTION_FAILURE -8
+#define SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH -9
+#define SENSIRION_SHDLC_ERR_NOT_SUPPORTED -10
+#define SENSIRION_SHDLC_ERR_INVALID_ARGUMENT -11
 
 struct sensirion_shdlc_buffer {
     uint8_t* data;
@@ -58,6 +62,10 @@ struct sensirion_shdlc_rx_header {
     uint8_t cmd;
     uint8_t state;
     uint8_t data_len;
+    uint64_t tx_timestamp_us;  //< monotonic time the request was sent, 0 if
+                               //< unknown
+    uint64_t rx_timestamp_us;  //< monotonic time the first byte of the
+                               //< response was received, 0 if none was
 };
 
 /**
@@ -75,7 +83,8 @@ int16_t sensirion_shdlc_tx(uint8_t addr, uint8_t cmd, uint8_t data_len,
 /**
  * sensirion_shdlc_rx() - receive an SHDLC frame
  *
- * Note that the header and data must be discarded on failure
+ * Waits up to 50 ms for the frame to arrive up to its stop byte. Note that
+ * the header and data must be discarded on failure
  *
  * @data_len:   max data length to receive
  * @header:     Memory where the SHDLC header containing the sender address,
@@ -87,10 +96,26 @@ int16_t sensirion_shdlc_rx(uint8_t max_data_len,
                            struct sensirion_shdlc_rx_header* header,
                            uint8_t* data);
 
+/**
+ * sensirion_shdlc_drain_rx() - discard all bytes received so far without
+ *                              waiting, e.g. the late response of a
+ *                              transaction that timed out
+ *
+ * This is called before every request. HALs which implement
+ * sensirion_uart_hal_wait_rx_usec() are only read while it reports pending
+ * data, the others must return from sensirion_uart_hal_rx() without waiting.
+ *
+ * Return:      Number of discarded bytes
+ */
+uint16_t sensirion_shdlc_drain_rx(void);
+
 /**
  * sensirion_shdlc_xcv() - transceive (transmit then receive) an SHDLC frame
  *
- * Note that rx_header and rx_data must be discarded on failure
+ * Note that rx_header and rx_data must be discarded on failure. The response
+ * is read as soon as it arrives, within 50 ms. A response whose address or
+ * command differs from the request is rejected with
+ * SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH.
  *
  * @addr:           recipient address
  * @cmd:            parameter
@@ -251,6 +276,8 @@ int16_t sensirion_shdlc_tx_frame(struct sensirion_shdlc_buffer* tx_frame);
 /**
  * sensirion_shdlc_rx_inplace() - Receive an SHDLC frame in a prepared buffer.
  *
+ * Waits up to 50 ms for the frame to arrive up to its stop byte.
+ *
  * @note The header and data must be discarded on failure
  *
  * @param rx_frame             Pointer to buffer in which the RX frame will be
@@ -272,6 +299,39 @@ int16_t sensirion_shdlc_rx_inplace(struct sensirion_shdlc_buffer* rx_frame,
                                    uint8_t expected_data_length,
                                    struct sensirion_shdlc_rx_header* header);
 
+#if SENSIRION_SHDLC_COUNTERS || SENSIRION_SHDLC_TRACE
+/**
+ * sensirion_shdlc_hal_tx() - Call sensirion_uart_hal_tx() and pass the
+ *                            transmitted bytes to the instrumentation.
+ *
+ * The SHDLC layer transmits only through this function. Without the
+ * counters and the frame trace it is sensirion_uart_hal_tx() itself.
+ *
+ * @param data_len Number of bytes to send
+ * @param data     Data to send
+ *
+ * @return Number of bytes sent or a negative error code
+ */
+int16_t sensirion_shdlc_hal_tx(uint16_t data_len, const uint8_t* data);
+
+/**
+ * sensirion_shdlc_hal_rx() - Call sensirion_uart_hal_rx() and pass the
+ *                            received bytes to the instrumentation.
+ *
+ * The SHDLC layer receives only through this function.
+ *
+ * @param max_data_len Maximum number of bytes to receive
+ * @param data         Memory where received data is stored
+ *
+ * @return Number of bytes received or a negative error code
+ */
+int16_t sensirion_shdlc_hal_rx(uint16_t max_data_len, uint8_t* data);
+#else
+/* nothing to instrument, the SHDLC layer calls the UART HAL directly */
+#define sensirion_shdlc_hal_tx sensirion_uart_hal_tx
+#define sensirion_shdlc_hal_rx sensirion_uart_hal_rx
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_counters.c
+ */
+#include "sensirion_shdlc_counters.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+
+uint8_t sensirion_shdlc_counters_outcome_index(int16_t error) {
+    if (error > 0 || error <= -SENSIRION_SHDLC_COUNTERS_OTHER_ERROR) {
+        return SENSIRION_SHDLC_COUNTERS_OTHER_ERROR;
+    }
+    return (uint8_t)-error;
+}
+
+#if SENSIRION_SHDLC_COUNTERS
+
+/* every escape byte on the wire was inserted by byte stuffing */
+#define SHDLC_STUFF_BYTE 0x7d
+
+/*
+ * The sequence number is odd while the writer updates the counters. Readers
+ * retry until they copied the counters between two identical even sequence
+ * numbers.
+ */
+struct sensirion_shdlc_counters_entry {
+    volatile uint32_t sequence;
+    struct sensirion_shdlc_counters counters;
+};
+
+static struct sensirion_shdlc_counters_entry
+    counters_table[SENSIRION_UART_MAX_PORTS];
+
+static void
+sensirion_shdlc_counters_begin_write(struct sensirion_shdlc_counters_entry* e) {
+    e->sequence++;
+    SENSIRION_MEMORY_BARRIER();
+}
+
+static void
+sensirion_shdlc_counters_end_write(struct sensirion_shdlc_counters_entry* e) {
+    SENSIRION_MEMORY_BARRIER();
+    e->sequence++;
+}
+
+/*
+ * Find the counters of a command, adding them if the command is new. Must be
+ * called between begin_write and end_write. Returns NULL if the table is full.
+ */
+static volatile struct sensirion_shdlc_command_counters*
+sensirion_shdlc_counters_slot(
+    volatile struct sensirion_shdlc_counters* counters, uint8_t command) {
+    volatile struct sensirion_shdlc_command_counters* slot;
+    uint8_t i;
+
+    for (i = 0; i < counters->num_commands; i++) {
+        if (counters->commands[i].command == command) {
+            return &counters->commands[i];
+        }
+    }
+    if (counters->num_commands >= SENSIRION_SHDLC_COUNTERS_MAX_COMMANDS) {
+        return NULL;
+    }
+    slot = &counters->commands[counters->num_commands];
+    slot->command = command;
+    counters->num_commands++;
+    return slot;
+}
+
+void sensirion_shdlc_counters_record(uint8_t command, int16_t error,
+                                     bool timed_out, uint16_t discarded_bytes) {
+    struct sensirion_shdlc_counters_entry* entry =
+        &counters_table[sensirion_uart_hal_get_selected_port()];
+    volatile struct sensirion_shdlc_counters* counters = &entry->counters;
+    volatile struct sensirion_shdlc_command_counters* slot;
+
+    sensirion_shdlc_counters_begin_write(entry);
+    slot = sensirion_shdlc_counters_slot(counters, command);
+    if (slot != NULL) {
+        slot->outcomes[sensirion_shdlc_counters_outcome_index(error)]++;
+        if (timed_out) {
+            slot->timeouts++;
+        }
+    }
+    counters->discarded_bytes += discarded_bytes;
+    sensirion_shdlc_counters_end_write(entry);
+}
+
+void sensirion_shdlc_counters_count_discarded(uint16_t discarded_bytes) {
+    struct sensirion_shdlc_counters_entry* entry =
+        &counters_table[sensirion_uart_hal_get_selected_port()];
+
+    sensirion_shdlc_counters_begin_write(entry);
+    entry->counters.discarded_bytes += discarded_bytes;
+    sensirion_shdlc_counters_end_write(entry);
+}
+
+void sensirion_shdlc_counters_count_retry(uint8_t command) {
+    struct sensirion_shdlc_counters_entry* entry =
+        &counters_table[sensirion_uart_hal_get_selected_port()];
+    volatile struct sensirion_shdlc_command_counters* slot;
+
+    sensirion_shdlc_counters_begin_write(entry);
+    slot = sensirion_shdlc_counters_slot(&entry->counters, command);
+    if (slot != NULL) {
+        slot->retries++;
+    }
+    sensirion_shdlc_counters_end_write(entry);
+}
+
+void sensirion_shdlc_counters_count_exhausted(uint8_t command) {
+    struct sensirion_shdlc_counters_entry* entry =
+        &counters_table[sensirion_uart_hal_get_selected_port()];
+    volatile struct sensirion_shdlc_command_counters* slot;
+
+    sensirion_shdlc_counters_begin_write(entry);
+    slot = sensirion_shdlc_counters_slot(&entry->counters, command);
+    if (slot != NULL) {
+        slot->retries_exhausted++;
+    }
+    sensirion_shdlc_counters_end_write(entry);
+}
+
+static uint32_t sensirion_shdlc_counters_escapes(uint16_t data_len,
+                                                 const uint8_t* data) {
+    uint32_t escapes = 0;
+    uint16_t i;
+
+    for (i = 0; i < data_len; i++) {
+        escapes += data[i] == SHDLC_STUFF_BYTE;
+    }
+    return escapes;
+}
+
+void sensirion_shdlc_counters_count_tx(int16_t ret, const uint8_t* data) {
+    struct sensirion_shdlc_counters_entry* entry =
+        &counters_table[sensirion_uart_hal_get_selected_port()];
+    volatile struct sensirion_shdlc_io_counters* io = &entry->counters.io;
+
+    sensirion_shdlc_counters_begin_write(entry);
+    io->tx_calls++;
+    if (ret < 0) {
+        io->hal_errors++;
+    } else {
+        io->tx_bytes += (uint32_t)ret;
+        io->tx_escapes += sensirion_shdlc_counters_escapes((uint16_t)ret, data);
+    }
+    sensirion_shdlc_counters_end_write(entry);
+}
+
+void sensirion_shdlc_counters_count_rx(int16_t ret, const uint8_t* data) {
+    struct sensirion_shdlc_counters_entry* entry =
+        &counters_table[sensirion_uart_hal_get_selected_port()];
+    volatile struct sensirion_shdlc_io_counters* io = &entry->counters.io;
+
+    sensirion_shdlc_counters_begin_write(entry);
+    io->rx_calls++;
+    if (ret < 0) {
+        io->hal_errors++;
+    } else if (ret == 0) {
+        io->rx_empty++;
+    } else {
+        io->rx_bytes += (uint32_t)ret;
+        io->rx_escapes += sensirion_shdlc_counters_escapes((uint16_t)ret, data);
+    }
+    sensirion_shdlc_counters_end_write(entry);
+}
+
+int16_t sensirion_shdlc_counters_snapshot(
+    uint16_t port, struct sensirion_shdlc_counters* snapshot) {
+    struct sensirion_shdlc_counters_entry* entry;
+    const volatile uint8_t* source;
+    uint8_t* destination = (uint8_t*)snapshot;
+    uint32_t sequence;
+    size_t i;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    entry = &counters_table[port];
+    source = (const volatile uint8_t*)&entry->counters;
+    do {
+        sequence = entry->sequence;
+        SENSIRION_MEMORY_BARRIER();
+        for (i = 0; i < sizeof(*snapshot); i++) {
+            destination[i] = source[i];
+        }
+        SENSIRION_MEMORY_BARRIER();
+    } while ((sequence & 1) || sequence != entry->sequence);
+    return NO_ERROR;
+}
+
+void sensirion_shdlc_counters_reset(uint16_t port) {
+    struct sensirion_shdlc_counters_entry* entry;
+    volatile uint8_t* counters;
+    size_t i;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    entry = &counters_table[port];
+    counters = (volatile uint8_t*)&entry->counters;
+    sensirion_shdlc_counters_begin_write(entry);
+    for (i = 0; i < sizeof(entry->counters); i++) {
+        counters[i] = 0;
+    }
+    sensirion_shdlc_counters_end_write(entry);
+}
+
+#else
+
+/* applications reading the counters still link without them */
+int16_t sensirion_shdlc_counters_snapshot(
+    uint16_t port, struct sensirion_shdlc_counters* snapshot) {
+    (void)port;
+    (void)snapshot;
+    return NOT_IMPLEMENTED_ERROR;
+}
+
+void sensirion_shdlc_counters_reset(uint16_t port) {
+    (void)port;
+}
+
+#endif /* SENSIRION_SHDLC_COUNTERS */
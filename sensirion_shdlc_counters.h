@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_counters.h
+ *
+ *  Per-port counters of SHDLC transaction outcomes. For every port the
+ *  result of each transaction is tallied per command ID and per
+ *  SENSIRION_SHDLC_ERR_* code, together with the number of timeouts, the
+ *  repetitions sent by the retry policy of sensirion_shdlc_retry.h and the
+ *  number of received bytes that had to be discarded. Additionally all UART
+ *  HAL calls, the transferred bytes and the byte stuffing overhead are
+ *  counted.
+ *
+ *  The counters of a port are written only by the thread performing its
+ *  transactions and are protected by a sequence counter, so recording never
+ *  blocks and any thread can take a consistent snapshot with
+ *  sensirion_shdlc_counters_snapshot().
+ *
+ *  The counters are only compiled in if SENSIRION_SHDLC_COUNTERS is set in
+ *  sensirion_config.h. Without them, taking a snapshot reports
+ *  NOT_IMPLEMENTED_ERROR.
+ */
+#ifndef SENSIRION_SHDLC_COUNTERS_H
+#define SENSIRION_SHDLC_COUNTERS_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of distinct command IDs tracked per port */
+#ifndef SENSIRION_SHDLC_COUNTERS_MAX_COMMANDS
+#define SENSIRION_SHDLC_COUNTERS_MAX_COMMANDS 16
+#endif
+
+/**
+ * Outcome slots: NO_ERROR, SENSIRION_SHDLC_ERR_NO_DATA (-1) down to
+ * SENSIRION_SHDLC_ERR_INVALID_ARGUMENT (-11) and a last slot for all other
+ * error codes, e.g. those of the UART HAL.
+ */
+#define SENSIRION_SHDLC_COUNTERS_NUM_OUTCOMES 13
+#define SENSIRION_SHDLC_COUNTERS_OTHER_ERROR \
+    (SENSIRION_SHDLC_COUNTERS_NUM_OUTCOMES - 1)
+
+struct sensirion_shdlc_command_counters {
+    uint8_t command;  //< SHDLC command ID
+    /** transactions per result, see sensirion_shdlc_counters_outcome_index */
+    uint32_t outcomes[SENSIRION_SHDLC_COUNTERS_NUM_OUTCOMES];
+    uint32_t timeouts;  //< transactions which ran into the response deadline
+    uint32_t retries;   //< repetitions of a request after a failed attempt
+    /** transactions which still failed when the retry policy gave up */
+    uint32_t retries_exhausted;
+};
+
+/**
+ * Calls of the UART HAL made by the SHDLC layer. Byte counts include the byte
+ * stuffing, the escape bytes are counted separately so that the stuffing
+ * overhead on the wire can be told apart from the payload.
+ */
+struct sensirion_shdlc_io_counters {
+    uint32_t tx_calls;    //< calls of sensirion_uart_hal_tx()
+    uint32_t rx_calls;    //< calls of sensirion_uart_hal_rx()
+    uint32_t rx_empty;    //< rx calls which returned no data
+    uint32_t hal_errors;  //< tx or rx calls which returned an error
+    uint32_t tx_bytes;    //< bytes written
+    uint32_t rx_bytes;    //< bytes read
+    uint32_t tx_escapes;  //< escape bytes inserted by byte stuffing
+    uint32_t rx_escapes;  //< escape bytes removed by byte unstuffing
+};
+
+struct sensirion_shdlc_counters {
+    struct sensirion_shdlc_io_counters io;
+    uint32_t discarded_bytes;  //< received bytes which answered no request
+    uint8_t num_commands;      //< number of valid entries in commands
+    struct sensirion_shdlc_command_counters
+        commands[SENSIRION_SHDLC_COUNTERS_MAX_COMMANDS];
+};
+
+/**
+ * sensirion_shdlc_counters_outcome_index() - Map a transaction result to its
+ *                                            slot in the outcomes array.
+ *
+ * @param error NO_ERROR or an error code
+ *
+ * @return 0 for NO_ERROR, -error for SENSIRION_SHDLC_ERR_* codes and
+ *         SENSIRION_SHDLC_COUNTERS_OTHER_ERROR for anything else.
+ */
+uint8_t sensirion_shdlc_counters_outcome_index(int16_t error);
+
+#if SENSIRION_SHDLC_COUNTERS
+/**
+ * sensirion_shdlc_counters_record() - Count the outcome of a transaction on
+ *                                     the currently selected port.
+ *
+ * This is called by the SHDLC layer.
+ *
+ * @param command         SHDLC command ID of the transaction
+ * @param error           Result of the transaction
+ * @param timed_out       True if the response deadline passed
+ * @param discarded_bytes Number of received bytes which were dropped
+ */
+void sensirion_shdlc_counters_record(uint8_t command, int16_t error,
+                                     bool timed_out, uint16_t discarded_bytes);
+
+/**
+ * sensirion_shdlc_counters_count_discarded() - Count received bytes which
+ *                                              were dropped outside of a
+ *                                              transaction on the currently
+ *                                              selected port.
+ *
+ * This is called by the SHDLC layer when it drains stale input.
+ *
+ * @param discarded_bytes Number of dropped bytes
+ */
+void sensirion_shdlc_counters_count_discarded(uint16_t discarded_bytes);
+
+/**
+ * sensirion_shdlc_counters_count_retry() - Count a repetition of a request on
+ *                                          the currently selected port.
+ *
+ * This is called by the SHDLC layer before it sends the request again.
+ *
+ * @param command SHDLC command ID of the transaction
+ */
+void sensirion_shdlc_counters_count_retry(uint8_t command);
+
+/**
+ * sensirion_shdlc_counters_count_exhausted() - Count a transaction on the
+ *                                              currently selected port which
+ *                                              failed although its retry
+ *                                              policy allowed repetitions.
+ *
+ * This is called by the SHDLC layer when the attempts or the time budget of
+ * the retry policy are used up.
+ *
+ * @param command SHDLC command ID of the transaction
+ */
+void sensirion_shdlc_counters_count_exhausted(uint8_t command);
+
+/**
+ * sensirion_shdlc_counters_count_tx() - Count a call of sensirion_uart_hal_tx()
+ *                                       on the currently selected port.
+ *
+ * This is called by the SHDLC layer.
+ *
+ * @param ret  Return value of the HAL call
+ * @param data Data passed to the HAL call
+ */
+void sensirion_shdlc_counters_count_tx(int16_t ret, const uint8_t* data);
+
+/**
+ * sensirion_shdlc_counters_count_rx() - Count a call of sensirion_uart_hal_rx()
+ *                                       on the currently selected port.
+ *
+ * This is called by the SHDLC layer.
+ *
+ * @param ret  Return value of the HAL call
+ * @param data Data received by the HAL call
+ */
+void sensirion_shdlc_counters_count_rx(int16_t ret, const uint8_t* data);
+#else
+/* the SHDLC layer calls the hooks unconditionally, without evaluating */
+#define sensirion_shdlc_counters_record(command, error, timed_out, \
+                                        discarded_bytes)           \
+    ((void)0)
+#define sensirion_shdlc_counters_count_discarded(discarded_bytes) ((void)0)
+#define sensirion_shdlc_counters_count_retry(command) ((void)0)
+#define sensirion_shdlc_counters_count_exhausted(command) ((void)0)
+#define sensirion_shdlc_counters_count_tx(ret, data) ((void)0)
+#define sensirion_shdlc_counters_count_rx(ret, data) ((void)0)
+#endif
+
+/**
+ * sensirion_shdlc_counters_snapshot() - Take a consistent copy of the counters
+ *                                       of a port.
+ *
+ * Lock-free, may be called from any thread while transactions are running.
+ *
+ * @param port     UART port index, see sensirion_uart_hal_select_port()
+ * @param snapshot Memory where the copy is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port, NOT_IMPLEMENTED_ERROR without
+ *         SENSIRION_SHDLC_COUNTERS.
+ */
+int16_t sensirion_shdlc_counters_snapshot(
+    uint16_t port, struct sensirion_shdlc_counters* snapshot);
+
+/**
+ * sensirion_shdlc_counters_reset() - Clear the counters of a port.
+ *
+ * Must be called from the thread performing the transactions of that port.
+ *
+ * @param port UART port index
+ */
+void sensirion_shdlc_counters_reset(uint16_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SENSIRION_SHDLC_COUNTERS_H
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_latency.c
+ */
+#include "sensirion_shdlc_latency.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+
+#if SENSIRION_SHDLC_LATENCY_HISTOGRAMS
+
+struct sensirion_shdlc_latency_histogram {
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t buckets[SENSIRION_SHDLC_LATENCY_NUM_BUCKETS];
+};
+
+struct sensirion_shdlc_latency_command {
+    bool used;
+    uint8_t command;
+    struct sensirion_shdlc_latency_histogram
+        phases[SENSIRION_SHDLC_LATENCY_NUM_PHASES];
+};
+
+static struct sensirion_shdlc_latency_command
+    latency_table[SENSIRION_UART_MAX_PORTS]
+                 [SENSIRION_SHDLC_LATENCY_MAX_COMMANDS];
+
+/* samples of commands which found no free slot */
+static uint32_t latency_dropped[SENSIRION_UART_MAX_PORTS];
+
+static uint16_t sensirion_shdlc_latency_bucket(uint32_t value_us) {
+    uint32_t msb = 0;
+    uint32_t shift;
+    uint32_t sub;
+    uint32_t v = value_us;
+
+    if (value_us >= ((uint32_t)1 << SENSIRION_SHDLC_LATENCY_MAX_BITS)) {
+        return SENSIRION_SHDLC_LATENCY_NUM_BUCKETS - 1;
+    }
+    if (value_us < SENSIRION_SHDLC_LATENCY_SUB_BUCKETS) {
+        return (uint16_t)value_us;
+    }
+    while (v >>= 1) {
+        msb++;
+    }
+    shift = msb - SENSIRION_SHDLC_LATENCY_SUB_BUCKET_BITS;
+    sub = (value_us >> shift) & (SENSIRION_SHDLC_LATENCY_SUB_BUCKETS - 1);
+    return (uint16_t)((shift + 1) * SENSIRION_SHDLC_LATENCY_SUB_BUCKETS + sub);
+}
+
+/* largest value that falls into the given bucket */
+static uint32_t sensirion_shdlc_latency_bucket_limit(uint16_t bucket) {
+    uint32_t shift;
+    uint32_t sub;
+
+    if (bucket < SENSIRION_SHDLC_LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+    shift = (uint32_t)bucket / SENSIRION_SHDLC_LATENCY_SUB_BUCKETS - 1;
+    sub = (uint32_t)bucket % SENSIRION_SHDLC_LATENCY_SUB_BUCKETS;
+    return ((SENSIRION_SHDLC_LATENCY_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+static struct sensirion_shdlc_latency_command*
+sensirion_shdlc_latency_find(uint16_t port, uint8_t command, bool create) {
+    struct sensirion_shdlc_latency_command* slots = latency_table[port];
+    uint8_t i;
+
+    for (i = 0; i < SENSIRION_SHDLC_LATENCY_MAX_COMMANDS; i++) {
+        if (slots[i].used && slots[i].command == command) {
+            return &slots[i];
+        }
+        if (!slots[i].used) {
+            if (!create) {
+                return NULL;
+            }
+            slots[i].used = true;
+            slots[i].command = command;
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t sensirion_shdlc_latency_percentile(
+    const struct sensirion_shdlc_latency_histogram* histogram,
+    uint8_t percent) {
+    uint32_t rank = (uint32_t)(((uint64_t)histogram->count * percent + 99) /
+                               100);
+    uint32_t seen = 0;
+    uint32_t limit;
+    uint16_t i;
+
+    for (i = 0; i < SENSIRION_SHDLC_LATENCY_NUM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            limit = sensirion_shdlc_latency_bucket_limit(i);
+            return limit < histogram->max_us ? limit : histogram->max_us;
+        }
+    }
+    return histogram->max_us;
+}
+
+void sensirion_shdlc_latency_record(uint8_t command,
+                                    sensirion_shdlc_latency_phase phase,
+                                    uint64_t start_us, uint64_t end_us) {
+    struct sensirion_shdlc_latency_command* slot;
+    struct sensirion_shdlc_latency_histogram* histogram;
+    uint32_t duration_us;
+    uint16_t port;
+
+    if (phase >= SENSIRION_SHDLC_LATENCY_NUM_PHASES || end_us < start_us) {
+        return;
+    }
+    port = sensirion_uart_hal_get_selected_port();
+    slot = sensirion_shdlc_latency_find(port, command, true);
+    if (slot == NULL) {
+        latency_dropped[port]++;
+        return;
+    }
+    duration_us = end_us - start_us > UINT32_MAX
+                      ? UINT32_MAX
+                      : (uint32_t)(end_us - start_us);
+    histogram = &slot->phases[phase];
+    histogram->count++;
+    histogram->buckets[sensirion_shdlc_latency_bucket(duration_us)]++;
+    if (duration_us > histogram->max_us) {
+        histogram->max_us = duration_us;
+    }
+}
+
+int16_t sensirion_shdlc_latency_get_summary(
+    uint16_t port, uint8_t command, sensirion_shdlc_latency_phase phase,
+    struct sensirion_shdlc_latency_summary* summary) {
+    const struct sensirion_shdlc_latency_command* slot;
+    const struct sensirion_shdlc_latency_histogram* histogram;
+
+    if (port >= SENSIRION_UART_MAX_PORTS ||
+        phase >= SENSIRION_SHDLC_LATENCY_NUM_PHASES) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    slot = sensirion_shdlc_latency_find(port, command, false);
+    if (slot == NULL || slot->phases[phase].count == 0) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    histogram = &slot->phases[phase];
+    summary->count = histogram->count;
+    summary->p50_us = sensirion_shdlc_latency_percentile(histogram, 50);
+    summary->p90_us = sensirion_shdlc_latency_percentile(histogram, 90);
+    summary->p99_us = sensirion_shdlc_latency_percentile(histogram, 99);
+    summary->max_us = histogram->max_us;
+    return NO_ERROR;
+}
+
+uint32_t sensirion_shdlc_latency_get_dropped(uint16_t port) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return 0;
+    }
+    return latency_dropped[port];
+}
+
+void sensirion_shdlc_latency_reset(void) {
+    uint8_t* table = (uint8_t*)latency_table;
+    size_t i;
+
+    for (i = 0; i < sizeof(latency_table); i++) {
+        table[i] = 0;
+    }
+    for (i = 0; i < SENSIRION_UART_MAX_PORTS; i++) {
+        latency_dropped[i] = 0;
+    }
+}
+
+#else
+
+/* applications reading the histograms still link without them */
+int16_t sensirion_shdlc_latency_get_summary(
+    uint16_t port, uint8_t command, sensirion_shdlc_latency_phase phase,
+    struct sensirion_shdlc_latency_summary* summary) {
+    (void)port;
+    (void)command;
+    (void)phase;
+    (void)summary;
+    return NOT_IMPLEMENTED_ERROR;
+}
+
+uint32_t sensirion_shdlc_latency_get_dropped(uint16_t port) {
+    (void)port;
+    return 0;
+}
+
+void sensirion_shdlc_latency_reset(void) {
+}
+
+#endif /* SENSIRION_SHDLC_LATENCY_HISTOGRAMS */
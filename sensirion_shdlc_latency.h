@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_latency.h
+ *
+ *  Per-port, per-command latency histograms of SHDLC transactions. Each
+ *  transaction is split into three phases which are recorded separately:
+ *  transmitting the request, waiting for the first byte of the response and
+ *  receiving and decoding the rest of the response.
+ *
+ *  The histograms are log-linear: every power of two is split into
+ *  SENSIRION_SHDLC_LATENCY_SUB_BUCKETS linear buckets, which bounds the
+ *  relative error of a percentile to 25% while using a fixed amount of memory.
+ *  Latencies of 2^24 us (~16.8 s) and above end up in the last bucket.
+ *
+ *  The instrumentation is only compiled in if
+ *  SENSIRION_SHDLC_LATENCY_HISTOGRAMS is set in sensirion_config.h. Without
+ *  it, the functions reading the histograms report that nothing is recorded.
+ */
+#ifndef SENSIRION_SHDLC_LATENCY_H
+#define SENSIRION_SHDLC_LATENCY_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of distinct command IDs tracked per port. The SPS30 driver uses 12,
+ * samples of further commands are counted as dropped.
+ */
+#ifndef SENSIRION_SHDLC_LATENCY_MAX_COMMANDS
+#define SENSIRION_SHDLC_LATENCY_MAX_COMMANDS 16
+#endif
+
+#define SENSIRION_SHDLC_LATENCY_SUB_BUCKET_BITS 2
+#define SENSIRION_SHDLC_LATENCY_SUB_BUCKETS \
+    (1 << SENSIRION_SHDLC_LATENCY_SUB_BUCKET_BITS)
+#define SENSIRION_SHDLC_LATENCY_MAX_BITS 24
+#define SENSIRION_SHDLC_LATENCY_NUM_BUCKETS                    \
+    ((SENSIRION_SHDLC_LATENCY_MAX_BITS -                       \
+      SENSIRION_SHDLC_LATENCY_SUB_BUCKET_BITS + 1) *           \
+     SENSIRION_SHDLC_LATENCY_SUB_BUCKETS)
+
+typedef enum {
+    SENSIRION_SHDLC_LATENCY_TX = 0,  //< writing the request
+    SENSIRION_SHDLC_LATENCY_WAIT,    //< request sent until first response byte
+    SENSIRION_SHDLC_LATENCY_RX,      //< first byte until response is decoded
+    SENSIRION_SHDLC_LATENCY_NUM_PHASES,
+} sensirion_shdlc_latency_phase;
+
+struct sensirion_shdlc_latency_summary {
+    uint32_t count;   //< number of recorded transactions
+    uint32_t p50_us;  //< median
+    uint32_t p90_us;  //< 90th percentile
+    uint32_t p99_us;  //< 99th percentile
+    uint32_t max_us;  //< exact maximum
+};
+
+#if SENSIRION_SHDLC_LATENCY_HISTOGRAMS
+/**
+ * sensirion_shdlc_latency_record() - Add a sample to the histogram of the
+ *                                    currently selected port.
+ *
+ * This is called by the SHDLC layer, applications only need it to record
+ * phases of custom transports.
+ *
+ * @param command  SHDLC command ID of the transaction
+ * @param phase    Transaction phase the sample belongs to
+ * @param start_us Monotonic start time of the phase
+ * @param end_us   Monotonic end time of the phase
+ */
+void sensirion_shdlc_latency_record(uint8_t command,
+                                    sensirion_shdlc_latency_phase phase,
+                                    uint64_t start_us, uint64_t end_us);
+#else
+/* the SHDLC layer calls the hook unconditionally, without evaluating */
+#define sensirion_shdlc_latency_record(command, phase, start_us, end_us) \
+    ((void)0)
+#endif
+
+/**
+ * sensirion_shdlc_latency_get_summary() - Read percentiles of one histogram.
+ *
+ * Percentiles are reported as the upper bound of the bucket they fall into,
+ * but never larger than the maximum.
+ *
+ * @param port    UART port index, see sensirion_uart_hal_select_port()
+ * @param command SHDLC command ID, e.g. one of SPS30_CMD_ID
+ * @param phase   Transaction phase
+ * @param summary Memory where the summary is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port or phase, SENSIRION_SHDLC_ERR_NO_DATA if nothing was
+ *         recorded for this port and command, NOT_IMPLEMENTED_ERROR without
+ *         SENSIRION_SHDLC_LATENCY_HISTOGRAMS.
+ */
+int16_t sensirion_shdlc_latency_get_summary(
+    uint16_t port, uint8_t command, sensirion_shdlc_latency_phase phase,
+    struct sensirion_shdlc_latency_summary* summary);
+
+/**
+ * sensirion_shdlc_latency_get_dropped() - Count the samples of a port which
+ *                                         were not recorded because all
+ *                                         command slots were taken.
+ *
+ * @param port UART port index
+ *
+ * @return Number of dropped samples, 0 for an invalid port or without
+ *         SENSIRION_SHDLC_LATENCY_HISTOGRAMS
+ */
+uint32_t sensirion_shdlc_latency_get_dropped(uint16_t port);
+
+/**
+ * sensirion_shdlc_latency_reset() - Clear the histograms of all ports.
+ */
+void sensirion_shdlc_latency_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SENSIRION_SHDLC_LATENCY_H
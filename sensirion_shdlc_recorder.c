@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_recorder.c
+ */
+#include "sensirion_shdlc_recorder.h"
+#include "sensirion_common.h"
+#include "sensirion_uart_portdescriptor.h"
+
+#if SENSIRION_SHDLC_FLIGHT_RECORDER
+
+/*
+ * Single writer per port, readers use the same sequence lock as the
+ * counters: the sequence number is odd while the writer updates the ring.
+ */
+struct sensirion_shdlc_recorder_ring {
+    volatile uint32_t sequence;
+    uint16_t head;   //< slot of the next transaction
+    uint16_t count;  //< completed transactions in the ring
+    bool pending;    //< the slot at head holds a request without response
+    bool failing;    //< the last completed transaction failed
+    struct sensirion_shdlc_recorder_entry
+        entries[SENSIRION_SHDLC_RECORDER_DEPTH];
+};
+
+static struct sensirion_shdlc_recorder_ring
+    recorder_table[SENSIRION_UART_MAX_PORTS];
+
+static sensirion_shdlc_recorder_dump_callback recorder_dump_callback;
+static void* recorder_user_data;
+
+void sensirion_shdlc_recorder_set_dump_callback(
+    sensirion_shdlc_recorder_dump_callback callback, void* user_data) {
+    recorder_dump_callback = callback;
+    recorder_user_data = user_data;
+}
+
+static void
+sensirion_shdlc_recorder_begin_write(struct sensirion_shdlc_recorder_ring* r) {
+    r->sequence++;
+    SENSIRION_MEMORY_BARRIER();
+}
+
+static void
+sensirion_shdlc_recorder_end_write(struct sensirion_shdlc_recorder_ring* r) {
+    SENSIRION_MEMORY_BARRIER();
+    r->sequence++;
+}
+
+static uint16_t
+sensirion_shdlc_recorder_copy(const struct sensirion_shdlc_trace_frame* frame,
+                              uint8_t* destination) {
+    uint16_t len = frame->raw_len;
+
+    if (len > SENSIRION_SHDLC_RECORDER_FRAME_SIZE) {
+        len = SENSIRION_SHDLC_RECORDER_FRAME_SIZE;
+    }
+    sensirion_common_copy_bytes(frame->raw, destination, len);
+    return frame->raw_len;
+}
+
+/* start a transaction in the slot at head, dropping the oldest if full */
+static struct sensirion_shdlc_recorder_entry*
+sensirion_shdlc_recorder_start(struct sensirion_shdlc_recorder_ring* ring) {
+    struct sensirion_shdlc_recorder_entry* entry = &ring->entries[ring->head];
+
+    if (ring->count == SENSIRION_SHDLC_RECORDER_DEPTH) {
+        ring->count--;
+    }
+    entry->tx_timestamp_us = 0;
+    entry->rx_timestamp_us = 0;
+    entry->error = NO_ERROR;
+    entry->tx_len = 0;
+    entry->rx_len = 0;
+    entry->command = 0;
+    entry->reserved = 0;
+    ring->pending = true;
+    return entry;
+}
+
+static void
+sensirion_shdlc_recorder_complete(struct sensirion_shdlc_recorder_ring* ring) {
+    ring->head = (uint16_t)((ring->head + 1) % SENSIRION_SHDLC_RECORDER_DEPTH);
+    ring->count++;
+    ring->pending = false;
+}
+
+void sensirion_shdlc_recorder_add_frame(
+    const struct sensirion_shdlc_trace_frame* frame) {
+    struct sensirion_shdlc_recorder_ring* ring;
+    struct sensirion_shdlc_recorder_entry* entry;
+    bool failed;
+
+    if (frame->port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    ring = &recorder_table[frame->port];
+
+    sensirion_shdlc_recorder_begin_write(ring);
+    if (frame->direction == SENSIRION_SHDLC_TRACE_TX) {
+        if (ring->pending) {
+            /* the previous request was never answered */
+            sensirion_shdlc_recorder_complete(ring);
+        }
+        entry = sensirion_shdlc_recorder_start(ring);
+        entry->tx_timestamp_us = frame->timestamp_us;
+        entry->command = frame->cmd;
+        entry->tx_len = sensirion_shdlc_recorder_copy(frame, entry->tx);
+    } else {
+        entry = ring->pending ? &ring->entries[ring->head]
+                              : sensirion_shdlc_recorder_start(ring);
+        entry->rx_timestamp_us = frame->timestamp_us;
+        entry->rx_len = sensirion_shdlc_recorder_copy(frame, entry->rx);
+    }
+    entry->error = frame->error;
+    failed = frame->error != NO_ERROR;
+    if (failed || frame->direction == SENSIRION_SHDLC_TRACE_RX) {
+        sensirion_shdlc_recorder_complete(ring);
+    }
+    sensirion_shdlc_recorder_end_write(ring);
+
+    if (!ring->pending) {
+        if (failed && !ring->failing) {
+            sensirion_shdlc_recorder_trigger_dump(frame->port);
+        }
+        ring->failing = failed;
+    }
+}
+
+uint16_t sensirion_shdlc_recorder_snapshot(
+    uint16_t port, struct sensirion_shdlc_recorder_entry* entries,
+    uint16_t max_entries) {
+    volatile struct sensirion_shdlc_recorder_ring* ring;
+    const volatile uint8_t* source;
+    uint8_t* destination;
+    uint32_t sequence;
+    uint16_t count;
+    uint16_t first;
+    uint16_t slot;
+    uint16_t i;
+    size_t j;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return 0;
+    }
+    ring = &recorder_table[port];
+    do {
+        sequence = ring->sequence;
+        SENSIRION_MEMORY_BARRIER();
+        count = ring->count;
+        if (count > max_entries) {
+            count = max_entries;
+        }
+        /* the completed entries end right before head */
+        first = (uint16_t)((ring->head + SENSIRION_SHDLC_RECORDER_DEPTH -
+                            count) %
+                           SENSIRION_SHDLC_RECORDER_DEPTH);
+        for (i = 0; i < count; i++) {
+            slot = (uint16_t)((first + i) % SENSIRION_SHDLC_RECORDER_DEPTH);
+            source = (const volatile uint8_t*)&ring->entries[slot];
+            destination = (uint8_t*)&entries[i];
+            for (j = 0; j < sizeof(*entries); j++) {
+                destination[j] = source[j];
+            }
+        }
+        SENSIRION_MEMORY_BARRIER();
+    } while ((sequence & 1) || sequence != ring->sequence);
+    return count;
+}
+
+void sensirion_shdlc_recorder_trigger_dump(uint16_t port) {
+    if (recorder_dump_callback != NULL) {
+        recorder_dump_callback(port, recorder_user_data);
+    }
+}
+
+#else
+
+/* applications reading the recorder still link without it */
+void sensirion_shdlc_recorder_set_dump_callback(
+    sensirion_shdlc_recorder_dump_callback callback, void* user_data) {
+    (void)callback;
+    (void)user_data;
+}
+
+uint16_t sensirion_shdlc_recorder_snapshot(
+    uint16_t port, struct sensirion_shdlc_recorder_entry* entries,
+    uint16_t max_entries) {
+    (void)port;
+    (void)entries;
+    (void)max_entries;
+    return 0;
+}
+
+#endif /* SENSIRION_SHDLC_FLIGHT_RECORDER */
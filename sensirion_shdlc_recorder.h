@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_recorder.h
+ *
+ *  Flight recorder keeping the last SENSIRION_SHDLC_RECORDER_DEPTH
+ *  transactions of every UART port in a fixed ring: the raw request and
+ *  response bytes as seen on the wire, their timestamps and the result.
+ *
+ *  A registered dump callback is invoked when a transaction fails after the
+ *  previous one succeeded, so a burst of failures during an outage causes
+ *  only one dump. Watchdogs can request a dump at any time with
+ *  sensirion_shdlc_recorder_trigger_dump().
+ *
+ *  The recorder is fed by the frame trace of sensirion_shdlc_trace.h and is
+ *  only compiled in if SENSIRION_SHDLC_FLIGHT_RECORDER is set in
+ *  sensirion_config.h.
+ */
+#ifndef SENSIRION_SHDLC_RECORDER_H
+#define SENSIRION_SHDLC_RECORDER_H
+
+#include "sensirion_config.h"
+#include "sensirion_shdlc_trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of transactions kept per port */
+#ifndef SENSIRION_SHDLC_RECORDER_DEPTH
+#define SENSIRION_SHDLC_RECORDER_DEPTH 8
+#endif
+
+/**
+ * Wire bytes kept per frame, longer frames are cut. The default holds the
+ * largest SPS30 response, a float measurement with every byte stuffed.
+ */
+#ifndef SENSIRION_SHDLC_RECORDER_FRAME_SIZE
+#define SENSIRION_SHDLC_RECORDER_FRAME_SIZE 96
+#endif
+
+/**
+ * One transaction. The layout has no padding on common ABIs, dumps are
+ * written as is in host byte order.
+ */
+struct sensirion_shdlc_recorder_entry {
+    uint64_t tx_timestamp_us;  //< first request byte on the wire, 0 if none
+    uint64_t rx_timestamp_us;  //< first response byte, 0 if none
+    int16_t error;             //< result of the transaction
+    uint16_t tx_len;           //< request bytes on the wire, may exceed
+                               //< SENSIRION_SHDLC_RECORDER_FRAME_SIZE
+    uint16_t rx_len;           //< response bytes on the wire
+    uint8_t command;           //< SHDLC command ID of the request
+    uint8_t reserved;
+    uint8_t tx[SENSIRION_SHDLC_RECORDER_FRAME_SIZE];
+    uint8_t rx[SENSIRION_SHDLC_RECORDER_FRAME_SIZE];
+};
+
+/**
+ * Callback asked to persist the recorded transactions of a port, typically
+ * with sensirion_shdlc_recorder_snapshot(). It is invoked from the thread
+ * driving the failed transaction or calling
+ * sensirion_shdlc_recorder_trigger_dump() and must not call into the driver.
+ */
+typedef void (*sensirion_shdlc_recorder_dump_callback)(uint16_t port,
+                                                       void* user_data);
+
+/**
+ * sensirion_shdlc_recorder_set_dump_callback() - Register the dump callback.
+ *
+ * Without the flight recorder the callback is never invoked.
+ *
+ * @param callback  Function called to dump a port, NULL to disable dumps
+ * @param user_data Pointer passed to every invocation of the callback
+ */
+void sensirion_shdlc_recorder_set_dump_callback(
+    sensirion_shdlc_recorder_dump_callback callback, void* user_data);
+
+#if SENSIRION_SHDLC_FLIGHT_RECORDER
+/**
+ * sensirion_shdlc_recorder_add_frame() - Add a traced frame to the ring of
+ *                                        its port.
+ *
+ * This is called by the frame trace. A request starts a new entry, the
+ * response or a failed request completes it.
+ *
+ * @param frame Traced frame
+ */
+void sensirion_shdlc_recorder_add_frame(
+    const struct sensirion_shdlc_trace_frame* frame);
+#else
+/* the frame trace calls the hook unconditionally, without evaluating */
+#define sensirion_shdlc_recorder_add_frame(frame) ((void)0)
+#endif
+
+/**
+ * sensirion_shdlc_recorder_snapshot() - Copy the completed transactions of a
+ *                                       port, oldest first.
+ *
+ * Lock-free, may be called from any thread while transactions are running.
+ *
+ * @param port        UART port index, see sensirion_uart_hal_select_port()
+ * @param entries     Memory for up to max_entries entries
+ * @param max_entries Capacity of entries
+ *
+ * @return Number of entries copied, the newest ones if max_entries is too
+ *         small, always 0 without the flight recorder
+ */
+uint16_t sensirion_shdlc_recorder_snapshot(
+    uint16_t port, struct sensirion_shdlc_recorder_entry* entries,
+    uint16_t max_entries);
+
+#if SENSIRION_SHDLC_FLIGHT_RECORDER
+/**
+ * sensirion_shdlc_recorder_trigger_dump() - Invoke the dump callback for a
+ *                                           port, e.g. from a watchdog.
+ *
+ * Without the flight recorder there is nothing to dump and this does nothing.
+ *
+ * @param port UART port index, see sensirion_uart_hal_select_port()
+ */
+void sensirion_shdlc_recorder_trigger_dump(uint16_t port);
+#else
+#define sensirion_shdlc_recorder_trigger_dump(port) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SENSIRION_SHDLC_RECORDER_H
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_retry.c
+ */
+#include "sensirion_shdlc_retry.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+
+struct sensirion_shdlc_retry_port {
+    bool configured;  //< false until a policy was set, the default applies
+    struct sensirion_shdlc_retry_policy policy;
+};
+
+static struct sensirion_shdlc_retry_port retry_table[SENSIRION_UART_MAX_PORTS];
+
+int16_t sensirion_shdlc_retry_set_policy(
+    uint16_t port, const struct sensirion_shdlc_retry_policy* policy) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    if (policy == NULL) {
+        retry_table[port].configured = false;
+        return NO_ERROR;
+    }
+    retry_table[port].policy = *policy;
+    /* a transaction is attempted at least once */
+    if (retry_table[port].policy.max_attempts == 0) {
+        retry_table[port].policy.max_attempts = 1;
+    }
+    retry_table[port].configured = true;
+    return NO_ERROR;
+}
+
+int16_t sensirion_shdlc_retry_get_policy(
+    uint16_t port, struct sensirion_shdlc_retry_policy* policy) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    if (retry_table[port].configured) {
+        *policy = retry_table[port].policy;
+        return NO_ERROR;
+    }
+    policy->max_attempts = SENSIRION_SHDLC_RETRY_MAX_ATTEMPTS;
+    policy->backoff_ms = SENSIRION_SHDLC_RETRY_BACKOFF_MS;
+    policy->budget_ms = SENSIRION_SHDLC_RETRY_BUDGET_MS;
+    return NO_ERROR;
+}
+
+bool sensirion_shdlc_retry_is_retryable(int16_t error) {
+    switch (error) {
+        case SENSIRION_SHDLC_ERR_MISSING_START:
+        case SENSIRION_SHDLC_ERR_MISSING_STOP:
+        case SENSIRION_SHDLC_ERR_CRC_MISMATCH:
+        case SENSIRION_SHDLC_ERR_TX_INCOMPLETE:
+        case SENSIRION_SHDLC_ERR_FRAME_TOO_LONG:
+        case SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH:
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_retry.h
+ *
+ *  Retry policy of SHDLC transactions. sensirion_shdlc_transceive() repeats
+ *  a transaction whose response was lost or damaged on the wire: a timeout,
+ *  a missing start or stop byte, a checksum mismatch, a frame of the wrong
+ *  length, only responses to other requests or an incomplete transmission.
+ *  A response in which the sensor reports an execution error is final and
+ *  never repeated.
+ *
+ *  Every port has a policy with the maximum number of attempts, the backoff
+ *  before the first repetition, which doubles with every further one, and a
+ *  budget for the whole transaction. The budget includes all attempts and
+ *  backoffs; the response deadline of each attempt is shortened to the
+ *  remaining budget, and no attempt starts once it is used up. This bounds
+ *  the time a failing sensor can take from a measurement cycle. On platforms
+ *  whose HAL has no clock only the number of attempts bounds a transaction.
+ *
+ *  Only idempotent commands are repeated after any of these errors. Once a
+ *  request has been sent, a lost response does not tell whether the sensor
+ *  executed it, so commands whose repetition changes the outcome, e.g.
+ *  starting a fan cleaning or resetting the device, are attempted exactly
+ *  once.
+ *
+ *  Reading the measured values is not idempotent either: the sensor hands
+ *  out every sample once, and a repeated read after a damaged response only
+ *  gets the empty frame of a sensor without new values. Such a sample is
+ *  lost, no retry recovers it. The read is repeated only if not a single
+ *  byte of a response arrived, i.e. the sensor most likely ignored a
+ *  damaged request and still holds the sample.
+ *
+ *  Like every request, a repetition first discards the bytes which arrived in
+ *  the meantime, e.g. the rest of a damaged frame or a late response.
+ */
+#ifndef SENSIRION_SHDLC_RETRY_H
+#define SENSIRION_SHDLC_RETRY_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Attempts per transaction of ports without a policy, 1 disables retries */
+#ifndef SENSIRION_SHDLC_RETRY_MAX_ATTEMPTS
+#define SENSIRION_SHDLC_RETRY_MAX_ATTEMPTS 3
+#endif
+
+/** Backoff before the first repetition of ports without a policy */
+#ifndef SENSIRION_SHDLC_RETRY_BACKOFF_MS
+#define SENSIRION_SHDLC_RETRY_BACKOFF_MS 5
+#endif
+
+/**
+ * Budget of a transaction of ports without a policy, well within the 1 s
+ * cadence of the measurement
+ */
+#ifndef SENSIRION_SHDLC_RETRY_BUDGET_MS
+#define SENSIRION_SHDLC_RETRY_BUDGET_MS 250
+#endif
+
+/** Longest request which is kept for a repetition, including the header */
+#ifndef SENSIRION_SHDLC_RETRY_MAX_REQUEST_SIZE
+#define SENSIRION_SHDLC_RETRY_MAX_REQUEST_SIZE 16
+#endif
+
+/** Whether sensirion_shdlc_transceive() may repeat a transaction */
+typedef enum {
+    SENSIRION_SHDLC_ATTEMPT_ONCE = 0,   //< the request is sent once
+    SENSIRION_SHDLC_IDEMPOTENT,         //< repeated after any link error
+    SENSIRION_SHDLC_REPEAT_UNANSWERED,  //< repeated if nothing was received
+} sensirion_shdlc_repetition;
+
+struct sensirion_shdlc_retry_policy {
+    uint8_t max_attempts;  //< attempts per transaction, 1 disables retries
+    uint32_t backoff_ms;   //< wait before the first repetition, then doubled
+    uint32_t budget_ms;    //< time for all attempts, 0 for no limit
+};
+
+/**
+ * sensirion_shdlc_retry_set_policy() - Set the retry policy of a port.
+ *
+ * Must be called from the thread performing the transactions of that port.
+ *
+ * @param port   UART port index, see sensirion_uart_hal_select_port()
+ * @param policy Policy to apply, NULL restores the default policy
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port.
+ */
+int16_t sensirion_shdlc_retry_set_policy(
+    uint16_t port, const struct sensirion_shdlc_retry_policy* policy);
+
+/**
+ * sensirion_shdlc_retry_get_policy() - Read the retry policy of a port.
+ *
+ * @param port   UART port index
+ * @param policy Memory where the policy is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port.
+ */
+int16_t sensirion_shdlc_retry_get_policy(
+    uint16_t port, struct sensirion_shdlc_retry_policy* policy);
+
+/**
+ * sensirion_shdlc_retry_is_retryable() - Tell whether a failed attempt may be
+ *                                        repeated.
+ *
+ * This is called by the SHDLC layer.
+ *
+ * @param error Result of the attempt
+ *
+ * @return True if the error was caused by the link rather than the sensor
+ */
+bool sensirion_shdlc_retry_is_retryable(int16_t error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SENSIRION_SHDLC_RETRY_H
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_timeout.c
+ */
+#include "sensirion_shdlc_timeout.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+
+#if SENSIRION_SHDLC_ADAPTIVE_TIMEOUT
+
+/* lower bound of the deviation term, the resolution of the deadline */
+#define SENSIRION_SHDLC_TIMEOUT_MIN_DEVIATION_US 1000
+/* bounds the doubling, far above any SHDLC timeout */
+#define SENSIRION_SHDLC_TIMEOUT_MAX_RTO_US 0x40000000
+
+struct sensirion_shdlc_timeout_command {
+    bool used;
+    uint8_t command;
+    struct sensirion_shdlc_timeout_estimate estimate;
+};
+
+static struct sensirion_shdlc_timeout_command
+    timeout_table[SENSIRION_UART_MAX_PORTS]
+                 [SENSIRION_SHDLC_TIMEOUT_MAX_COMMANDS];
+
+static struct sensirion_shdlc_timeout_command*
+sensirion_shdlc_timeout_find(uint16_t port, uint8_t command, bool create) {
+    struct sensirion_shdlc_timeout_command* slots = timeout_table[port];
+    uint8_t i;
+
+    for (i = 0; i < SENSIRION_SHDLC_TIMEOUT_MAX_COMMANDS; i++) {
+        if (slots[i].used && slots[i].command == command) {
+            return &slots[i];
+        }
+        if (!slots[i].used) {
+            if (!create) {
+                return NULL;
+            }
+            slots[i].used = true;
+            slots[i].command = command;
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t sensirion_shdlc_timeout_get_ms(uint8_t command,
+                                        uint32_t max_timeout_ms) {
+    struct sensirion_shdlc_timeout_command* slot;
+    uint32_t timeout_ms;
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return max_timeout_ms;
+    }
+    slot = sensirion_shdlc_timeout_find(port, command, false);
+    if (slot == NULL || slot->estimate.samples == 0) {
+        return max_timeout_ms;
+    }
+    timeout_ms = (slot->estimate.rto_us + 999) / 1000;
+    if (timeout_ms < SENSIRION_SHDLC_TIMEOUT_MIN_MS) {
+        timeout_ms = SENSIRION_SHDLC_TIMEOUT_MIN_MS;
+    }
+    return timeout_ms < max_timeout_ms ? timeout_ms : max_timeout_ms;
+}
+
+void sensirion_shdlc_timeout_record(uint8_t command, uint64_t duration_us,
+                                    bool timed_out) {
+    struct sensirion_shdlc_timeout_command* slot;
+    struct sensirion_shdlc_timeout_estimate* e;
+    uint32_t rtt_us;
+    uint32_t deviation_us;
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    slot = sensirion_shdlc_timeout_find(port, command, true);
+    if (slot == NULL) {
+        return;
+    }
+    e = &slot->estimate;
+    if (timed_out) {
+        /* back off, no round-trip time can be taken from a lost response */
+        e->timeouts++;
+        if (e->rto_us < (uint32_t)SENSIRION_SHDLC_TIMEOUT_MIN_MS * 1000) {
+            e->rto_us = (uint32_t)SENSIRION_SHDLC_TIMEOUT_MIN_MS * 1000;
+        }
+        if (e->rto_us < SENSIRION_SHDLC_TIMEOUT_MAX_RTO_US) {
+            e->rto_us *= 2;
+        }
+        return;
+    }
+
+    rtt_us = duration_us < SENSIRION_SHDLC_TIMEOUT_MAX_RTO_US
+                 ? (uint32_t)duration_us
+                 : SENSIRION_SHDLC_TIMEOUT_MAX_RTO_US;
+    if (e->samples == 0) {
+        e->srtt_us = rtt_us;
+        e->rttvar_us = rtt_us / 2;
+    } else {
+        deviation_us =
+            e->srtt_us > rtt_us ? e->srtt_us - rtt_us : rtt_us - e->srtt_us;
+        /* rttvar += (|srtt - rtt| - rttvar) / 4, srtt += (rtt - srtt) / 8 */
+        e->rttvar_us = (3 * e->rttvar_us + deviation_us) / 4;
+        e->srtt_us = (7 * e->srtt_us + rtt_us) / 8;
+    }
+    e->samples++;
+    e->timeouts = 0;
+    deviation_us = 4 * e->rttvar_us;
+    if (deviation_us < SENSIRION_SHDLC_TIMEOUT_MIN_DEVIATION_US) {
+        deviation_us = SENSIRION_SHDLC_TIMEOUT_MIN_DEVIATION_US;
+    }
+    e->rto_us = e->srtt_us + deviation_us;
+}
+
+int16_t sensirion_shdlc_timeout_get_estimate(
+    uint16_t port, uint8_t command,
+    struct sensirion_shdlc_timeout_estimate* estimate) {
+    struct sensirion_shdlc_timeout_command* slot;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    slot = sensirion_shdlc_timeout_find(port, command, false);
+    if (slot == NULL) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    *estimate = slot->estimate;
+    return NO_ERROR;
+}
+
+void sensirion_shdlc_timeout_reset(uint16_t port) {
+    uint8_t i;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    for (i = 0; i < SENSIRION_SHDLC_TIMEOUT_MAX_COMMANDS; i++) {
+        timeout_table[port][i].used = false;
+        timeout_table[port][i].estimate.samples = 0;
+        timeout_table[port][i].estimate.timeouts = 0;
+    }
+}
+
+#endif /* SENSIRION_SHDLC_ADAPTIVE_TIMEOUT */
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_timeout.h
+ *
+ *  Adaptive response deadlines. For every port and command the SHDLC layer
+ *  keeps a smoothed round-trip time and its mean deviation, the way TCP
+ *  estimates its retransmission timeout (RFC 6298). The deadline of the next
+ *  response is the smoothed round-trip time plus four deviations, bounded by
+ *  SENSIRION_SHDLC_TIMEOUT_MIN_MS and by the timeout the caller passes to
+ *  sensirion_shdlc_read_response(), which stays the worst case for the
+ *  command. Until the first response of a command has been measured the
+ *  caller's timeout is used.
+ *
+ *  Every timeout doubles the deadline of that command up to the caller's
+ *  timeout, so a slow sensor causes at most a few timeouts before the
+ *  estimate has caught up, while a dead sensor is detected after a few
+ *  round-trip times. The round-trip time is measured from the end of the
+ *  request to the end of the response, which is the span the deadline
+ *  bounds.
+ *
+ *  The estimates are only compiled in if SENSIRION_SHDLC_ADAPTIVE_TIMEOUT is
+ *  set in sensirion_config.h.
+ */
+#ifndef SENSIRION_SHDLC_TIMEOUT_H
+#define SENSIRION_SHDLC_TIMEOUT_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of distinct command IDs tracked per port */
+#ifndef SENSIRION_SHDLC_TIMEOUT_MAX_COMMANDS
+#define SENSIRION_SHDLC_TIMEOUT_MAX_COMMANDS 16
+#endif
+
+/** Shortest adaptive deadline, covers the scheduling jitter of the host */
+#ifndef SENSIRION_SHDLC_TIMEOUT_MIN_MS
+#define SENSIRION_SHDLC_TIMEOUT_MIN_MS 10
+#endif
+
+struct sensirion_shdlc_timeout_estimate {
+    uint32_t samples;     //< number of measured round-trip times
+    uint32_t timeouts;    //< timeouts since the last measured response
+    uint32_t srtt_us;     //< smoothed round-trip time
+    uint32_t rttvar_us;   //< mean deviation of the round-trip time
+    uint32_t rto_us;      //< deadline before the bounds are applied
+};
+
+/**
+ * sensirion_shdlc_timeout_get_ms() - Deadline of the next response of a
+ *                                    command on the selected port.
+ *
+ * This is called by the SHDLC layer.
+ *
+ * @param command        SHDLC command ID
+ * @param max_timeout_ms Timeout of the command, the upper bound
+ *
+ * @return Timeout in milliseconds
+ */
+uint32_t sensirion_shdlc_timeout_get_ms(uint8_t command,
+                                        uint32_t max_timeout_ms);
+
+/**
+ * sensirion_shdlc_timeout_record() - Update the estimate of a command on the
+ *                                    selected port.
+ *
+ * This is called by the SHDLC layer for every response that was received
+ * completely and for every response that ran into its deadline.
+ *
+ * @param command     SHDLC command ID
+ * @param duration_us Time from the end of the request to the end of the
+ *                    response, ignored on timeouts
+ * @param timed_out   True if the response deadline passed
+ */
+void sensirion_shdlc_timeout_record(uint8_t command, uint64_t duration_us,
+                                    bool timed_out);
+
+/**
+ * sensirion_shdlc_timeout_get_estimate() - Read the estimate of a command.
+ *
+ * Must be called from the thread performing the transactions.
+ *
+ * @param port     UART port index, see sensirion_uart_hal_select_port()
+ * @param command  SHDLC command ID, e.g. one of SPS30_CMD_ID
+ * @param estimate Memory where the estimate is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port, SENSIRION_SHDLC_ERR_NO_DATA if nothing was recorded
+ *         for this port and command.
+ */
+int16_t sensirion_shdlc_timeout_get_estimate(
+    uint16_t port, uint8_t command,
+    struct sensirion_shdlc_timeout_estimate* estimate);
+
+/**
+ * sensirion_shdlc_timeout_reset() - Forget the estimates of a port, e.g.
+ *                                   after the sensor was replaced.
+ *
+ * @param port UART port index
+ */
+void sensirion_shdlc_timeout_reset(uint16_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SENSIRION_SHDLC_TIMEOUT_H
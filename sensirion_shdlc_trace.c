@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_trace.c
+ */
+#include "sensirion_shdlc_trace.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc_recorder.h"
+#include "sensirion_uart_hal.h"
+
+#if SENSIRION_SHDLC_TRACE
+
+#define SHDLC_FRAME_DELIMITER 0x7e
+#define SHDLC_STUFF_BYTE 0x7d
+
+/** address, command and data length */
+#define SHDLC_MOSI_HEADER_SIZE 3
+/** address, command, state and data length */
+#define SHDLC_MISO_HEADER_SIZE 4
+
+static sensirion_shdlc_trace_callback trace_callback;
+static void* trace_user_data;
+
+/* the SHDLC layer handles one frame at a time, so one capture is enough */
+static bool trace_capturing;
+static bool trace_truncated;
+static uint16_t trace_length;
+static uint64_t trace_timestamp_us;
+static uint8_t trace_buffer[SENSIRION_SHDLC_TRACE_MAX_FRAME_SIZE];
+
+void sensirion_shdlc_trace_set_callback(sensirion_shdlc_trace_callback callback,
+                                        void* user_data) {
+    trace_callback = callback;
+    trace_user_data = user_data;
+}
+
+void sensirion_shdlc_trace_begin(void) {
+    trace_capturing = trace_callback != NULL || SENSIRION_SHDLC_FLIGHT_RECORDER;
+    trace_truncated = false;
+    trace_length = 0;
+}
+
+void sensirion_shdlc_trace_capture(int16_t ret, const uint8_t* data) {
+    uint16_t len;
+
+    if (!trace_capturing || ret <= 0) {
+        return;
+    }
+    if (trace_length == 0) {
+        trace_timestamp_us = sensirion_uart_hal_get_time_usec();
+    }
+    len = (uint16_t)ret;
+    if (len > sizeof(trace_buffer) - trace_length) {
+        len = (uint16_t)(sizeof(trace_buffer) - trace_length);
+        trace_truncated = true;
+    }
+    sensirion_common_copy_bytes(data, &trace_buffer[trace_length], len);
+    trace_length += len;
+}
+
+void sensirion_shdlc_trace_end(sensirion_shdlc_trace_direction direction,
+                               int16_t error) {
+    struct sensirion_shdlc_trace_frame frame;
+    uint8_t header[SHDLC_MISO_HEADER_SIZE] = {0};
+    uint8_t header_size = direction == SENSIRION_SHDLC_TRACE_TX
+                              ? SHDLC_MOSI_HEADER_SIZE
+                              : SHDLC_MISO_HEADER_SIZE;
+    uint8_t j = 0;
+    uint16_t i;
+
+    if (!trace_capturing) {
+        return;
+    }
+    trace_capturing = false;
+    if (trace_length == 0) {
+        trace_timestamp_us = 0;
+    }
+
+    /* decode the header from the wire bytes as far as they go */
+    for (i = 1; i < trace_length && j < header_size &&
+                trace_buffer[0] == SHDLC_FRAME_DELIMITER;
+         i++) {
+        if (trace_buffer[i] == SHDLC_STUFF_BYTE) {
+            if (++i == trace_length) {
+                break;
+            }
+            header[j++] = trace_buffer[i] ^ (1 << 5);
+        } else {
+            header[j++] = trace_buffer[i];
+        }
+    }
+
+    frame.direction = direction;
+    frame.port = sensirion_uart_hal_get_selected_port();
+    frame.timestamp_us = trace_timestamp_us;
+    frame.error = error;
+    frame.addr = header[0];
+    frame.cmd = header[1];
+    if (direction == SENSIRION_SHDLC_TRACE_TX) {
+        frame.state = 0;
+        frame.data_len = header[2];
+    } else {
+        frame.state = header[2];
+        frame.data_len = header[3];
+    }
+    frame.truncated = trace_truncated;
+    frame.raw_len = trace_length;
+    frame.raw = trace_buffer;
+    sensirion_shdlc_recorder_add_frame(&frame);
+    if (trace_callback != NULL && trace_length != 0) {
+        trace_callback(&frame, trace_user_data);
+    }
+}
+
+#else
+
+/* applications registering a callback still link without the trace */
+void sensirion_shdlc_trace_set_callback(sensirion_shdlc_trace_callback callback,
+                                        void* user_data) {
+    (void)callback;
+    (void)user_data;
+}
+
+#endif /* SENSIRION_SHDLC_TRACE */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sensirion_shdlc_trace.h
+ *
+ *  Hook to observe every SHDLC frame exchanged with the sensors. The callback
+ *  receives the bytes exactly as they were seen on the wire, including the
+ *  frame delimiters and byte stuffing, together with the decoded header and
+ *  the result of encoding or decoding the frame.
+ *
+ *  The hook is only compiled in if SENSIRION_SHDLC_TRACE is set in
+ *  sensirion_config.h, without it a registered callback is never invoked.
+ *  While no callback is registered, frames are not captured at all.
+ */
+#ifndef SENSIRION_SHDLC_TRACE_H
+#define SENSIRION_SHDLC_TRACE_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** start/stop + (5 header + 255 data) * 2 because of byte stuffing */
+#define SENSIRION_SHDLC_TRACE_MAX_FRAME_SIZE (2 + (5 + 255) * 2)
+
+typedef enum {
+    SENSIRION_SHDLC_TRACE_TX = 0,  //< request sent to the sensor
+    SENSIRION_SHDLC_TRACE_RX,      //< response received from the sensor
+} sensirion_shdlc_trace_direction;
+
+struct sensirion_shdlc_trace_frame {
+    sensirion_shdlc_trace_direction direction;
+    uint16_t port;          //< UART port index the frame was exchanged on
+    uint64_t timestamp_us;  //< monotonic time of the first byte on the wire
+    int16_t error;          //< NO_ERROR or the error the frame caused
+    uint8_t addr;           //< decoded header fields, 0 if the frame ended
+    uint8_t cmd;            //< before the field
+    uint8_t state;          //< always 0 for requests
+    uint8_t data_len;
+    bool truncated;         //< raw is incomplete, the frame was too long
+    uint16_t raw_len;
+    const uint8_t* raw;     //< wire bytes, only valid during the callback
+};
+
+/**
+ * Callback invoked from the thread driving the SHDLC transaction. It must not
+ * call into the driver.
+ */
+typedef void (*sensirion_shdlc_trace_callback)(
+    const struct sensirion_shdlc_trace_frame* frame, void* user_data);
+
+/**
+ * sensirion_shdlc_trace_set_callback() - Register the trace callback.
+ *
+ * @param callback  Function called for every frame, NULL to stop tracing
+ * @param user_data Pointer passed to every invocation of the callback
+ */
+void sensirion_shdlc_trace_set_callback(sensirion_shdlc_trace_callback callback,
+                                        void* user_data);
+
+#if SENSIRION_SHDLC_TRACE
+/**
+ * sensirion_shdlc_trace_begin() - Start capturing a frame.
+ *
+ * This is called by the SHDLC layer.
+ */
+void sensirion_shdlc_trace_begin(void);
+
+/**
+ * sensirion_shdlc_trace_capture() - Append the data of a HAL call to the
+ *                                   captured frame.
+ *
+ * This is called by the SHDLC layer.
+ *
+ * @param ret  Return value of the HAL call
+ * @param data Data transmitted or received by the HAL call
+ */
+void sensirion_shdlc_trace_capture(int16_t ret, const uint8_t* data);
+
+/**
+ * sensirion_shdlc_trace_end() - Pass the captured frame to the callback.
+ *
+ * This is called by the SHDLC layer. The callback is not invoked if no byte
+ * was transferred, the flight recorder still records the result.
+ *
+ * @param direction Whether the frame was transmitted or received
+ * @param error     Result of encoding or decoding the frame
+ */
+void sensirion_shdlc_trace_end(sensirion_shdlc_trace_direction direction,
+                               int16_t error);
+#else
+/* the SHDLC layer calls the hooks unconditionally, without evaluating */
+#define sensirion_shdlc_trace_begin() ((void)0)
+#define sensirion_shdlc_trace_capture(ret, data) ((void)0)
+#define sensirion_shdlc_trace_end(direction, error) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SENSIRION_SHDLC_TRACE_H
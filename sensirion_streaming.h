@@ -50,6 +50,7 @@ typedef struct sensirion_streaming_state_tag {
     uint16_t offset;  //< Number of valid bytes in the buffer
     uint8_t checksum;       //< Checksum or crc depending on used protocol
     int16_t stream_status;  //< status of the last stream (read/write) operation
+    uint64_t tx_timestamp_us;  //< monotonic time the last request was sent
     union {
         int16_t (*read)(uint16_t length, uint8_t* data);
         int16_t (*write)(uint16_t length, const uint8_t* data);
@@ -33,6 +33,11 @@
  *  @file sensirion_streaming_shdlc.c
  */
 #include "sensirion_streaming_shdlc.h"
+#include "sensirion_shdlc_counters.h"
+#include "sensirion_shdlc_latency.h"
+#include "sensirion_shdlc_retry.h"
+#include "sensirion_shdlc_timeout.h"
+#include "sensirion_shdlc_trace.h"
 #include "sensirion_streaming.h"
 #include "sensirion_uart_hal.h"
 
@@ -43,6 +48,23 @@
 #define SHDLC_MOSI_CMD_POS 1
 #define SHDLC_MOSI_LEN_POS 2
 
+/** address, command, state and data length */
+#define SHDLC_MISO_HEADER_SIZE 4
+
+#define SHDLC_POLL_INTERVAL_US 1000
+
+/* bounds the doubling of the retry backoff */
+#define SHDLC_MAX_BACKOFF_US 0x40000000
+
+static sensirion_shdlc_request_hook shdlc_request_hook;
+static sensirion_shdlc_response_hook shdlc_response_hook;
+
+void sensirion_shdlc_set_hooks(sensirion_shdlc_request_hook request_hook,
+                               sensirion_shdlc_response_hook response_hook) {
+    shdlc_request_hook = request_hook;
+    shdlc_response_hook = response_hook;
+}
+
 static void sensirion_shdlc_stream_stuff_and_write_next_byte(
     sensirion_streaming_state* stream, uint8_t byte) {
     stream->checksum += byte;
@@ -67,17 +89,89 @@ static void sensirion_shdlc_stream_stuff_and_write_next_byte(
     stream->stream_status = stream->stream.write(1, &byte);
 }
 
-static uint8_t sensirion_shdlc_stream_read_and_unstuff_next_byte(
-    sensirion_streaming_state* stream) {
+/*
+ * Deadline of a response. The number of remaining polls bounds the wait on
+ * platforms whose HAL has no clock.
+ */
+struct sensirion_shdlc_deadline {
+    uint64_t start_us;
+    uint32_t timeout_ms;
+    uint32_t polls_left;
+};
+
+/*
+ * Wait for data unless the response deadline has passed. HALs that cannot
+ * wait for data are polled once per poll interval.
+ */
+static bool
+sensirion_shdlc_wait_for_data(struct sensirion_shdlc_deadline* deadline) {
+    uint64_t timeout_us = (uint64_t)deadline->timeout_ms * 1000;
+    uint64_t elapsed_us =
+        sensirion_uart_hal_get_time_usec() - deadline->start_us;
+    uint64_t remaining_us;
+
+    if (deadline->polls_left == 0 || elapsed_us >= timeout_us) {
+        return false;
+    }
+    remaining_us = timeout_us - elapsed_us;
+    if (remaining_us > 0xFFFFFFFF) {
+        remaining_us = 0xFFFFFFFF;
+    }
+    switch (sensirion_uart_hal_wait_rx_usec((uint32_t)remaining_us)) {
+        case 1:
+            /* data arrived, waiting does not use up a poll */
+            break;
+        case 0:
+            deadline->polls_left--;
+            break;
+        default:
+            deadline->polls_left--;
+            sensirion_uart_hal_sleep_usec(SHDLC_POLL_INTERVAL_US);
+            break;
+    }
+    return true;
+}
+
+/*
+ * The response a request is waiting for. Frames of other transactions are
+ * skipped and their bytes counted.
+ */
+struct sensirion_shdlc_expected_response {
+    uint8_t address;
+    uint8_t command;
+    uint8_t max_data_length;
+    uint16_t discarded_bytes;
+};
 
+/*
+ * Read one byte from the wire, polling until it arrives or the deadline has
+ * passed. On return, stream_status is 1 if a byte was read, 0 on timeout or a
+ * negative error code.
+ */
+static uint8_t sensirion_shdlc_stream_read_next_byte(
+    sensirion_streaming_state* stream,
+    struct sensirion_shdlc_deadline* deadline) {
     uint8_t data = 0;
-    stream->stream_status = stream->stream.read(1, &data);
-    if (stream->stream_status < 0) {
+
+    while ((stream->stream_status = stream->stream.read(1, &data)) == 0) {
+        if (!sensirion_shdlc_wait_for_data(deadline)) {
+            break;
+        }
+    }
+    return data;
+}
+
+static uint8_t sensirion_shdlc_stream_read_and_unstuff_next_byte(
+    sensirion_streaming_state* stream,
+    struct sensirion_shdlc_deadline* deadline) {
+
+    uint8_t data = sensirion_shdlc_stream_read_next_byte(stream, deadline);
+    if (stream->stream_status != 1) {
         return 0;
     }
     if (data == SHDLC_STUFF_BYTE) {
-        stream->stream_status = stream->stream.read(1, &data);
-        if (stream->stream_status < 0) {
+        data = sensirion_shdlc_stream_read_next_byte(stream, deadline);
+        if (stream->stream_status != 1) {
             return 0;
         }
         data = data ^ (1 << 5);
@@ -86,20 +180,37 @@ static uint8_t sensirion_shdlc_stream_read_and_unstuff_next_byte(
     return data;
 }
 
+/* drop the rest of a frame up to its stop byte */
+static void sensirion_shdlc_stream_skip_frame(
+    sensirion_streaming_state* stream,
+    struct sensirion_shdlc_deadline* deadline,
+    struct sensirion_shdlc_expected_response* expected) {
+    uint8_t data;
+
+    do {
+        data = sensirion_shdlc_stream_read_next_byte(stream, deadline);
+        if (stream->stream_status != 1) {
+            return;
+        }
+        expected->discarded_bytes++;
+    } while (data != SHDLC_FRAME_DELIMITER);
+}
+
 void sensirion_shdlc_begin_stream(sensirion_streaming_state* stream,
                                   uint8_t* buffer, uint8_t command,
                                   uint8_t address, uint8_t data_length) {
     stream->data = buffer;
     stream->checksum = 0;
     stream->stream_status = 0;
+    stream->tx_timestamp_us = 0;
     stream->data[SHDLC_MOSI_ADDR_POS] = address;
     stream->data[SHDLC_MOSI_CMD_POS] = command;
     stream->data[SHDLC_MOSI_LEN_POS] = data_length;
     stream->offset = SHDLC_MOSI_LEN_POS + 1;
 }
 
-int16_t sensirion_shdlc_write_request(sensirion_streaming_state* stream) {
-    stream->stream.write = sensirion_uart_hal_tx;
+static int16_t
+sensirion_shdlc_stream_write_frame(sensirion_streaming_state* stream) {
     uint8_t shdlc_frame_delimiter = SHDLC_FRAME_DELIMITER;
     if ((stream->offset - 3) != stream->data[SHDLC_MOSI_LEN_POS]) {
         return SENSIRION_SHDLC_ERR_ENCODING_ERROR;
@@ -127,77 +238,322 @@ int16_t sensirion_shdlc_write_request(sensirion_streaming_state* stream) {
     return NO_ERROR;
 }
 
-int16_t sensirion_shdlc_read_response(sensirion_streaming_state* stream,
-                                      uint8_t expected_data_length,
-                                      struct sensirion_shdlc_rx_header* header,
-                                      uint32_t max_timeout_ms) {
-    stream->offset = 0;
-    stream->checksum = 0;
-    stream->stream_status = 0;
-    stream->stream.read = sensirion_uart_hal_rx;
+int16_t sensirion_shdlc_write_request(sensirion_streaming_state* stream) {
+    int16_t error;
+#if SENSIRION_SHDLC_LATENCY_HISTOGRAMS
+    uint64_t tx_start_us = sensirion_uart_hal_get_time_usec();
+#endif
+
+    if (shdlc_request_hook != NULL) {
+        error = shdlc_request_hook(stream->data[SHDLC_MOSI_CMD_POS],
+                                   &stream->data[SHDLC_MOSI_LEN_POS + 1],
+                                   stream->data[SHDLC_MOSI_LEN_POS]);
+        if (error != NO_ERROR) {
+            return error;
+        }
+    }
+    /* a late response must not be taken for the answer to this request */
+    sensirion_shdlc_drain_rx();
+    stream->stream.write = sensirion_shdlc_hal_tx;
+    sensirion_shdlc_trace_begin();
+    error = sensirion_shdlc_stream_write_frame(stream);
+    if (error != NO_ERROR) {
+        sensirion_shdlc_counters_record(stream->data[SHDLC_MOSI_CMD_POS], error,
+                                        false, 0);
+        sensirion_shdlc_trace_end(SENSIRION_SHDLC_TRACE_TX, error);
+        return error;
+    }
+    stream->tx_timestamp_us = sensirion_uart_hal_get_time_usec();
+    sensirion_shdlc_latency_record(stream->data[SHDLC_MOSI_CMD_POS],
+                                   SENSIRION_SHDLC_LATENCY_TX, tx_start_us,
+                                   stream->tx_timestamp_us);
+    sensirion_shdlc_trace_end(SENSIRION_SHDLC_TRACE_TX, NO_ERROR);
+    return NO_ERROR;
+}
+
+/*
+ * Read one frame. A frame which answers another request is read up to its
+ * stop byte and SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH is returned, so that
+ * the next frame can be read.
+ */
+static int16_t sensirion_shdlc_stream_read_frame(
+    sensirion_streaming_state* stream, struct sensirion_shdlc_rx_header* header,
+    struct sensirion_shdlc_deadline* deadline,
+    struct sensirion_shdlc_expected_response* expected) {
     uint8_t data = 0;
-    uint32_t retries = max_timeout_ms;
+    uint8_t raw_header[SHDLC_MISO_HEADER_SIZE];
+    bool correlated;
 
     // Poll for data available
-    while ((stream->stream.read(1, &data) <= 0) && (retries-- > 0)) {
-        sensirion_uart_hal_sleep_usec(1000);
+    data = sensirion_shdlc_stream_read_next_byte(stream, deadline);
+    if (stream->stream_status == 1) {
+        header->rx_timestamp_us = sensirion_uart_hal_get_time_usec();
     }
 
     // read the beginning of the frame
-    if (data != SHDLC_FRAME_DELIMITER) {
+    if (stream->stream_status != 1 || data != SHDLC_FRAME_DELIMITER) {
         return SENSIRION_SHDLC_ERR_MISSING_START;
     }
     // read the header
-    uint8_t* ptr = (uint8_t*)header;
-    for (uint8_t i = 0; i < sizeof(struct sensirion_shdlc_rx_header); i++) {
-        *ptr = sensirion_shdlc_stream_read_and_unstuff_next_byte(stream);
-        if (stream->stream_status < 0) {
+    for (uint8_t i = 0; i < SHDLC_MISO_HEADER_SIZE; i++) {
+        raw_header[i] =
+            sensirion_shdlc_stream_read_and_unstuff_next_byte(stream, deadline);
+        if (stream->stream_status != 1) {
             return SENSIRION_SHDLC_ERR_MISSING_STOP;
         }
-        ptr++;
     }
+    header->addr = raw_header[0];
+    header->cmd = raw_header[1];
+    header->state = raw_header[2];
+    header->data_len = raw_header[3];
+    correlated = header->addr == expected->address &&
+                 header->cmd == expected->command;
     // consistency check with data read from header
-    if (expected_data_length < header->data_len) {
+    if (expected->max_data_length < header->data_len) {
+        if (!correlated) {
+            /* the longer response of an earlier request */
+            expected->discarded_bytes += 1 + SHDLC_MISO_HEADER_SIZE;
+            sensirion_shdlc_stream_skip_frame(stream, deadline, expected);
+            return SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH;
+        }
         return SENSIRION_SHDLC_ERR_FRAME_TOO_LONG;
     }
     // read all data
-    while ((stream->offset < header->data_len) &&
-           (stream->stream_status >= 0)) {
-        data = sensirion_shdlc_stream_read_and_unstuff_next_byte(stream);
-        if (stream->stream_status < 0) {
+    while (stream->offset < header->data_len) {
+        data = sensirion_shdlc_stream_read_and_unstuff_next_byte(stream,
+                                                                 deadline);
+        if (stream->stream_status != 1) {
             return SENSIRION_SHDLC_ERR_MISSING_STOP;
         }
-        if (stream->stream_status == 0) {
-            if (retries == 0) {
-                return SENSIRION_SHDLC_ERR_MISSING_STOP;
-            }
-            retries--;
-            sensirion_uart_hal_sleep_usec(1000);
-            continue;
-        }
         stream->data[stream->offset++] = data;
     }
 
-    if (stream->offset < header->data_len) {
-        return SENSIRION_SHDLC_ERR_ENCODING_ERROR;
-    }
-
     // read checksum, the data byte is not needed as the checksum
     // is computed behind the scene
-    sensirion_shdlc_stream_read_and_unstuff_next_byte(stream);
+    sensirion_shdlc_stream_read_and_unstuff_next_byte(stream, deadline);
+    if (stream->stream_status != 1) {
+        return SENSIRION_SHDLC_ERR_MISSING_STOP;
+    }
+
+    // read the stop byte first, so that no byte of the frame is left behind
+    data = sensirion_shdlc_stream_read_next_byte(stream, deadline);
+    if (stream->stream_status != 1 || data != SHDLC_FRAME_DELIMITER) {
+        return SENSIRION_SHDLC_ERR_MISSING_STOP;
+    }
+
     /* (CHECKSUM + ~CHECKSUM) = 0xFF */
     if (stream->checksum != 0xFF) {
         return SENSIRION_SHDLC_ERR_CRC_MISMATCH;
     }
 
+    if (!correlated) {
+        /* start and stop, header, data and checksum */
+        expected->discarded_bytes += 2 + SHDLC_MISO_HEADER_SIZE +
+                                     header->data_len + 1;
+        return SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH;
+    }
+
     if (0x7F & header->state) {
         return SENSIRION_SHDLC_ERR_EXECUTION_FAILURE;
     }
 
-    stream->stream.read(1, &data);
-    if (data != SHDLC_FRAME_DELIMITER) {
-        return SENSIRION_SHDLC_ERR_MISSING_STOP;
+    return NO_ERROR;
+}
+
+int16_t sensirion_shdlc_read_response(sensirion_streaming_state* stream,
+                                      uint8_t expected_data_length,
+                                      struct sensirion_shdlc_rx_header* header,
+                                      uint32_t max_timeout_ms) {
+    int16_t error;
+    struct sensirion_shdlc_deadline deadline;
+    struct sensirion_shdlc_expected_response expected;
+    bool mismatched = false;
+
+    /* the request is overwritten by the response data */
+    expected.address = stream->data[SHDLC_MOSI_ADDR_POS];
+    expected.command = stream->data[SHDLC_MOSI_CMD_POS];
+    expected.max_data_length = expected_data_length;
+    expected.discarded_bytes = 0;
+    stream->stream_status = 0;
+    stream->stream.read = sensirion_shdlc_hal_rx;
+#if SENSIRION_SHDLC_ADAPTIVE_TIMEOUT
+    max_timeout_ms =
+        sensirion_shdlc_timeout_get_ms(expected.command, max_timeout_ms);
+#endif
+    deadline.start_us = sensirion_uart_hal_get_time_usec();
+    deadline.timeout_ms = max_timeout_ms;
+    deadline.polls_left = max_timeout_ms;
+    header->tx_timestamp_us = stream->tx_timestamp_us;
+
+    sensirion_shdlc_trace_begin();
+    /* skip responses which arrived late for an earlier request */
+    do {
+        stream->offset = 0;
+        stream->checksum = 0;
+        header->rx_timestamp_us = 0;
+        error = sensirion_shdlc_stream_read_frame(stream, header, &deadline,
+                                                  &expected);
+        if (error == SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH) {
+            mismatched = true;
+        }
+    } while (error == SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH);
+    /* no response of its own followed before the deadline */
+    if (mismatched && error != NO_ERROR && stream->stream_status == 0) {
+        error = SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH;
     }
 
-    return NO_ERROR;
-}
\ No newline at end of file
+    if (header->rx_timestamp_us != 0) {
+        if (header->tx_timestamp_us != 0) {
+            sensirion_shdlc_latency_record(
+                expected.command, SENSIRION_SHDLC_LATENCY_WAIT,
+                header->tx_timestamp_us, header->rx_timestamp_us);
+        }
+        sensirion_shdlc_latency_record(
+            expected.command, SENSIRION_SHDLC_LATENCY_RX,
+            header->rx_timestamp_us, sensirion_uart_hal_get_time_usec());
+    }
+    /* a wrong first byte is dropped, a deadline leaves stream_status at 0 */
+    sensirion_shdlc_counters_record(
+        expected.command, error,
+        error != NO_ERROR && stream->stream_status == 0,
+        (uint16_t)(expected.discarded_bytes +
+                   (error == SENSIRION_SHDLC_ERR_MISSING_START &&
+                    stream->stream_status == 1)));
+#if SENSIRION_SHDLC_ADAPTIVE_TIMEOUT
+    /* only complete responses and deadlines say something about the RTT */
+    if (error == NO_ERROR || stream->stream_status == 0) {
+        uint64_t end_us = sensirion_uart_hal_get_time_usec();
+
+        if (end_us != 0) {
+            sensirion_shdlc_timeout_record(expected.command,
+                                           end_us - deadline.start_us,
+                                           error != NO_ERROR);
+        }
+    }
+#endif
+    sensirion_shdlc_trace_end(SENSIRION_SHDLC_TRACE_RX, error);
+    if (shdlc_response_hook != NULL) {
+        shdlc_response_hook(expected.command, header, stream->data, error);
+    }
+    return error;
+}
+
+/*
+ * Tell whether no byte of a response to the request arrived before the
+ * deadline, or the request did not even leave completely.
+ */
+static bool sensirion_shdlc_stream_unanswered(sensirion_streaming_state* stream,
+                                              int16_t error) {
+    switch (error) {
+        case SENSIRION_SHDLC_ERR_TX_INCOMPLETE:
+            return true;
+        case SENSIRION_SHDLC_ERR_MISSING_START:
+            /* a deadline leaves stream_status at 0 */
+            return stream->stream_status == 0;
+        default:
+            return false;
+    }
+}
+
+/* time left of the budget, 0 if it is used up or there is no clock */
+static uint64_t sensirion_shdlc_remaining_us(uint64_t start_us,
+                                             uint64_t budget_us) {
+    uint64_t elapsed_us = sensirion_uart_hal_get_time_usec() - start_us;
+
+    return elapsed_us < budget_us ? budget_us - elapsed_us : 0;
+}
+
+int16_t
+sensirion_shdlc_read_response_until(sensirion_streaming_state* stream,
+                                    uint8_t expected_data_length,
+                                    struct sensirion_shdlc_rx_header* header,
+                                    uint64_t deadline_us) {
+    uint64_t now_us = sensirion_uart_hal_get_time_usec();
+    uint64_t timeout_ms = 0;
+
+    if (deadline_us > now_us) {
+        timeout_ms = (deadline_us - now_us + 999) / 1000;
+    }
+    if (timeout_ms > 0xFFFFFFFF) {
+        timeout_ms = 0xFFFFFFFF;
+    }
+    return sensirion_shdlc_read_response(stream, expected_data_length, header,
+                                         (uint32_t)timeout_ms);
+}
+
+int16_t sensirion_shdlc_transceive(sensirion_streaming_state* stream,
+                                   uint8_t expected_data_length,
+                                   struct sensirion_shdlc_rx_header* header,
+                                   uint32_t max_timeout_ms,
+                                   sensirion_shdlc_repetition repetition) {
+    struct sensirion_shdlc_retry_policy policy;
+    uint8_t request[SENSIRION_SHDLC_RETRY_MAX_REQUEST_SIZE];
+    uint16_t request_len = stream->offset;
+    uint64_t start_us = sensirion_uart_hal_get_time_usec();
+    uint64_t budget_us;
+    uint64_t remaining_us;
+    uint64_t backoff_us;
+    uint32_t timeout_ms;
+    uint8_t attempt;
+    int16_t error;
+
+    sensirion_shdlc_retry_get_policy(sensirion_uart_hal_get_selected_port(),
+                                     &policy);
+    /* the response overwrites the request, keep it for a repetition */
+    if (repetition == SENSIRION_SHDLC_ATTEMPT_ONCE ||
+        request_len > sizeof(request)) {
+        policy.max_attempts = 1;
+    } else {
+        sensirion_common_copy_bytes(stream->data, request, request_len);
+    }
+    budget_us = (uint64_t)policy.budget_ms * 1000;
+    backoff_us = (uint64_t)policy.backoff_ms * 1000;
+
+    for (attempt = 1;; attempt++) {
+        timeout_ms = max_timeout_ms;
+        if (budget_us != 0) {
+            remaining_us = sensirion_shdlc_remaining_us(start_us, budget_us);
+            if (remaining_us / 1000 < timeout_ms) {
+                timeout_ms = (uint32_t)(remaining_us / 1000);
+            }
+        }
+        error = sensirion_shdlc_write_request(stream);
+        if (error == NO_ERROR) {
+            error = sensirion_shdlc_read_response(stream, expected_data_length,
+                                                  header, timeout_ms);
+        }
+        if (error == NO_ERROR || !sensirion_shdlc_retry_is_retryable(error)) {
+            return error;
+        }
+        if (attempt >= policy.max_attempts) {
+            /* a single attempt leaves nothing to exhaust */
+            if (policy.max_attempts > 1) {
+                sensirion_shdlc_counters_count_exhausted(
+                    request[SHDLC_MOSI_CMD_POS]);
+            }
+            return error;
+        }
+        /* a sensor which answered has executed the request */
+        if (repetition == SENSIRION_SHDLC_REPEAT_UNANSWERED &&
+            !sensirion_shdlc_stream_unanswered(stream, error)) {
+            return error;
+        }
+        /* the next attempt needs at least a millisecond after the backoff */
+        if (budget_us != 0 &&
+            sensirion_shdlc_remaining_us(start_us, budget_us) <
+                backoff_us + 1000) {
+            sensirion_shdlc_counters_count_exhausted(
+                request[SHDLC_MOSI_CMD_POS]);
+            return error;
+        }
+        sensirion_uart_hal_sleep_usec((uint32_t)backoff_us);
+        if (backoff_us < SHDLC_MAX_BACKOFF_US) {
+            backoff_us *= 2;
+        }
+        sensirion_common_copy_bytes(request, stream->data, request_len);
+        stream->offset = request_len;
+        stream->checksum = 0;
+        stream->stream_status = 0;
+        sensirion_shdlc_counters_count_retry(request[SHDLC_MOSI_CMD_POS]);
+    }
+}
@@ -37,6 +37,7 @@
 
 #include "sensirion_common.h"
 #include "sensirion_shdlc.h"
+#include "sensirion_shdlc_retry.h"
 #include "sensirion_streaming.h"
 
 #ifdef __cplusplus
@@ -89,6 +90,101 @@ int16_t sensirion_shdlc_read_response(sensirion_streaming_state* stream,
                                       struct sensirion_shdlc_rx_header* header,
                                       uint32_t max_timeout_ms);
 
+/**
+ * sensirion_shdlc_read_response_until() - Receive data from the slave until
+ *                                         an absolute deadline.
+ *
+ * Used to collect the responses of requests sent to several ports before
+ * reading the first response, so that all ports share one deadline. Once the
+ * deadline has passed, only a response which has already arrived is read.
+ *
+ * @note The header and data must be discarded on failure
+ *
+ * @param stream               Data structure holding the request, the
+ *                             response is stored in it.
+ * @param expected_data_length Expected data amount to receive.
+ * @param header               Memory where the SHDLC header of the response
+ *                             is stored.
+ * @param deadline_us          Deadline in sensirion_uart_hal_get_time_usec()
+ *                             time.
+ *
+ * @return            NO_ERROR on success, an error code otherwise
+ */
+int16_t
+sensirion_shdlc_read_response_until(sensirion_streaming_state* stream,
+                                    uint8_t expected_data_length,
+                                    struct sensirion_shdlc_rx_header* header,
+                                    uint64_t deadline_us);
+
+/**
+ * sensirion_shdlc_transceive() - Transmit the SHDLC request and receive the
+ *                                response, repeating the transaction if it
+ *                                failed on the wire.
+ *
+ * The transaction is repeated according to the retry policy of the selected
+ * port and the repetition the command allows, see sensirion_shdlc_retry.h.
+ *
+ * @note The header and data must be discarded on failure
+ *
+ * @param stream               Data structure holding the request, the
+ *                             response is stored in it.
+ * @param expected_data_length Expected data amount to receive.
+ * @param header               Memory where the SHDLC header of the response
+ *                             is stored.
+ * @param max_timeout_ms       Timeout of each attempt in milliseconds.
+ * @param repetition           Whether the request may be repeated after
+ *                             any link error, only if the sensor did not
+ *                             answer at all or never.
+ *
+ * @return            NO_ERROR on success, an error code otherwise
+ */
+int16_t sensirion_shdlc_transceive(sensirion_streaming_state* stream,
+                                   uint8_t expected_data_length,
+                                   struct sensirion_shdlc_rx_header* header,
+                                   uint32_t max_timeout_ms,
+                                   sensirion_shdlc_repetition repetition);
+
+/**
+ * Hook invoked by sensirion_shdlc_write_request() before a request is sent.
+ * It must not call into the driver.
+ *
+ * @param command     Command of the request
+ * @param data        Arguments of the request
+ * @param data_length Number of argument bytes
+ *
+ * @return NO_ERROR to send the request, the error code the request fails
+ *         with otherwise
+ */
+typedef int16_t (*sensirion_shdlc_request_hook)(uint8_t command,
+                                                const uint8_t* data,
+                                                uint8_t data_length);
+
+/**
+ * Hook invoked by sensirion_shdlc_read_response() with the outcome of every
+ * transaction. It must not call into the driver.
+ *
+ * @param command Command of the request
+ * @param header  Header of the response, only valid on success
+ * @param data    Data of the response, only valid on success
+ * @param error   NO_ERROR or the error the transaction failed with
+ */
+typedef void (*sensirion_shdlc_response_hook)(
+    uint8_t command, const struct sensirion_shdlc_rx_header* header,
+    const uint8_t* data, int16_t error);
+
+/**
+ * sensirion_shdlc_set_hooks() - Register the hooks the driver add-ons use to
+ *                               follow the commands of all ports.
+ *
+ * The hooks see the transactions of the streaming SHDLC functions, which all
+ * sensor commands use. Register them before the first transaction.
+ *
+ * @param request_hook  Function called before every request, may be NULL
+ * @param response_hook Function called after every response, may be NULL
+ */
+void sensirion_shdlc_set_hooks(sensirion_shdlc_request_hook request_hook,
+                               sensirion_shdlc_response_hook response_hook);
+
 #ifdef __cplusplus
 }
 #endif
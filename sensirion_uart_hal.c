@@ -48,11 +48,23 @@
  *
  * Return:      0 on success, an error code otherwise
  */
-int16_t sensirion_uart_hal_select_port(uint8_t port) {
+int16_t sensirion_uart_hal_select_port(uint16_t port) {
     /* TODO: implement */
     return NOT_IMPLEMENTED_ERROR;
 }
 
+/**
+ * sensirion_uart_hal_get_selected_port() - get the selected UART port index
+ *                                THE IMPLEMENTATION IS OPTIONAL ON SINGLE-PORT
+ *                                SETUPS (only one SPS30)
+ *
+ * Return:      the selected port index
+ */
+uint16_t sensirion_uart_hal_get_selected_port(void) {
+    /* TODO: implement */
+    return 0;
+}
+
 /**
  * sensirion_uart_hal_init() - initialize UART
  *
@@ -88,6 +100,13 @@ int16_t sensirion_uart_hal_tx(uint16_t data_len, const uint8_t* data) {
 /**
  * sensirion_uart_hal_rx() - receive data over UART
  *
+ * Return the bytes received so far without waiting for more. If nothing was
+ * received, return 0 right away: the SHDLC layer enforces the response
+ * deadlines itself and discards stale bytes before every request by reading
+ * until less than max_data_len bytes are returned. A read which blocks until
+ * max_data_len bytes arrived stalls the driver, unless the HAL implements
+ * sensirion_uart_hal_wait_rx_usec().
+ *
  * @data_len:   max number of bytes to receive
  * @data:       Memory where received data is stored
  * Return:      Number of bytes received or a negative error code
@@ -97,6 +116,18 @@ int16_t sensirion_uart_hal_rx(uint16_t max_data_len, uint8_t* data) {
     return NOT_IMPLEMENTED_ERROR;
 }
 
+/**
+ * sensirion_uart_hal_wait_rx_usec() - wait until data can be received
+ *                                     THE IMPLEMENTATION IS OPTIONAL
+ *
+ * Return:      1 if data is available, 0 on timeout, NOT_IMPLEMENTED_ERROR if
+ *              the HAL cannot wait for data
+ */
+int16_t sensirion_uart_hal_wait_rx_usec(uint32_t timeout_us) {
+    /* TODO: implement */
+    return NOT_IMPLEMENTED_ERROR;
+}
+
 /**
  * Sleep for a given number of microseconds. The function should delay the
  * execution for at least the given time, but may also sleep longer.
@@ -108,3 +139,16 @@ int16_t sensirion_uart_hal_rx(uint16_t max_data_len, uint8_t* data) {
 void sensirion_uart_hal_sleep_usec(uint32_t useconds) {
     /* TODO: implement */
 }
+
+/**
+ * Return the current time of a monotonic clock in microseconds. The epoch is
+ * arbitrary, but the clock must never jump backwards.
+ *
+ * If no clock is available, return 0.
+ *
+ * @return monotonic time in microseconds
+ */
+uint64_t sensirion_uart_hal_get_time_usec(void) {
+    /* TODO: implement */
+    return 0;
+}
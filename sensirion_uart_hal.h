@@ -39,6 +39,27 @@
 extern "C" {
 #endif
 
+/**
+ * sensirion_uart_hal_select_port() - select the UART port index to use
+ *                                    THE IMPLEMENTATION IS OPTIONAL ON
+ *                                    SINGLE-PORT SETUPS (only one SPS30)
+ *
+ * All subsequent HAL calls operate on the selected port. The port index also
+ * identifies the device in the per-device statistics of the SHDLC layer.
+ *
+ * @port:       port index, smaller than SENSIRION_UART_MAX_PORTS
+ * Return:      0 on success, an error code otherwise
+ */
+int16_t sensirion_uart_hal_select_port(uint16_t port);
+
+/**
+ * sensirion_uart_hal_get_selected_port() - get the selected UART port index
+ *
+ * Return:      the port index selected with sensirion_uart_hal_select_port(),
+ *              0 on single-port setups
+ */
+uint16_t sensirion_uart_hal_get_selected_port(void);
+
 /**
  * sensirion_uart_hal_init() - initialize UART
  *
@@ -68,12 +89,34 @@ int16_t sensirion_uart_hal_tx(uint16_t data_len, const uint8_t* data);
 /**
  * sensirion_uart_hal_rx() - receive data over UART
  *
+ * Return the bytes received so far without waiting for more. If nothing was
+ * received, return 0 right away: the SHDLC layer enforces the response
+ * deadlines itself and discards stale bytes before every request by reading
+ * until less than max_data_len bytes are returned. A read which blocks until
+ * max_data_len bytes arrived stalls the driver, unless the HAL implements
+ * sensirion_uart_hal_wait_rx_usec().
+ *
  * @data_len:   max number of bytes to receive
  * @data:       Memory where received data is stored
  * Return:      Number of bytes received or a negative error code
  */
 int16_t sensirion_uart_hal_rx(uint16_t max_data_len, uint8_t* data);
 
+/**
+ * sensirion_uart_hal_wait_rx_usec() - wait until data can be received
+ *                                     THE IMPLEMENTATION IS OPTIONAL
+ *
+ * Block until sensirion_uart_hal_rx() would return data or the timeout has
+ * elapsed. While waiting for a response, the SHDLC layer calls this instead
+ * of sleeping between reads, so implementing it removes the poll interval
+ * from the response latency.
+ *
+ * @timeout_us: maximum time to wait in microseconds
+ * Return:      1 if data is available, 0 on timeout, NOT_IMPLEMENTED_ERROR if
+ *              the HAL cannot wait for data
+ */
+int16_t sensirion_uart_hal_wait_rx_usec(uint32_t timeout_us);
+
 /**
  * Sleep for a given number of microseconds. The function should delay the
  * execution for at least the given time, but may also sleep longer.
@@ -84,6 +127,19 @@ int16_t sensirion_uart_hal_rx(uint16_t max_data_len, uint8_t* data);
  */
 void sensirion_uart_hal_sleep_usec(uint32_t useconds);
 
+/**
+ * Return the current time of a monotonic clock in microseconds. The epoch is
+ * arbitrary, but the clock must never jump backwards (e.g. it must not follow
+ * adjustments of the wall clock).
+ *
+ * The SHDLC layer uses this clock for response deadlines and to timestamp
+ * received frames. If no clock is available, return 0; the deadlines then
+ * fall back to counting sleeps.
+ *
+ * @return monotonic time in microseconds
+ */
+uint64_t sensirion_uart_hal_get_time_usec(void);
+
 #ifdef __cplusplus
 }
 #endif
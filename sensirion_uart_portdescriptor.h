@@ -42,6 +42,11 @@ typedef const char* UartDescr;
 // definition of default port
 #define SERIAL_0 "/dev/ttyUSB0"
 
+// number of ports that can be selected with sensirion_uart_hal_select_port()
+#ifndef SENSIRION_UART_MAX_PORTS
+#define SENSIRION_UART_MAX_PORTS 1
+#endif
+
 // definition of serial port when connecting over UART pins
 // make sure to enable serial port in raspi-config
 // #define SERIAL_0 "/dev/serial0"
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_cleaning.c
+ */
+#include "sps30_cleaning.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_config.h"
+#include "sps30_uart.h"
+
+struct sps30_cleaning_port {
+    bool counting;                 //< the interval counter was started
+    uint64_t last_automatic_us;    //< start of the counter or last cleaning
+    uint32_t schedule_interval_s;  //< host scheduled cleanings, 0 for none
+    struct sps30_cleaning_status status;
+};
+
+static struct sps30_cleaning_port cleaning_table[SENSIRION_UART_MAX_PORTS];
+
+static uint64_t sps30_cleaning_interval_us(uint16_t port) {
+    struct sps30_config config;
+
+    if (sps30_config_get(port, &config) != NO_ERROR) {
+        return (uint64_t)SPS30_CLEANING_DEFAULT_INTERVAL_S * 1000000;
+    }
+    return (uint64_t)config.auto_cleaning_interval_s * 1000000;
+}
+
+static void sps30_cleaning_open(struct sps30_cleaning_port* cleaning,
+                                uint64_t start_us, bool automatic) {
+    cleaning->status.window_start_us = start_us;
+    cleaning->status.window_end_us =
+        start_us + (uint64_t)SPS30_CLEANING_DURATION_MS * 1000;
+    cleaning->status.automatic = automatic;
+    if (automatic) {
+        cleaning->status.automatic_cleanings++;
+    } else {
+        cleaning->status.manual_cleanings++;
+    }
+}
+
+/* open the window of an automatic cleaning which fell due */
+static void sps30_cleaning_update(uint16_t port, uint64_t now_us) {
+    struct sps30_cleaning_port* cleaning = &cleaning_table[port];
+    uint64_t interval_us = sps30_cleaning_interval_us(port);
+    uint64_t next_us;
+
+    if (!cleaning->counting || interval_us == 0) {
+        cleaning->status.next_automatic_us = 0;
+        return;
+    }
+    next_us = cleaning->last_automatic_us + interval_us;
+    if (cleaning->status.measuring && next_us <= now_us) {
+        /* of several missed cleanings only the last may still run */
+        next_us += (now_us - next_us) / interval_us * interval_us;
+        sps30_cleaning_open(cleaning, next_us, true);
+        cleaning->last_automatic_us = next_us;
+        next_us += interval_us;
+    }
+    cleaning->status.next_automatic_us = next_us;
+}
+
+uint32_t sps30_cleaning_get_remaining_ms(void) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    uint64_t now_us = sensirion_uart_hal_get_time_usec();
+    const struct sps30_cleaning_status* status;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return 0;
+    }
+    sps30_cleaning_update(port, now_us);
+    status = &cleaning_table[port].status;
+    if (now_us < status->window_start_us || now_us >= status->window_end_us) {
+        return 0;
+    }
+    return (uint32_t)((status->window_end_us - now_us + 999) / 1000);
+}
+
+bool sps30_cleaning_is_active(void) {
+    return sps30_cleaning_get_remaining_ms() > 0;
+}
+
+int16_t sps30_cleaning_get_status(uint16_t port,
+                                  struct sps30_cleaning_status* status) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    sps30_cleaning_update(port, sensirion_uart_hal_get_time_usec());
+    *status = cleaning_table[port].status;
+    return NO_ERROR;
+}
+
+int16_t sps30_cleaning_stagger(const uint16_t* ports, uint16_t count,
+                               uint32_t interval_s) {
+    uint64_t now_us = sensirion_uart_hal_get_time_usec();
+    uint64_t interval_us = (uint64_t)interval_s * 1000000;
+    struct sps30_cleaning_port* cleaning;
+    int16_t error = NO_ERROR;
+    uint16_t i;
+
+    for (i = 0; i < count; i++) {
+        if (ports[i] >= SENSIRION_UART_MAX_PORTS) {
+            error = SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+            continue;
+        }
+        cleaning = &cleaning_table[ports[i]];
+        cleaning->schedule_interval_s = interval_s;
+        cleaning->status.next_scheduled_us = 0;
+        if (interval_s != 0) {
+            cleaning->status.next_scheduled_us =
+                now_us + interval_us * (i + 1) / count;
+        }
+    }
+    return error;
+}
+
+int16_t sps30_cleaning_poll(void) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    uint64_t now_us = sensirion_uart_hal_get_time_usec();
+    struct sps30_cleaning_port* cleaning;
+    uint64_t interval_us;
+    int16_t error;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    cleaning = &cleaning_table[port];
+    if (cleaning->status.next_scheduled_us == 0 ||
+        !cleaning->status.measuring ||
+        now_us < cleaning->status.next_scheduled_us) {
+        return NO_ERROR;
+    }
+    error = sps30_start_fan_cleaning();
+    if (error != NO_ERROR) {
+        return error;
+    }
+    /* keep the phase, so the sensors of the fleet stay staggered */
+    interval_us = (uint64_t)cleaning->schedule_interval_s * 1000000;
+    while (cleaning->status.next_scheduled_us <= now_us) {
+        cleaning->status.next_scheduled_us += interval_us;
+    }
+    return NO_ERROR;
+}
+
+void sps30_cleaning_invalidate(uint16_t port) {
+    struct sps30_cleaning_port cleared = {false};
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    cleaning_table[port] = cleared;
+}
+
+void sps30_cleaning_measurement_started(void) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    uint64_t now_us = sensirion_uart_hal_get_time_usec();
+    struct sps30_cleaning_port* cleaning;
+    uint64_t interval_us;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    cleaning = &cleaning_table[port];
+    interval_us = sps30_cleaning_interval_us(port);
+    if (!cleaning->counting) {
+        cleaning->counting = true;
+        cleaning->last_automatic_us = now_us;
+    } else if (!cleaning->status.measuring && interval_us != 0 &&
+               cleaning->last_automatic_us + interval_us <= now_us) {
+        /* the cleaning fell due while idle and runs now */
+        sps30_cleaning_open(cleaning, now_us, true);
+        cleaning->last_automatic_us = now_us;
+    }
+    cleaning->status.measuring = true;
+    sps30_cleaning_update(port, now_us);
+}
+
+void sps30_cleaning_measurement_stopped(void) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    sps30_cleaning_update(port, sensirion_uart_hal_get_time_usec());
+    cleaning_table[port].status.measuring = false;
+}
+
+void sps30_cleaning_fan_cleaning_started(void) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    sps30_cleaning_open(&cleaning_table[port],
+                        sensirion_uart_hal_get_time_usec(), false);
+}
+
+void sps30_cleaning_device_reset(void) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    cleaning_table[port].counting = false;
+    cleaning_table[port].status.measuring = false;
+    cleaning_table[port].status.next_automatic_us = 0;
+}
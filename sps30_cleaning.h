@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_cleaning.h
+ *
+ *  Fan cleaning windows of the SPS30 on every UART port. While the fan
+ *  cleans, for about SPS30_CLEANING_DURATION_MS, the measurement values are
+ *  not meaningful. The module knows the windows of manual cleanings started
+ *  with sps30_start_fan_cleaning() and predicts the automatic ones from the
+ *  auto cleaning interval cached by sps30_config.h, or the default interval
+ *  of one week if it was never read. An interval of 0 disables the
+ *  prediction.
+ *
+ *  The prediction assumes that the interval counter of the sensor starts
+ *  with the first measurement seen on the port, restarts with
+ *  sps30_device_reset(), and that a cleaning which fell due while the sensor
+ *  was idle runs as soon as the measurement is started again.
+ *
+ *  Applications skip reading during a window with sps30_cleaning_is_active()
+ *  or sleep for sps30_cleaning_get_remaining_ms(), and sps30_duty_cycle.h
+ *  postpones its samples to the end of the window.
+ *
+ *  Sensors of a fleet cleaning at the same time leave it blind for that
+ *  time. sps30_cleaning_stagger() spreads host scheduled manual cleanings
+ *  evenly over the interval, which sps30_cleaning_poll() then starts. The
+ *  automatic cleaning of these sensors should be disabled by reconciling
+ *  their auto cleaning interval to 0, see sps30_config_reconcile_fleet().
+ *
+ *  All functions must be called from the thread performing the
+ *  transactions of the port.
+ */
+#ifndef SPS30_CLEANING_H
+#define SPS30_CLEANING_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Time the fan cleaning takes, 10 s according to the datasheet */
+#ifndef SPS30_CLEANING_DURATION_MS
+#define SPS30_CLEANING_DURATION_MS 10000
+#endif
+
+/** Auto cleaning interval of a sensor whose interval was never read */
+#define SPS30_CLEANING_DEFAULT_INTERVAL_S 604800
+
+struct sps30_cleaning_status {
+    bool measuring;                //< a measurement runs, the fan is on
+    bool automatic;                //< the last window was predicted
+    uint64_t window_start_us;      //< start of the last window, HAL clock
+    uint64_t window_end_us;        //< end of the last window, 0 if none
+    uint64_t next_automatic_us;    //< predicted cleaning, 0 if unknown
+    uint64_t next_scheduled_us;    //< host scheduled cleaning, 0 if none
+    uint32_t manual_cleanings;     //< cleanings started by a command
+    uint32_t automatic_cleanings;  //< cleanings predicted
+};
+
+/**
+ * sps30_cleaning_is_active() - Check whether the fan of the sensor on the
+ *                              selected port is cleaning.
+ *
+ * @return true within a cleaning window, false otherwise
+ */
+bool sps30_cleaning_is_active(void);
+
+/**
+ * sps30_cleaning_get_remaining_ms() - Time until the cleaning window of the
+ *                                     selected port ends.
+ *
+ * @return Milliseconds until the end of the window, 0 if it is not cleaning
+ */
+uint32_t sps30_cleaning_get_remaining_ms(void);
+
+/**
+ * sps30_cleaning_get_status() - Read the cleaning windows of a port.
+ *
+ * @param port   UART port index
+ * @param status Memory where the status is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port.
+ */
+int16_t sps30_cleaning_get_status(uint16_t port,
+                                  struct sps30_cleaning_status* status);
+
+/**
+ * sps30_cleaning_stagger() - Schedule manual cleanings of several sensors
+ *                            evenly spread over the interval.
+ *
+ * The sensor on ports[i] first cleans after (i + 1) / count of the
+ * interval and then every interval. An interval of 0 removes the schedule.
+ *
+ * @param ports      UART port indices of the sensors
+ * @param count      Number of ports
+ * @param interval_s Cleaning interval of every sensor in seconds
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT if a
+ *         port is invalid. The valid ports are scheduled even then.
+ */
+int16_t sps30_cleaning_stagger(const uint16_t* ports, uint16_t count,
+                               uint32_t interval_s);
+
+/**
+ * sps30_cleaning_poll() - Start the scheduled cleaning of the selected port
+ *                         if it is due.
+ *
+ * A cleaning which falls due while the sensor does not measure is started
+ * with the first poll during the next measurement.
+ *
+ * @return NO_ERROR if no cleaning was due or it was started,
+ *         SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an invalid port, an error
+ *         code of sps30_start_fan_cleaning() otherwise.
+ */
+int16_t sps30_cleaning_poll(void);
+
+/**
+ * sps30_cleaning_invalidate() - Forget the windows and the schedule of a
+ *                               port, e.g. after a different sensor was
+ *                               connected.
+ *
+ * @param port UART port index
+ */
+void sps30_cleaning_invalidate(uint16_t port);
+
+/**
+ * sps30_cleaning_measurement_started() - Remember that the selected port
+ *                                        measures.
+ *
+ * This is called through sps30_hooks.h when sps30_start_measurement() succeeds.
+ */
+void sps30_cleaning_measurement_started(void);
+
+/**
+ * sps30_cleaning_measurement_stopped() - Remember that the selected port does
+ *                                        not measure.
+ *
+ * This is called through sps30_hooks.h when sps30_stop_measurement() succeeds.
+ */
+void sps30_cleaning_measurement_stopped(void);
+
+/**
+ * sps30_cleaning_fan_cleaning_started() - Open a cleaning window on the
+ *                                         selected port.
+ *
+ * This is called through sps30_hooks.h when sps30_start_fan_cleaning()
+ * succeeds.
+ */
+void sps30_cleaning_fan_cleaning_started(void);
+
+/**
+ * sps30_cleaning_device_reset() - Restart the interval counter of the
+ *                                 selected port.
+ *
+ * This is called through sps30_hooks.h when sps30_device_reset() succeeds.
+ */
+void sps30_cleaning_device_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_CLEANING_H
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_config.c
+ */
+#include "sps30_config.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_streaming_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_uart.h"
+
+#define SPS30_CONFIG_CMD_AUTO_CLEANING_INTERVAL 0x80
+
+struct sps30_config_port {
+    bool valid;  //< false until the configuration was read or written
+    struct sps30_config config;
+};
+
+static struct sps30_config_port config_table[SENSIRION_UART_MAX_PORTS];
+
+/* the write request and room for the protocol header */
+static uint8_t config_buffer[5 + 4];
+
+int16_t sps30_config_reconcile(const struct sps30_config* desired,
+                               struct sps30_config_result* result) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    struct sps30_config_port* entry;
+    uint32_t interval;
+    int16_t error;
+
+    result->outcome = SPS30_CONFIG_FAILED;
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        result->error = SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+        return result->error;
+    }
+    entry = &config_table[port];
+    if (!entry->valid) {
+        error = sps30_read_auto_cleaning_interval(&interval);
+        if (error != NO_ERROR) {
+            result->error = error;
+            return error;
+        }
+        entry->config.auto_cleaning_interval_s = interval;
+        entry->valid = true;
+    }
+    result->error = NO_ERROR;
+    if (entry->config.auto_cleaning_interval_s ==
+        desired->auto_cleaning_interval_s) {
+        result->outcome = SPS30_CONFIG_UNCHANGED;
+        return NO_ERROR;
+    }
+    error = sps30_write_auto_cleaning_interval(
+        desired->auto_cleaning_interval_s);
+    if (error != NO_ERROR) {
+        result->error = error;
+        return error;
+    }
+    result->outcome = SPS30_CONFIG_WRITTEN;
+    return NO_ERROR;
+}
+
+static void sps30_config_begin(sensirion_streaming_state* stream, bool write,
+                               uint32_t interval) {
+    sensirion_shdlc_begin_stream(stream, config_buffer,
+                                 SPS30_CONFIG_CMD_AUTO_CLEANING_INTERVAL,
+                                 SPS30_SHDLC_ADDR, write ? 5 : 1);
+    sensirion_add_uint8_t_argument(stream, 0);
+    if (write) {
+        sensirion_add_uint32_t_argument(stream, interval);
+    }
+}
+
+/* a port is read if its configuration is unknown, written on a mismatch */
+static bool sps30_config_is_due(const struct sps30_config_port* entry,
+                                const struct sps30_config_result* result,
+                                bool write, uint32_t interval) {
+    if (result->outcome == SPS30_CONFIG_FAILED) {
+        return false;
+    }
+    if (!write) {
+        return !entry->valid;
+    }
+    return entry->valid && entry->config.auto_cleaning_interval_s != interval;
+}
+
+/*
+ * Send the read or write request to all ports which are due, then collect
+ * the responses against one deadline and update the cache.
+ */
+static void sps30_config_round(const uint16_t* ports, uint16_t count,
+                               uint32_t interval, uint32_t timeout_ms,
+                               bool write,
+                               struct sps30_config_result* results) {
+    struct sensirion_shdlc_rx_header header;
+    sensirion_streaming_state stream;
+    struct sps30_config_port* entry;
+    uint64_t deadline_us;
+    uint16_t i;
+    int16_t error;
+
+    for (i = 0; i < count; i++) {
+        if (!sps30_config_is_due(&config_table[ports[i]], &results[i], write,
+                                 interval)) {
+            continue;
+        }
+        sensirion_uart_hal_select_port(ports[i]);
+        sps30_config_begin(&stream, write, interval);
+        error = sensirion_shdlc_write_request(&stream);
+        if (error != NO_ERROR) {
+            results[i].outcome = SPS30_CONFIG_FAILED;
+            results[i].error = error;
+        }
+    }
+    deadline_us =
+        sensirion_uart_hal_get_time_usec() + (uint64_t)timeout_ms * 1000;
+    for (i = 0; i < count; i++) {
+        entry = &config_table[ports[i]];
+        if (!sps30_config_is_due(entry, &results[i], write, interval)) {
+            continue;
+        }
+        sensirion_uart_hal_select_port(ports[i]);
+        sps30_config_begin(&stream, write, interval);
+        error = sensirion_shdlc_read_response_until(&stream, write ? 0 : 4,
+                                                    &header, deadline_us);
+        if (error != NO_ERROR) {
+            results[i].outcome = SPS30_CONFIG_FAILED;
+            results[i].error = error;
+            continue;
+        }
+        if (write) {
+            entry->config.auto_cleaning_interval_s = interval;
+            results[i].outcome = SPS30_CONFIG_WRITTEN;
+        } else {
+            entry->config.auto_cleaning_interval_s =
+                sensirion_common_bytes_to_uint32_t(config_buffer);
+            entry->valid = true;
+        }
+    }
+}
+
+uint16_t sps30_config_reconcile_fleet(const uint16_t* ports, uint16_t count,
+                                      const struct sps30_config* desired,
+                                      uint32_t timeout_ms,
+                                      struct sps30_config_result* results) {
+    uint16_t selected = sensirion_uart_hal_get_selected_port();
+    uint16_t failed = 0;
+    uint16_t i;
+
+    for (i = 0; i < count; i++) {
+        results[i].outcome = SPS30_CONFIG_UNCHANGED;
+        results[i].error = NO_ERROR;
+        if (ports[i] >= SENSIRION_UART_MAX_PORTS) {
+            results[i].outcome = SPS30_CONFIG_FAILED;
+            results[i].error = SENSIRION_SHDLC_ERR_NO_DATA;
+        }
+    }
+    /* the write round skips ports whose configuration could not be read */
+    sps30_config_round(ports, count, desired->auto_cleaning_interval_s,
+                       timeout_ms, false, results);
+    sps30_config_round(ports, count, desired->auto_cleaning_interval_s,
+                       timeout_ms, true, results);
+    for (i = 0; i < count; i++) {
+        if (results[i].outcome == SPS30_CONFIG_FAILED) {
+            failed++;
+        }
+    }
+    sensirion_uart_hal_select_port(selected);
+    return failed;
+}
+
+int16_t sps30_config_get(uint16_t port, struct sps30_config* config) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    if (!config_table[port].valid) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    *config = config_table[port].config;
+    return NO_ERROR;
+}
+
+void sps30_config_invalidate(uint16_t port) {
+    if (port < SENSIRION_UART_MAX_PORTS) {
+        config_table[port].valid = false;
+    }
+}
+
+void sps30_config_auto_cleaning_interval_written(
+    uint32_t auto_cleaning_interval_s) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    config_table[port].config.auto_cleaning_interval_s =
+        auto_cleaning_interval_s;
+    config_table[port].valid = true;
+}
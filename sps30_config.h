@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_config.h
+ *
+ *  Desired-state configuration of the SPS30. Instead of writing the
+ *  configuration at every start, it is compared with the configuration of
+ *  the sensor and only written on a mismatch, which saves a round trip and a
+ *  write to the non-volatile memory of the sensor.
+ *
+ *  The configuration of every port is cached after it was read or written.
+ *  The cache is also needed for correctness: until its next reset, the
+ *  sensor reports the previous auto cleaning interval after a new one was
+ *  written, so only the cache knows the value in effect.
+ */
+#ifndef SPS30_CONFIG_H
+#define SPS30_CONFIG_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sps30_config {
+    uint32_t auto_cleaning_interval_s;
+};
+
+typedef enum {
+    SPS30_CONFIG_UNCHANGED = 0,  //< the sensor had the desired configuration
+    SPS30_CONFIG_WRITTEN,        //< the desired configuration was written
+    SPS30_CONFIG_FAILED,         //< reading or writing failed
+} sps30_config_outcome;
+
+struct sps30_config_result {
+    sps30_config_outcome outcome;
+    int16_t error;  //< error code if the outcome is SPS30_CONFIG_FAILED
+};
+
+/**
+ * sps30_config_reconcile() - Bring the sensor on the selected port to the
+ *                            desired configuration.
+ *
+ * @param desired Desired configuration
+ * @param result  Memory where the result is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT if the
+ *         selected port is invalid, an error code of the failed command
+ *         otherwise
+ */
+int16_t sps30_config_reconcile(const struct sps30_config* desired,
+                               struct sps30_config_result* result);
+
+/**
+ * sps30_config_reconcile_fleet() - Bring the sensors on several ports to the
+ *                                  desired configuration.
+ *
+ * The requests are sent to all ports before the responses are collected
+ * against one common deadline, so reading and writing take about one round
+ * trip each for the whole fleet. Failed transactions are not repeated, the
+ * call can be repeated instead. The selected port of the UART HAL is not
+ * changed.
+ *
+ * @param ports      UART port indices of the sensors
+ * @param count      Number of ports
+ * @param desired    Desired configuration of all sensors
+ * @param timeout_ms Response timeout of each round, e.g.
+ *                   SPS30_AUTO_CLEANING_INTERVAL_TIMEOUT_MS
+ * @param results    Memory where the result of each port is stored
+ *
+ * @return Number of ports which failed
+ */
+uint16_t sps30_config_reconcile_fleet(const uint16_t* ports, uint16_t count,
+                                      const struct sps30_config* desired,
+                                      uint32_t timeout_ms,
+                                      struct sps30_config_result* results);
+
+/**
+ * sps30_config_get() - Read the cached configuration of a port.
+ *
+ * @param port   UART port index
+ * @param config Memory where the configuration is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port, SENSIRION_SHDLC_ERR_NO_DATA if the configuration was
+ *         neither read nor written yet.
+ */
+int16_t sps30_config_get(uint16_t port, struct sps30_config* config);
+
+/**
+ * sps30_config_invalidate() - Forget the cached configuration of a port, e.g.
+ *                             after a different sensor was connected.
+ *
+ * @param port UART port index
+ */
+void sps30_config_invalidate(uint16_t port);
+
+/**
+ * sps30_config_auto_cleaning_interval_written() - Cache the auto cleaning
+ *                                                 interval of the selected
+ *                                                 port.
+ *
+ * This is called through sps30_hooks.h when
+ * sps30_write_auto_cleaning_interval() succeeds.
+ *
+ * @param auto_cleaning_interval_s Interval written to the sensor
+ */
+void sps30_config_auto_cleaning_interval_written(
+    uint32_t auto_cleaning_interval_s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_CONFIG_H
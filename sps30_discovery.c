@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_discovery.c
+ */
+#include "sps30_discovery.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_streaming_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_cleaning.h"
+#include "sps30_config.h"
+#include "sps30_identity.h"
+#include "sps30_uart.h"
+
+#define SPS30_DISCOVERY_CMD_DEVICE_INFORMATION 0xd0
+#define SPS30_DISCOVERY_PRODUCT_TYPE_INFO 0
+#define SPS30_DISCOVERY_SERIAL_NUMBER_INFO 3
+
+/* the longest answer, the serial number, and room for the protocol header */
+static uint8_t discovery_buffer[32 + 4];
+
+static void sps30_discovery_begin(sensirion_streaming_state* stream,
+                                  uint8_t info) {
+    sensirion_shdlc_begin_stream(stream, discovery_buffer,
+                                 SPS30_DISCOVERY_CMD_DEVICE_INFORMATION,
+                                 SPS30_SHDLC_ADDR, 1);
+    sensirion_add_uint8_t_argument(stream, info);
+}
+
+/* send the request for the device information to the selected port */
+static int16_t sps30_discovery_request(uint8_t info) {
+    sensirion_streaming_state stream;
+
+    sps30_discovery_begin(&stream, info);
+    return sensirion_shdlc_write_request(&stream);
+}
+
+/* collect the answer of the selected port until the common deadline */
+static int16_t sps30_discovery_response(uint8_t info, uint8_t length,
+                                        uint64_t deadline_us, int8_t* data) {
+    struct sensirion_shdlc_rx_header header;
+    sensirion_streaming_state stream;
+    uint8_t data_length;
+    int16_t error;
+
+    sps30_discovery_begin(&stream, info);
+    error = sensirion_shdlc_read_response_until(&stream, length, &header,
+                                                deadline_us);
+    if (error != NO_ERROR) {
+        return error;
+    }
+    data_length = header.data_len < length ? header.data_len : length;
+    sensirion_common_copy_bytes(discovery_buffer, (uint8_t*)data, data_length);
+    /* the sensor terminates the string, a foreign device may not */
+    data[data_length < length ? data_length : length - 1] = 0;
+    return NO_ERROR;
+}
+
+static bool sps30_discovery_is_sps30(const int8_t* product_type) {
+    const char* expected = SPS30_DISCOVERY_PRODUCT_TYPE;
+    uint16_t i;
+
+    for (i = 0; expected[i] != '\0'; i++) {
+        if (product_type[i] != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int16_t sps30_discovery_scan(const UartDescr* paths, uint16_t count,
+                             uint16_t first_port, uint32_t timeout_ms,
+                             struct sps30_discovery_device* devices,
+                             uint16_t max_devices) {
+    struct sps30_discovery_device* device;
+    uint16_t selected = sensirion_uart_hal_get_selected_port();
+    uint64_t deadline_us;
+    uint16_t found = 0;
+    uint16_t port;
+    uint16_t i;
+
+    if (first_port >= SENSIRION_UART_MAX_PORTS ||
+        count > SENSIRION_UART_MAX_PORTS - first_port) {
+        return -1;
+    }
+
+    /* round 1: ask every port for its product type */
+    for (i = 0; i < count; i++) {
+        port = (uint16_t)(first_port + i);
+        /* another sensor may have been connected since */
+        sps30_identity_invalidate(port);
+        sps30_config_invalidate(port);
+        sps30_cleaning_invalidate(port);
+        sensirion_uart_hal_select_port(port);
+        if (sensirion_uart_hal_init(paths[i]) == NO_ERROR &&
+            sps30_discovery_request(SPS30_DISCOVERY_PRODUCT_TYPE_INFO) !=
+                NO_ERROR) {
+            sensirion_uart_hal_free();
+        }
+    }
+    deadline_us =
+        sensirion_uart_hal_get_time_usec() + (uint64_t)timeout_ms * 1000;
+    for (i = 0; i < count; i++) {
+        port = (uint16_t)(first_port + i);
+        sensirion_uart_hal_select_port(port);
+        if (found == max_devices) {
+            sensirion_uart_hal_free();
+            continue;
+        }
+        device = &devices[found];
+        if (sps30_discovery_response(
+                SPS30_DISCOVERY_PRODUCT_TYPE_INFO,
+                sizeof(device->product_type), deadline_us,
+                device->product_type) != NO_ERROR ||
+            !sps30_discovery_is_sps30(device->product_type)) {
+            sensirion_uart_hal_free();
+            continue;
+        }
+        device->port = port;
+        found++;
+    }
+
+    /* round 2: ask the sensors found for their serial number */
+    for (i = 0; i < found; i++) {
+        sensirion_uart_hal_select_port(devices[i].port);
+        sps30_discovery_request(SPS30_DISCOVERY_SERIAL_NUMBER_INFO);
+    }
+    deadline_us =
+        sensirion_uart_hal_get_time_usec() + (uint64_t)timeout_ms * 1000;
+    for (i = 0; i < found; i++) {
+        sensirion_uart_hal_select_port(devices[i].port);
+        if (sps30_discovery_response(
+                SPS30_DISCOVERY_SERIAL_NUMBER_INFO,
+                sizeof(devices[i].serial_number), deadline_us,
+                devices[i].serial_number) != NO_ERROR) {
+            /* still an SPS30, the application may read it again later */
+            devices[i].serial_number[0] = 0;
+            continue;
+        }
+        sps30_identity_set_device_information(devices[i].port,
+                                              devices[i].product_type,
+                                              devices[i].serial_number);
+    }
+
+    sensirion_uart_hal_select_port(selected);
+    return (int16_t)found;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_discovery.h
+ *
+ *  Discovery of the SPS30 on many serial ports at startup. Probing the ports
+ *  one by one waits out a response timeout on every empty port. Instead, the
+ *  probe requests are sent to all ports first and the responses are then
+ *  collected against one common deadline, so a cold start takes about one
+ *  probe timeout regardless of the number of ports.
+ *
+ *  A port is identified as an SPS30 by its product type, after which its
+ *  serial number is read the same way. Both are stored in the identity cache
+ *  of the port, see sps30_identity.h.
+ */
+#ifndef SPS30_DISCOVERY_H
+#define SPS30_DISCOVERY_H
+
+#include "sensirion_config.h"
+#include "sensirion_uart_portdescriptor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Product type reported by the SPS30 */
+#define SPS30_DISCOVERY_PRODUCT_TYPE "00080000"
+
+struct sps30_discovery_device {
+    uint16_t port;             //< UART port index the sensor was found on
+    int8_t product_type[9];    //< zero terminated
+    int8_t serial_number[32];  //< zero terminated
+};
+
+/**
+ * sps30_discovery_scan() - Open candidate serial ports and identify the SPS30
+ *                          connected to them.
+ *
+ * Candidate i is opened on UART port first_port + i. Ports on which an SPS30
+ * answered stay open, all other ports are closed. The selected port of the
+ * UART HAL is not changed.
+ *
+ * @param paths       Device paths of the candidate ports
+ * @param count       Number of candidates
+ * @param first_port  UART port index of the first candidate
+ * @param timeout_ms  Response timeout of each probe round, e.g.
+ *                    SPS30_DEVICE_INFORMATION_TIMEOUT_MS
+ * @param devices     Registry filled with the sensors found, in port order
+ * @param max_devices Capacity of devices
+ *
+ * @return Number of sensors found, -1 if the candidates do not fit into
+ *         SENSIRION_UART_MAX_PORTS
+ */
+int16_t sps30_discovery_scan(const UartDescr* paths, uint16_t count,
+                             uint16_t first_port, uint32_t timeout_ms,
+                             struct sps30_discovery_device* devices,
+                             uint16_t max_devices);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_DISCOVERY_H
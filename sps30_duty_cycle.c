@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_duty_cycle.c
+ */
+#include "sps30_duty_cycle.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_cleaning.h"
+#include "sps30_uart.h"
+
+struct sps30_duty_cycle_port {
+    bool configured;     //< false until a config was set, the default applies
+    bool fan_on;         //< a measurement was started and not stopped
+    bool asleep;         //< the sensor is in sleep mode
+    bool has_reference;  //< reference_mc_2p5 holds the previous sample
+    float reference_mc_2p5;
+    uint64_t measurement_start_us;
+    uint64_t last_read_us;  //< last measurement read, kept or discarded
+    uint64_t next_us;       //< time of the next step
+    uint64_t fan_on_us;     //< fan time up to the last stop
+    struct sps30_duty_cycle_config config;
+    struct sps30_duty_cycle_status status;
+};
+
+static struct sps30_duty_cycle_port duty_cycle_table[SENSIRION_UART_MAX_PORTS];
+
+int16_t
+sps30_duty_cycle_set_config(uint16_t port,
+                            const struct sps30_duty_cycle_config* config) {
+    struct sps30_duty_cycle_config* applied;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    if (config == NULL) {
+        duty_cycle_table[port].configured = false;
+        return NO_ERROR;
+    }
+    applied = &duty_cycle_table[port].config;
+    *applied = *config;
+    if (applied->min_period_ms < SPS30_DUTY_CYCLE_SAMPLE_INTERVAL_MS) {
+        applied->min_period_ms = SPS30_DUTY_CYCLE_SAMPLE_INTERVAL_MS;
+    }
+    if (applied->max_period_ms < applied->min_period_ms) {
+        applied->max_period_ms = applied->min_period_ms;
+    }
+    duty_cycle_table[port].configured = true;
+    return NO_ERROR;
+}
+
+static void
+sps30_duty_cycle_get_config(const struct sps30_duty_cycle_port* duty,
+                            struct sps30_duty_cycle_config* config) {
+    if (duty->configured) {
+        *config = duty->config;
+        return;
+    }
+    config->min_period_ms = SPS30_DUTY_CYCLE_MIN_PERIOD_MS;
+    config->max_period_ms = SPS30_DUTY_CYCLE_MAX_PERIOD_MS;
+    config->warmup_ms = SPS30_DUTY_CYCLE_WARMUP_MS;
+    config->change_threshold = SPS30_DUTY_CYCLE_CHANGE_THRESHOLD;
+}
+
+static struct sps30_duty_cycle_port* sps30_duty_cycle_selected(void) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return NULL;
+    }
+    return &duty_cycle_table[port];
+}
+
+static int16_t sps30_duty_cycle_begin(struct sps30_duty_cycle_port* duty) {
+    uint64_t now_us;
+    int16_t error;
+
+    error = sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    if (error != NO_ERROR) {
+        return error;
+    }
+    now_us = sensirion_uart_hal_get_time_usec();
+    duty->fan_on = true;
+    duty->measurement_start_us = now_us;
+    duty->last_read_us = now_us;
+    duty->next_us = now_us + SPS30_DUTY_CYCLE_SAMPLE_INTERVAL_MS * 1000;
+    duty->status.state = SPS30_DUTY_CYCLE_WARMING_UP;
+    duty->status.wake_ups++;
+    return NO_ERROR;
+}
+
+static int16_t sps30_duty_cycle_end(struct sps30_duty_cycle_port* duty) {
+    int16_t error;
+
+    if (duty->fan_on) {
+        error = sps30_stop_measurement();
+        if (error != NO_ERROR) {
+            return error;
+        }
+        duty->fan_on = false;
+        duty->fan_on_us +=
+            sensirion_uart_hal_get_time_usec() - duty->measurement_start_us;
+    }
+    return NO_ERROR;
+}
+
+int16_t sps30_duty_cycle_start(void) {
+    struct sps30_duty_cycle_port* duty = sps30_duty_cycle_selected();
+    struct sps30_duty_cycle_config config;
+    struct sps30_duty_cycle_status cleared = {SPS30_DUTY_CYCLE_STOPPED};
+
+    if (duty == NULL) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    sps30_duty_cycle_get_config(duty, &config);
+    duty->status = cleared;
+    duty->status.period_ms = config.min_period_ms;
+    duty->fan_on = false;
+    duty->asleep = false;
+    duty->has_reference = false;
+    duty->fan_on_us = 0;
+    return sps30_duty_cycle_begin(duty);
+}
+
+int16_t sps30_duty_cycle_stop(void) {
+    struct sps30_duty_cycle_port* duty = sps30_duty_cycle_selected();
+    int16_t error = NO_ERROR;
+
+    if (duty == NULL) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    if (duty->asleep) {
+        error = sps30_wake_up_sequence();
+        duty->asleep = error != NO_ERROR;
+    }
+    if (error == NO_ERROR) {
+        error = sps30_duty_cycle_end(duty);
+    }
+    duty->status.state = SPS30_DUTY_CYCLE_STOPPED;
+    return error;
+}
+
+/* shorten the period on a change, lengthen it while the air is stable */
+static void sps30_duty_cycle_adapt(struct sps30_duty_cycle_port* duty,
+                                   const struct sps30_duty_cycle_config* config,
+                                   float mc_2p5) {
+    float change = mc_2p5 - duty->reference_mc_2p5;
+    uint32_t period_ms = duty->status.period_ms;
+
+    if (change < 0) {
+        change = -change;
+    }
+    if (!duty->has_reference || change > config->change_threshold) {
+        period_ms = config->min_period_ms;
+    } else if (period_ms < config->max_period_ms / 2) {
+        period_ms *= 2;
+    } else {
+        period_ms = config->max_period_ms;
+    }
+    if (period_ms < config->min_period_ms) {
+        period_ms = config->min_period_ms;
+    }
+    duty->status.period_ms = period_ms;
+    duty->reference_mc_2p5 = mc_2p5;
+    duty->has_reference = true;
+}
+
+/* read the next sample, discarded while the readings are not settled */
+static int16_t sps30_duty_cycle_measure(
+    struct sps30_duty_cycle_port* duty,
+    const struct sps30_duty_cycle_config* config,
+    struct sps30_sample* sample) {
+    uint64_t warmup_end_us =
+        duty->measurement_start_us + (uint64_t)config->warmup_ms * 1000;
+    uint64_t interval_us = SPS30_DUTY_CYCLE_SAMPLE_INTERVAL_MS * 1000;
+    uint64_t period_us;
+    uint32_t cleaning_ms;
+    int16_t error;
+
+    /* values measured while the fan cleans are not meaningful */
+    cleaning_ms = sps30_cleaning_get_remaining_ms();
+    if (cleaning_ms > 0) {
+        duty->next_us = sensirion_uart_hal_get_time_usec() +
+                        (uint64_t)cleaning_ms * 1000 + interval_us;
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    error = sps30_sample_read(sample);
+    if (error == SENSIRION_SHDLC_ERR_NO_DATA) {
+        /* the sensor is late with its values, try again shortly */
+        duty->next_us = sensirion_uart_hal_get_time_usec() + interval_us / 10;
+        return error;
+    }
+    if (error != NO_ERROR) {
+        return error;
+    }
+    duty->last_read_us = sample->timestamp_us;
+    if (sample->timestamp_us < warmup_end_us) {
+        duty->status.discarded_samples++;
+        duty->next_us = sample->timestamp_us + interval_us;
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    duty->status.samples++;
+    sps30_duty_cycle_adapt(duty, config, sample->mc_2p5);
+    period_us = (uint64_t)duty->status.period_ms * 1000;
+    /* sleeping is only worth it if the fan stays off beyond the warm-up */
+    if (period_us <= (uint64_t)config->warmup_ms * 1000 + interval_us) {
+        duty->status.state = SPS30_DUTY_CYCLE_MEASURING;
+        duty->next_us = sample->timestamp_us + period_us;
+        return NO_ERROR;
+    }
+    duty->status.state = SPS30_DUTY_CYCLE_STOPPING;
+    duty->next_us = sample->timestamp_us;
+    return NO_ERROR;
+}
+
+/* stop the measurement and sleep until the next warm-up has to start */
+static int16_t
+sps30_duty_cycle_sleep(struct sps30_duty_cycle_port* duty,
+                       const struct sps30_duty_cycle_config* config) {
+    uint64_t wake_up_us =
+        duty->last_read_us + (uint64_t)duty->status.period_ms * 1000;
+    uint64_t warmup_us = (uint64_t)config->warmup_ms * 1000;
+    int16_t error;
+
+    /* start early enough for the next sample to be settled */
+    wake_up_us = wake_up_us > warmup_us ? wake_up_us - warmup_us : 0;
+
+    error = sps30_duty_cycle_end(duty);
+    if (error != NO_ERROR) {
+        return error;
+    }
+    error = sps30_sleep();
+    /* without sleep support the idle sensor has its fan off as well */
+    if (error != NO_ERROR && error != SENSIRION_SHDLC_ERR_NOT_SUPPORTED) {
+        return error;
+    }
+    duty->asleep = error == NO_ERROR;
+    duty->status.state = SPS30_DUTY_CYCLE_SLEEPING;
+    duty->next_us = wake_up_us;
+    return NO_ERROR;
+}
+
+int16_t sps30_duty_cycle_poll(struct sps30_sample* sample) {
+    struct sps30_duty_cycle_port* duty = sps30_duty_cycle_selected();
+    struct sps30_duty_cycle_config config;
+    int16_t error;
+
+    if (duty == NULL) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    if (duty->status.state == SPS30_DUTY_CYCLE_STOPPED ||
+        sensirion_uart_hal_get_time_usec() < duty->next_us) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    sps30_duty_cycle_get_config(duty, &config);
+    switch (duty->status.state) {
+        case SPS30_DUTY_CYCLE_WARMING_UP:
+        case SPS30_DUTY_CYCLE_MEASURING:
+            return sps30_duty_cycle_measure(duty, &config, sample);
+        case SPS30_DUTY_CYCLE_STOPPING:
+            error = sps30_duty_cycle_sleep(duty, &config);
+            break;
+        case SPS30_DUTY_CYCLE_SLEEPING:
+            if (duty->asleep) {
+                error = sps30_wake_up_sequence();
+                if (error != NO_ERROR) {
+                    return error;
+                }
+                duty->asleep = false;
+            }
+            error = sps30_duty_cycle_begin(duty);
+            break;
+        default:
+            error = NO_ERROR;
+            break;
+    }
+    if (error != NO_ERROR) {
+        return error;
+    }
+    return SENSIRION_SHDLC_ERR_NO_DATA;
+}
+
+uint32_t sps30_duty_cycle_get_wait_ms(void) {
+    struct sps30_duty_cycle_port* duty = sps30_duty_cycle_selected();
+    uint64_t now_us = sensirion_uart_hal_get_time_usec();
+    uint64_t wait_ms;
+
+    if (duty == NULL || duty->status.state == SPS30_DUTY_CYCLE_STOPPED) {
+        return UINT32_MAX;
+    }
+    if (duty->next_us <= now_us) {
+        return 0;
+    }
+    wait_ms = (duty->next_us - now_us + 999) / 1000;
+    if (wait_ms > UINT32_MAX) {
+        return UINT32_MAX;
+    }
+    return (uint32_t)wait_ms;
+}
+
+int16_t sps30_duty_cycle_get_status(uint16_t port,
+                                    struct sps30_duty_cycle_status* status) {
+    const struct sps30_duty_cycle_port* duty;
+    uint64_t fan_on_us;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    duty = &duty_cycle_table[port];
+    fan_on_us = duty->fan_on_us;
+    if (duty->fan_on) {
+        fan_on_us +=
+            sensirion_uart_hal_get_time_usec() - duty->measurement_start_us;
+    }
+    *status = duty->status;
+    status->fan_on_ms = fan_on_us / 1000;
+    return NO_ERROR;
+}
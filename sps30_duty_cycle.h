@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_duty_cycle.h
+ *
+ *  Duty cycling of the SPS30 for battery powered deployments. Instead of
+ *  running the fan continuously, the sensor is put to sleep between samples
+ *  and the sampling period adapts to the air: every sample whose PM2.5 mass
+ *  concentration differs from the previous sample by more than
+ *  change_threshold resets the period to min_period_ms, every stable sample
+ *  doubles it up to max_period_ms.
+ *
+ *  After every start the sensor needs warmup_ms until its readings are
+ *  settled. Samples measured earlier are read and discarded. Sleeping only
+ *  pays off if the fan is off for longer than the warm-up, so as long as the
+ *  period is at most warmup_ms plus one measurement interval, the
+ *  measurement keeps running and every period yields a sample.
+ *
+ *  No samples are read during the fan cleaning windows of sps30_cleaning.h,
+ *  the next sample is taken one measurement interval after the window.
+ *
+ *  The application calls sps30_duty_cycle_poll() whenever
+ *  sps30_duty_cycle_get_wait_ms() has passed. The commands are sent in these
+ *  calls, so the thread can sleep in between. Errors of the commands are
+ *  returned to the application, which may pass them on to
+ *  sps30_health_update(), and the failed step is repeated by the next poll.
+ *
+ *  Sleep requires firmware 2.0. With older firmware the sensor stays idle
+ *  between the samples, which also stops the fan.
+ *
+ *  All functions except sps30_duty_cycle_get_status() must be called from
+ *  the thread performing the transactions of the port.
+ */
+#ifndef SPS30_DUTY_CYCLE_H
+#define SPS30_DUTY_CYCLE_H
+
+#include "sensirion_config.h"
+#include "sps30_sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Shortest sampling period on ports without a config */
+#ifndef SPS30_DUTY_CYCLE_MIN_PERIOD_MS
+#define SPS30_DUTY_CYCLE_MIN_PERIOD_MS 1000
+#endif
+
+/** Longest sampling period on ports without a config */
+#ifndef SPS30_DUTY_CYCLE_MAX_PERIOD_MS
+#define SPS30_DUTY_CYCLE_MAX_PERIOD_MS 600000
+#endif
+
+/** Time until the readings are settled, 30 s at low concentrations */
+#ifndef SPS30_DUTY_CYCLE_WARMUP_MS
+#define SPS30_DUTY_CYCLE_WARMUP_MS 30000
+#endif
+
+/** Change of the PM2.5 mass concentration in µg/m³ counted as an event */
+#ifndef SPS30_DUTY_CYCLE_CHANGE_THRESHOLD
+#define SPS30_DUTY_CYCLE_CHANGE_THRESHOLD 5.0f
+#endif
+
+/** Interval at which the sensor provides new measurement values */
+#define SPS30_DUTY_CYCLE_SAMPLE_INTERVAL_MS 1000
+
+typedef enum {
+    SPS30_DUTY_CYCLE_STOPPED = 0,  //< not started, the sensor is idle
+    SPS30_DUTY_CYCLE_WARMING_UP,   //< measuring, samples are discarded
+    SPS30_DUTY_CYCLE_MEASURING,    //< measuring continuously
+    SPS30_DUTY_CYCLE_STOPPING,     //< a sample was taken, going to sleep
+    SPS30_DUTY_CYCLE_SLEEPING,     //< waiting for the next sample
+} sps30_duty_cycle_state;
+
+struct sps30_duty_cycle_config {
+    uint32_t min_period_ms;  //< at least SPS30_DUTY_CYCLE_SAMPLE_INTERVAL_MS
+    uint32_t max_period_ms;  //< at least min_period_ms
+    uint32_t warmup_ms;      //< discard samples after a start for so long
+    float change_threshold;  //< PM2.5 change in µg/m³ which is an event
+};
+
+struct sps30_duty_cycle_status {
+    sps30_duty_cycle_state state;
+    uint32_t period_ms;          //< current sampling period
+    uint64_t fan_on_ms;          //< time the fan ran while duty cycling
+    uint32_t wake_ups;           //< starts after sleep or idle
+    uint32_t samples;            //< samples returned
+    uint32_t discarded_samples;  //< samples read during the warm-up
+};
+
+/**
+ * sps30_duty_cycle_set_config() - Configure the duty cycle of a port.
+ *
+ * A running duty cycle uses the config from its next sample on.
+ *
+ * @param port   UART port index, see sensirion_uart_hal_select_port()
+ * @param config Config to apply, NULL restores the default config
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port.
+ */
+int16_t
+sps30_duty_cycle_set_config(uint16_t port,
+                            const struct sps30_duty_cycle_config* config);
+
+/**
+ * sps30_duty_cycle_start() - Start duty cycling the sensor on the selected
+ *                            port.
+ *
+ * The sensor must be idle. The measurement is started in the float output
+ * format at once, the first sample is returned after the warm-up. The
+ * statistics restart at zero.
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT if the
+ *         selected port is invalid, an error code of
+ *         sps30_start_measurement() otherwise.
+ */
+int16_t sps30_duty_cycle_start(void);
+
+/**
+ * sps30_duty_cycle_stop() - Stop duty cycling the sensor on the selected
+ *                           port and leave it idle.
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT if the
+ *         selected port is invalid, an error code of the failed command
+ *         otherwise. The duty cycle is stopped even then.
+ */
+int16_t sps30_duty_cycle_stop(void);
+
+/**
+ * sps30_duty_cycle_poll() - Run the duty cycle of the selected port.
+ *
+ * Wakes up, starts, reads and stops the sensor as far as it is due.
+ *
+ * @param sample Memory where a new sample is stored
+ *
+ * @return NO_ERROR if a sample was stored, SENSIRION_SHDLC_ERR_NO_DATA if no
+ *         sample is due, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT if the selected
+ *         port is invalid, an error code of the failed command otherwise.
+ */
+int16_t sps30_duty_cycle_poll(struct sps30_sample* sample);
+
+/**
+ * sps30_duty_cycle_get_wait_ms() - Time until sps30_duty_cycle_poll() has
+ *                                  something to do on the selected port.
+ *
+ * @return Milliseconds to wait, 0 if the next poll is due now, UINT32_MAX
+ *         if the duty cycle is stopped.
+ */
+uint32_t sps30_duty_cycle_get_wait_ms(void);
+
+/**
+ * sps30_duty_cycle_get_status() - Read the state and the statistics of a
+ *                                 port.
+ *
+ * @param port   UART port index
+ * @param status Memory where the status is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port.
+ */
+int16_t sps30_duty_cycle_get_status(uint16_t port,
+                                    struct sps30_duty_cycle_status* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_DUTY_CYCLE_H
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_fast_start.c
+ */
+#include "sps30_fast_start.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_cleaning.h"
+#include "sps30_identity.h"
+#include "sps30_uart.h"
+
+/* the sensor provides its first values one second after the start */
+#define SPS30_FAST_START_FIRST_SAMPLE_MS 1000
+
+static bool fast_start_pending[SENSIRION_UART_MAX_PORTS];
+
+/* wake up the sensor and start the measurement, the fan spins up from here */
+static int16_t
+sps30_fast_start_begin(const struct sps30_fast_start_config* config) {
+    int16_t error;
+
+    if (config->wake_up) {
+        error = sps30_wake_up_sequence();
+        /* the sensor was awake already or cannot sleep at all */
+        if (error != NO_ERROR &&
+            error != SENSIRION_SHDLC_ERR_EXECUTION_FAILURE &&
+            error != SENSIRION_SHDLC_ERR_NOT_SUPPORTED) {
+            return error;
+        }
+    }
+    error = sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    /* a sensor which measures already provides its samples */
+    if (error == SENSIRION_SHDLC_ERR_EXECUTION_FAILURE) {
+        error = NO_ERROR;
+    }
+    return error;
+}
+
+/* identify and configure the sensor while the fan spins up */
+static void
+sps30_fast_start_prepare(const struct sps30_fast_start_config* config,
+                         struct sps30_fast_start_result* result) {
+    struct sps30_identity identity;
+
+    result->identity_error = sps30_identity_read(&identity);
+    if (config->config != NULL) {
+        (void)sps30_config_reconcile(config->config, &result->config);
+    }
+}
+
+uint16_t sps30_fast_start_fleet(const uint16_t* ports, uint16_t count,
+                                const struct sps30_fast_start_config* config,
+                                struct sps30_fast_start_result* results) {
+    uint16_t selected = sensirion_uart_hal_get_selected_port();
+    uint64_t start_us = sensirion_uart_hal_get_time_usec();
+    uint64_t deadline_us = start_us + (uint64_t)config->timeout_ms * 1000;
+    uint64_t poll_us = 0;
+    uint64_t now_us;
+    uint16_t waiting = 0;
+    uint16_t started = 0;
+    uint16_t i;
+
+    /* round 1: start all fans before anything else */
+    for (i = 0; i < count; i++) {
+        results[i].error = SENSIRION_SHDLC_ERR_NO_DATA;
+        results[i].identity_error = SENSIRION_SHDLC_ERR_NO_DATA;
+        results[i].config.outcome = SPS30_CONFIG_UNCHANGED;
+        results[i].config.error = NO_ERROR;
+        results[i].time_to_first_sample_ms = 0;
+        if (ports[i] >= SENSIRION_UART_MAX_PORTS) {
+            continue;
+        }
+        sensirion_uart_hal_select_port(ports[i]);
+        fast_start_pending[ports[i]] = false;
+        results[i].error = sps30_fast_start_begin(config);
+        if (results[i].error == NO_ERROR) {
+            if (waiting == 0) {
+                poll_us = sensirion_uart_hal_get_time_usec() +
+                          (uint64_t)SPS30_FAST_START_FIRST_SAMPLE_MS * 1000;
+            }
+            results[i].error = SENSIRION_SHDLC_ERR_NO_DATA;
+            fast_start_pending[ports[i]] = true;
+            waiting++;
+        }
+    }
+
+    /* round 2: identity and configuration during the spin-up */
+    for (i = 0; i < count; i++) {
+        if (ports[i] < SENSIRION_UART_MAX_PORTS &&
+            fast_start_pending[ports[i]]) {
+            sensirion_uart_hal_select_port(ports[i]);
+            sps30_fast_start_prepare(config, &results[i]);
+        }
+    }
+
+    /* round 3: poll round robin, from the first values of the first fan */
+    while (waiting > 0) {
+        now_us = sensirion_uart_hal_get_time_usec();
+        if (poll_us > now_us) {
+            if (poll_us >= deadline_us) {
+                break;
+            }
+            sensirion_uart_hal_sleep_usec((uint32_t)(poll_us - now_us));
+        } else if (now_us >= deadline_us) {
+            break;
+        }
+        for (i = 0; i < count; i++) {
+            if (ports[i] >= SENSIRION_UART_MAX_PORTS ||
+                !fast_start_pending[ports[i]]) {
+                continue;
+            }
+            sensirion_uart_hal_select_port(ports[i]);
+            /* values measured while the fan cleans are not meaningful */
+            if (sps30_cleaning_is_active()) {
+                continue;
+            }
+            results[i].error = sps30_sample_read(&results[i].sample);
+            if (results[i].error != NO_ERROR) {
+                continue;
+            }
+            results[i].time_to_first_sample_ms =
+                (uint32_t)((results[i].sample.timestamp_us - start_us) / 1000);
+            fast_start_pending[ports[i]] = false;
+            waiting--;
+            started++;
+        }
+        poll_us = sensirion_uart_hal_get_time_usec() +
+                  (uint64_t)SPS30_FAST_START_POLL_MS * 1000;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (ports[i] < SENSIRION_UART_MAX_PORTS) {
+            fast_start_pending[ports[i]] = false;
+        }
+    }
+    sensirion_uart_hal_select_port(selected);
+    return started;
+}
+
+int16_t sps30_fast_start(const struct sps30_fast_start_config* config,
+                         struct sps30_fast_start_result* result) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    (void)sps30_fast_start_fleet(&port, 1, config, result);
+    return result->error;
+}
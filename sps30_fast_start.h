@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_fast_start.h
+ *
+ *  Startup of the SPS30 with the shortest time to the first sample. The
+ *  fan needs about a second to deliver the first values after the start of
+ *  the measurement, which a startup doing wake-up, identity, configuration
+ *  and start one after the other adds to its own transactions. The fast
+ *  start sends sps30_start_measurement() right after the wake-up and reads
+ *  the identity and reconciles the configuration while the fan spins up.
+ *
+ *  For several sensors, all measurements are started before any identity
+ *  is read, so all fans spin up at the same time, and the first samples are
+ *  then polled round robin. The startup of a fleet thus takes about as long
+ *  as the startup of one sensor plus the transactions. Ports without a
+ *  sensor cost the timeout of sps30_start_measurement(), so pass the ports
+ *  found by sps30_discovery_scan().
+ *
+ *  The first sample is the first one the sensor provides, outside of fan
+ *  cleaning windows. At low concentrations the readings settle only within
+ *  up to 30 seconds, see sps30_duty_cycle.h for a warm-up.
+ */
+#ifndef SPS30_FAST_START_H
+#define SPS30_FAST_START_H
+
+#include "sensirion_config.h"
+#include "sps30_config.h"
+#include "sps30_sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Interval at which the sensors are polled for their first sample */
+#ifndef SPS30_FAST_START_POLL_MS
+#define SPS30_FAST_START_POLL_MS 50
+#endif
+
+struct sps30_fast_start_config {
+    bool wake_up;                       //< the sensors may be asleep
+    const struct sps30_config* config;  //< reconciled, NULL to skip
+    uint32_t timeout_ms;                //< limit for the first sample
+};
+
+struct sps30_fast_start_result {
+    int16_t error;                      //< NO_ERROR if the sample was read
+    int16_t identity_error;             //< result of sps30_identity_read()
+    struct sps30_config_result config;  //< result of the reconciliation
+    uint32_t time_to_first_sample_ms;   //< from the call until the sample
+    struct sps30_sample sample;         //< first sample if error is 0
+};
+
+/**
+ * sps30_fast_start() - Start the measurement of the sensor on the selected
+ *                      port and wait for its first sample.
+ *
+ * @param config Wake-up, configuration and timeout of the start
+ * @param result Memory where the result is stored
+ *
+ * @return NO_ERROR if the first sample was read, the error of the start or
+ *         the last read otherwise, SENSIRION_SHDLC_ERR_NO_DATA on timeout.
+ */
+int16_t sps30_fast_start(const struct sps30_fast_start_config* config,
+                         struct sps30_fast_start_result* result);
+
+/**
+ * sps30_fast_start_fleet() - Start the measurement of the sensors on several
+ *                            ports and wait for their first samples.
+ *
+ * The selected port of the UART HAL is not changed.
+ *
+ * @param ports   UART port indices of the sensors
+ * @param count   Number of ports
+ * @param config  Wake-up, configuration and timeout of the start
+ * @param results Memory where the result of each port is stored
+ *
+ * @return Number of ports whose first sample was read
+ */
+uint16_t sps30_fast_start_fleet(const uint16_t* ports, uint16_t count,
+                                const struct sps30_fast_start_config* config,
+                                struct sps30_fast_start_result* results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_FAST_START_H
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_health.c
+ */
+#include "sps30_health.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_shdlc_recorder.h"
+#include "sensirion_shdlc_retry.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_latest.h"
+
+struct sps30_health_port {
+    bool configured;  //< false until a config was set, the default applies
+    bool measuring;   //< a measurement was started and not stopped
+    bool recovering;  //< the recovery ladder is running
+    sps30_output_format output_format;
+    struct sps30_health_config config;
+    struct sps30_health_status status;
+};
+
+static struct sps30_health_port health_table[SENSIRION_UART_MAX_PORTS];
+
+int16_t sps30_health_set_config(uint16_t port,
+                                const struct sps30_health_config* config) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    if (config == NULL) {
+        health_table[port].configured = false;
+        return NO_ERROR;
+    }
+    health_table[port].config = *config;
+    if (health_table[port].config.failure_threshold == 0) {
+        health_table[port].config.failure_threshold = 1;
+    }
+    health_table[port].configured = true;
+    return NO_ERROR;
+}
+
+static void sps30_health_get_config(const struct sps30_health_port* health,
+                                    struct sps30_health_config* config) {
+    if (health->configured) {
+        *config = health->config;
+        return;
+    }
+    config->failure_threshold = SPS30_HEALTH_FAILURE_THRESHOLD;
+    config->reset_delay_ms = SPS30_HEALTH_RESET_DELAY_MS;
+    config->offline_probe_ms = SPS30_HEALTH_OFFLINE_PROBE_MS;
+}
+
+/* check that the sensor answers and resume its measurement */
+static int16_t sps30_health_resume(const struct sps30_health_port* health) {
+    uint8_t firmware_major;
+    uint8_t firmware_minor;
+    uint8_t reserved1;
+    uint8_t hardware_revision;
+    uint8_t reserved2;
+    uint8_t shdlc_major;
+    uint8_t shdlc_minor;
+    int16_t error;
+
+    error = sps30_read_version(&firmware_major, &firmware_minor, &reserved1,
+                               &hardware_revision, &reserved2, &shdlc_major,
+                               &shdlc_minor);
+    if (error != NO_ERROR || !health->measuring) {
+        return error;
+    }
+    error = sps30_start_measurement(health->output_format);
+    /* the sensor was still measuring, only its interface hung */
+    if (error == SENSIRION_SHDLC_ERR_EXECUTION_FAILURE) {
+        error = NO_ERROR;
+    }
+    return error;
+}
+
+static void sps30_health_recover(struct sps30_health_port* health,
+                                 const struct sps30_health_config* config) {
+    sensirion_shdlc_recorder_trigger_dump(
+        sensirion_uart_hal_get_selected_port());
+    health->recovering = true;
+
+    /* a sleeping sensor ignores everything but the wake-up sequence */
+    health->status.last_step = SPS30_HEALTH_STEP_WAKE_UP;
+    (void)sps30_wake_up_sequence();
+    if (sps30_health_resume(health) != NO_ERROR) {
+        health->status.last_step = SPS30_HEALTH_STEP_RESET;
+        (void)sps30_device_reset();
+        sensirion_uart_hal_sleep_usec(config->reset_delay_ms * 1000);
+        if (sps30_health_resume(health) != NO_ERROR) {
+            health->status.last_step = SPS30_HEALTH_STEP_OFFLINE;
+        }
+    }
+
+    health->recovering = false;
+    health->status.consecutive_failures = 0;
+    if (health->status.last_step == SPS30_HEALTH_STEP_OFFLINE) {
+        health->status.state = SPS30_HEALTH_OFFLINE;
+        health->status.offline_since_us = sensirion_uart_hal_get_time_usec();
+        health->status.failed_recoveries++;
+        return;
+    }
+    health->status.state = SPS30_HEALTH_ONLINE;
+    health->status.recoveries++;
+}
+
+static sps30_health_state sps30_health_evaluate(int16_t error) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    struct sps30_health_port* health;
+    struct sps30_health_config config;
+    uint64_t offline_us;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SPS30_HEALTH_OFFLINE;
+    }
+    health = &health_table[port];
+
+    /* any complete response proves that the sensor is alive */
+    if (error == NO_ERROR || error == SENSIRION_SHDLC_ERR_EXECUTION_FAILURE) {
+        health->status.state = SPS30_HEALTH_ONLINE;
+        health->status.consecutive_failures = 0;
+        return health->status.state;
+    }
+    if (!sensirion_shdlc_retry_is_retryable(error)) {
+        return health->status.state;
+    }
+
+    sps30_health_get_config(health, &config);
+    health->status.last_error = error;
+    health->status.failures++;
+    if (health->status.state == SPS30_HEALTH_OFFLINE) {
+        offline_us = sensirion_uart_hal_get_time_usec() -
+                     health->status.offline_since_us;
+        if (config.offline_probe_ms != 0 &&
+            offline_us >= (uint64_t)config.offline_probe_ms * 1000) {
+            sps30_health_recover(health, &config);
+        }
+        return health->status.state;
+    }
+    if (health->status.consecutive_failures < UINT16_MAX) {
+        health->status.consecutive_failures++;
+    }
+    if (health->status.consecutive_failures < config.failure_threshold) {
+        health->status.state = SPS30_HEALTH_FAILING;
+        return health->status.state;
+    }
+    sps30_health_recover(health, &config);
+    return health->status.state;
+}
+
+sps30_health_state sps30_health_update(int16_t error) {
+    sps30_health_state state = sps30_health_evaluate(error);
+
+    sps30_latest_health_updated(state);
+    return state;
+}
+
+int16_t sps30_health_get_status(uint16_t port,
+                                struct sps30_health_status* status) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    *status = health_table[port].status;
+    return NO_ERROR;
+}
+
+void sps30_health_reset(uint16_t port) {
+    struct sps30_health_status cleared = {SPS30_HEALTH_ONLINE};
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    health_table[port].measuring = false;
+    health_table[port].status = cleared;
+}
+
+void sps30_health_measurement_started(sps30_output_format output_format) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    health_table[port].measuring = true;
+    health_table[port].output_format = output_format;
+}
+
+void sps30_health_measurement_stopped(void) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    /* the reset of the recovery keeps the measurement of the application */
+    if (port >= SENSIRION_UART_MAX_PORTS || health_table[port].recovering) {
+        return;
+    }
+    health_table[port].measuring = false;
+}
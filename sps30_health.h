@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_health.h
+ *
+ *  Health watchdog of the SPS30 on every UART port. The application passes
+ *  the result of each sps30_* command to sps30_health_update(). Timeouts and
+ *  damaged frames count as failures, while any complete response, including
+ *  an execution error reported by the sensor, proves that it is alive.
+ *
+ *  After failure_threshold consecutive failures the watchdog runs the
+ *  recovery ladder right away, stopping at the first step after which the
+ *  sensor answers again:
+ *
+ *    1. sps30_wake_up_sequence(), for a sensor that went to sleep
+ *    2. sps30_device_reset(), followed by reset_delay_ms
+ *    3. marking the device offline
+ *
+ *  After steps 1 and 2 a measurement which was running is started again with
+ *  the output format last passed to sps30_start_measurement(). An offline
+ *  device runs the ladder again every offline_probe_ms, so a sensor which
+ *  was replaced or power cycled comes back on its own. A gap in the data
+ *  thus lasts failure_threshold commands plus the restart of the sensor.
+ *
+ *  With SENSIRION_SHDLC_FLIGHT_RECORDER set, the flight recorder of the port
+ *  is dumped before the recovery starts.
+ *
+ *  The watchdog follows the measurement through sps30_hooks.h, which must be
+ *  installed. All functions except sps30_health_get_status() must be called
+ *  from the thread performing the transactions of the port.
+ */
+#ifndef SPS30_HEALTH_H
+#define SPS30_HEALTH_H
+
+#include "sensirion_config.h"
+#include "sps30_uart.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Consecutive failures which start the recovery on ports without a config */
+#ifndef SPS30_HEALTH_FAILURE_THRESHOLD
+#define SPS30_HEALTH_FAILURE_THRESHOLD 3
+#endif
+
+/** Time the sensor needs after a reset before it accepts commands */
+#ifndef SPS30_HEALTH_RESET_DELAY_MS
+#define SPS30_HEALTH_RESET_DELAY_MS 100
+#endif
+
+/** Interval of recovery attempts of an offline device, 0 for none */
+#ifndef SPS30_HEALTH_OFFLINE_PROBE_MS
+#define SPS30_HEALTH_OFFLINE_PROBE_MS 60000
+#endif
+
+typedef enum {
+    SPS30_HEALTH_ONLINE = 0,  //< the last command was answered
+    SPS30_HEALTH_FAILING,     //< failures below the threshold
+    SPS30_HEALTH_OFFLINE,     //< the recovery ladder failed
+} sps30_health_state;
+
+/** Step of the recovery ladder */
+typedef enum {
+    SPS30_HEALTH_STEP_NONE = 0,
+    SPS30_HEALTH_STEP_WAKE_UP,
+    SPS30_HEALTH_STEP_RESET,
+    SPS30_HEALTH_STEP_OFFLINE,
+} sps30_health_step;
+
+struct sps30_health_config {
+    uint16_t failure_threshold;  //< consecutive failures, at least 1
+    uint32_t reset_delay_ms;     //< wait after sps30_device_reset()
+    uint32_t offline_probe_ms;   //< recovery interval when offline, 0 never
+};
+
+struct sps30_health_status {
+    sps30_health_state state;
+    sps30_health_step last_step;    //< step the last recovery ended with
+    int16_t last_error;             //< last failure reported
+    uint16_t consecutive_failures;  //< failures since the last answer
+    uint32_t failures;              //< failures in total
+    uint32_t recoveries;            //< recoveries which revived the sensor
+    uint32_t failed_recoveries;     //< recoveries which ended offline
+    uint64_t offline_since_us;      //< time of the last failed recovery
+};
+
+/**
+ * sps30_health_set_config() - Configure the watchdog of a port.
+ *
+ * @param port   UART port index, see sensirion_uart_hal_select_port()
+ * @param config Config to apply, NULL restores the default config
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port.
+ */
+int16_t sps30_health_set_config(uint16_t port,
+                                const struct sps30_health_config* config);
+
+/**
+ * sps30_health_update() - Report the result of an sps30_* command on the
+ *                         selected port.
+ *
+ * Runs the recovery ladder when the failure threshold is reached, or when
+ * the device is offline and the next probe is due.
+ *
+ * @param error Result of the command
+ *
+ * @return Health state of the port after the update
+ */
+sps30_health_state sps30_health_update(int16_t error);
+
+/**
+ * sps30_health_get_status() - Read the health of a port.
+ *
+ * @param port   UART port index
+ * @param status Memory where the status is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port.
+ */
+int16_t sps30_health_get_status(uint16_t port,
+                                struct sps30_health_status* status);
+
+/**
+ * sps30_health_reset() - Forget the health and the measurement of a port,
+ *                        e.g. after the sensor was replaced.
+ *
+ * @param port UART port index
+ */
+void sps30_health_reset(uint16_t port);
+
+/**
+ * sps30_health_measurement_started() - Remember the running measurement of
+ *                                      the selected port.
+ *
+ * This is called through sps30_hooks.h when sps30_start_measurement()
+ * succeeds.
+ *
+ * @param output_format Output format of the measurement
+ */
+void sps30_health_measurement_started(sps30_output_format output_format);
+
+/**
+ * sps30_health_measurement_stopped() - Remember that the selected port does
+ *                                      not measure.
+ *
+ * This is called through sps30_hooks.h when a command which ends a
+ * measurement succeeds.
+ */
+void sps30_health_measurement_stopped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_HEALTH_H
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_hooks.c
+ */
+#include "sps30_hooks.h"
+#include "sensirion_common.h"
+#include "sensirion_streaming_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_cleaning.h"
+#include "sps30_config.h"
+#include "sps30_health.h"
+#include "sps30_identity.h"
+#include "sps30_latest.h"
+#include "sps30_uart.h"
+
+#define SPS30_CMD_START_MEASUREMENT 0x00
+#define SPS30_CMD_STOP_MEASUREMENT 0x01
+#define SPS30_CMD_SLEEP 0x10
+#define SPS30_CMD_WAKE_UP 0x11
+#define SPS30_CMD_START_FAN_CLEANING 0x56
+#define SPS30_CMD_AUTO_CLEANING_INTERVAL 0x80
+#define SPS30_CMD_READ_DEVICE_STATUS_REGISTER 0xd2
+#define SPS30_CMD_DEVICE_RESET 0xd3
+
+/** arguments of the longest request, write auto cleaning interval */
+#define SPS30_HOOKS_MAX_REQUEST_SIZE 5
+
+/* the response overwrites the request, so its arguments are kept per port */
+struct sps30_hooks_request {
+    uint8_t data_length;
+    uint8_t data[SPS30_HOOKS_MAX_REQUEST_SIZE];
+};
+
+static struct sps30_hooks_request request_table[SENSIRION_UART_MAX_PORTS];
+
+/* capabilities the sensor needs for a request, see sps30_identity.h */
+static uint16_t sps30_hooks_capabilities(uint8_t command, const uint8_t* data,
+                                         uint8_t data_length) {
+    switch (command) {
+        case SPS30_CMD_START_MEASUREMENT:
+            if (data_length == 2 &&
+                sensirion_common_bytes_to_uint16_t(data) ==
+                    SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_UINT16) {
+                return SPS30_CAPABILITY_UINT16_OUTPUT;
+            }
+            return 0;
+        case SPS30_CMD_SLEEP:
+        case SPS30_CMD_WAKE_UP:
+            return SPS30_CAPABILITY_SLEEP;
+        case SPS30_CMD_READ_DEVICE_STATUS_REGISTER:
+            return SPS30_CAPABILITY_STATUS_REGISTER;
+        default:
+            return 0;
+    }
+}
+
+static int16_t sps30_hooks_request(uint8_t command, const uint8_t* data,
+                                   uint8_t data_length) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    struct sps30_hooks_request* request;
+
+    if (!sps30_identity_supports(
+            sps30_hooks_capabilities(command, data, data_length))) {
+        return SENSIRION_SHDLC_ERR_NOT_SUPPORTED;
+    }
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return NO_ERROR;
+    }
+    request = &request_table[port];
+    request->data_length = 0;
+    if (data_length <= sizeof(request->data)) {
+        sensirion_common_copy_bytes(data, request->data, data_length);
+        request->data_length = data_length;
+    }
+    return NO_ERROR;
+}
+
+static void sps30_hooks_response(uint8_t command,
+                                 const struct sensirion_shdlc_rx_header* header,
+                                 const uint8_t* data, int16_t error) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    const struct sps30_hooks_request* request;
+
+    if (error != NO_ERROR || port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    request = &request_table[port];
+    switch (command) {
+        case SPS30_CMD_START_MEASUREMENT:
+            if (request->data_length == 2) {
+                sps30_health_measurement_started(
+                    (sps30_output_format)sensirion_common_bytes_to_uint16_t(
+                        request->data));
+            }
+            sps30_cleaning_measurement_started();
+            break;
+        case SPS30_CMD_STOP_MEASUREMENT:
+            sps30_health_measurement_stopped();
+            sps30_cleaning_measurement_stopped();
+            break;
+        case SPS30_CMD_START_FAN_CLEANING:
+            sps30_cleaning_fan_cleaning_started();
+            break;
+        case SPS30_CMD_AUTO_CLEANING_INTERVAL:
+            /* subcommand 0 followed by the interval writes it */
+            if (request->data_length == 5) {
+                sps30_config_auto_cleaning_interval_written(
+                    sensirion_common_bytes_to_uint32_t(&request->data[1]));
+            }
+            break;
+        case SPS30_CMD_READ_DEVICE_STATUS_REGISTER:
+            if (header->data_len >= 4) {
+                sps30_latest_device_status_read(
+                    sensirion_common_bytes_to_uint32_t(data));
+            }
+            break;
+        case SPS30_CMD_DEVICE_RESET:
+            sps30_health_measurement_stopped();
+            sps30_cleaning_device_reset();
+            break;
+        default:
+            break;
+    }
+}
+
+void sps30_hooks_install(void) {
+    sensirion_shdlc_set_hooks(sps30_hooks_request, sps30_hooks_response);
+}
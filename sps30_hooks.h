@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_hooks.h
+ *
+ *  Dispatch of the SHDLC hooks to the add-on modules of the driver. The
+ *  commands of sps30_uart.c are generated and know nothing about the
+ *  add-ons, so the modules follow the commands through the hooks of the
+ *  streaming SHDLC layer instead, see sensirion_shdlc_set_hooks():
+ *
+ *    - sps30_health.h learns which measurement runs, to restart it after a
+ *      recovery
+ *    - sps30_identity.h refuses the commands the sensor does not support
+ *    - sps30_config.h caches the auto cleaning interval written
+ *    - sps30_cleaning.h follows measurements, fan cleanings and resets
+ *    - sps30_latest.h publishes the device status register read
+ *
+ *  Applications using one of these modules call sps30_hooks_install() once
+ *  before the first command.
+ */
+#ifndef SPS30_HOOKS_H
+#define SPS30_HOOKS_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * sps30_hooks_install() - Register the hooks of the add-on modules with the
+ *                         SHDLC layer.
+ */
+void sps30_hooks_install(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_HOOKS_H
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_identity.c
+ */
+#include "sps30_identity.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_uart.h"
+
+struct sps30_identity_port {
+    bool valid;
+    bool has_device_information;  //< product type and serial number are set
+    struct sps30_identity identity;
+};
+
+static struct sps30_identity_port identity_table[SENSIRION_UART_MAX_PORTS];
+
+static uint16_t sps30_identity_capabilities(const struct sps30_identity* id) {
+    uint16_t capabilities = 0;
+
+    if (id->firmware_major >= 2) {
+        capabilities |= SPS30_CAPABILITY_SLEEP | SPS30_CAPABILITY_UINT16_OUTPUT;
+    }
+    if (id->firmware_major > 2 ||
+        (id->firmware_major == 2 && id->firmware_minor >= 2)) {
+        capabilities |= SPS30_CAPABILITY_STATUS_REGISTER;
+    }
+    return capabilities;
+}
+
+int16_t sps30_identity_read(struct sps30_identity* identity) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    struct sps30_identity_port* entry;
+    struct sps30_identity* id;
+    uint8_t reserved1;
+    uint8_t reserved2;
+    int16_t error;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    entry = &identity_table[port];
+    id = &entry->identity;
+    if (!entry->valid) {
+        /* the three commands share the communication buffer of the driver */
+        if (!entry->has_device_information) {
+            error = sps30_read_product_type(id->product_type,
+                                            sizeof(id->product_type));
+            if (error != NO_ERROR) {
+                return error;
+            }
+            error = sps30_read_serial_number(id->serial_number,
+                                             sizeof(id->serial_number));
+            if (error != NO_ERROR) {
+                return error;
+            }
+        }
+        error = sps30_read_version(&id->firmware_major, &id->firmware_minor,
+                                   &reserved1, &id->hardware_revision,
+                                   &reserved2, &id->shdlc_major,
+                                   &id->shdlc_minor);
+        if (error != NO_ERROR) {
+            return error;
+        }
+        id->product_type[sizeof(id->product_type) - 1] = 0;
+        id->serial_number[sizeof(id->serial_number) - 1] = 0;
+        id->capabilities = sps30_identity_capabilities(id);
+        entry->valid = true;
+    }
+    *identity = *id;
+    return NO_ERROR;
+}
+
+int16_t sps30_identity_get(uint16_t port, struct sps30_identity* identity) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    if (!identity_table[port].valid) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    *identity = identity_table[port].identity;
+    return NO_ERROR;
+}
+
+void sps30_identity_invalidate(uint16_t port) {
+    if (port < SENSIRION_UART_MAX_PORTS) {
+        identity_table[port].valid = false;
+        identity_table[port].has_device_information = false;
+    }
+}
+
+void sps30_identity_set_device_information(uint16_t port,
+                                           const int8_t* product_type,
+                                           const int8_t* serial_number) {
+    struct sps30_identity* id;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return;
+    }
+    id = &identity_table[port].identity;
+    sensirion_common_copy_bytes((const uint8_t*)product_type,
+                                (uint8_t*)id->product_type,
+                                sizeof(id->product_type));
+    sensirion_common_copy_bytes((const uint8_t*)serial_number,
+                                (uint8_t*)id->serial_number,
+                                sizeof(id->serial_number));
+    id->product_type[sizeof(id->product_type) - 1] = 0;
+    id->serial_number[sizeof(id->serial_number) - 1] = 0;
+    identity_table[port].valid = false;
+    identity_table[port].has_device_information = true;
+}
+
+bool sps30_identity_supports(uint16_t capabilities) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+
+    if (port >= SENSIRION_UART_MAX_PORTS || !identity_table[port].valid) {
+        return true;
+    }
+    return (identity_table[port].identity.capabilities & capabilities) ==
+           capabilities;
+}
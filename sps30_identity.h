@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_identity.h
+ *
+ *  Identity of the SPS30 on every UART port: product type, serial number and
+ *  versions never change while a sensor is connected, so they are read once
+ *  and then served from a cache. The firmware version determines the
+ *  capabilities of the sensor, and the commands of sps30_uart.h which need a
+ *  capability the sensor lacks fail with SENSIRION_SHDLC_ERR_NOT_SUPPORTED
+ *  before anything is sent, once sps30_hooks.h is installed. As long as the
+ *  identity of a port was not read, all commands are sent.
+ *
+ *  sps30_discovery_scan() stores the product type and serial number it reads,
+ *  so that only the version is left to read for the sensors it found.
+ */
+#ifndef SPS30_IDENTITY_H
+#define SPS30_IDENTITY_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Sleep-Mode and wake-up, firmware 2.0 and later */
+#define SPS30_CAPABILITY_SLEEP 0x0001
+/** Unsigned 16-bit integer output format, firmware 2.0 and later */
+#define SPS30_CAPABILITY_UINT16_OUTPUT 0x0002
+/** Device status register, firmware 2.2 and later */
+#define SPS30_CAPABILITY_STATUS_REGISTER 0x0004
+
+struct sps30_identity {
+    int8_t product_type[9];    //< zero terminated
+    int8_t serial_number[32];  //< zero terminated
+    uint8_t firmware_major;
+    uint8_t firmware_minor;
+    uint8_t hardware_revision;
+    uint8_t shdlc_major;
+    uint8_t shdlc_minor;
+    uint16_t capabilities;  //< SPS30_CAPABILITY_* flags
+};
+
+/**
+ * sps30_identity_read() - Get the identity of the sensor on the selected
+ *                         port, reading it on the first call.
+ *
+ * @param identity Memory where the identity is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT if the
+ *         selected port is invalid, an error code of the failed command
+ *         otherwise
+ */
+int16_t sps30_identity_read(struct sps30_identity* identity);
+
+/**
+ * sps30_identity_get() - Get the cached identity of a port without any
+ *                        communication.
+ *
+ * @param port     UART port index
+ * @param identity Memory where the identity is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT if the
+ *         port is invalid, SENSIRION_SHDLC_ERR_NO_DATA if the identity of the
+ *         port was not read
+ */
+int16_t sps30_identity_get(uint16_t port, struct sps30_identity* identity);
+
+/**
+ * sps30_identity_invalidate() - Forget the identity of a port, e.g. after a
+ *                               different sensor was connected.
+ *
+ * @param port UART port index
+ */
+void sps30_identity_invalidate(uint16_t port);
+
+/**
+ * sps30_identity_set_device_information() - Store the product type and
+ *                                           serial number of a port read
+ *                                           elsewhere.
+ *
+ * Replaces the identity of the port, sps30_identity_read() then only reads
+ * the version. This is called by sps30_discovery_scan().
+ *
+ * @param port          UART port index
+ * @param product_type  Zero terminated product type
+ * @param serial_number Zero terminated serial number
+ */
+void sps30_identity_set_device_information(uint16_t port,
+                                           const int8_t* product_type,
+                                           const int8_t* serial_number);
+
+/**
+ * sps30_identity_supports() - Check the capabilities of the sensor on the
+ *                             selected port.
+ *
+ * @param capabilities SPS30_CAPABILITY_* flags
+ *
+ * @return false if the identity is known and lacks one of the capabilities
+ */
+bool sps30_identity_supports(uint16_t capabilities);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_IDENTITY_H
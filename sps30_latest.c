@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_latest.c
+ */
+#include "sps30_latest.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+
+static struct sps30_latest_table* latest_table;
+static const struct sps30_latest_entry latest_empty_entry = {{0}};
+
+/* make the sequence of the selected port odd, NULL if nothing is published */
+static struct sps30_latest_slot* sps30_latest_begin(void) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    struct sps30_latest_slot* slot;
+
+    if (latest_table == NULL || port >= SENSIRION_UART_MAX_PORTS) {
+        return NULL;
+    }
+    slot = &latest_table->slots[port];
+    slot->sequence = slot->sequence + 1;
+    /* readers see the odd sequence before any change to the entry */
+    SENSIRION_MEMORY_BARRIER();
+    return slot;
+}
+
+static void sps30_latest_end(struct sps30_latest_slot* slot) {
+    slot->entry.updated_us = sensirion_uart_hal_get_time_usec();
+    /* readers see the changes before the even sequence */
+    SENSIRION_MEMORY_BARRIER();
+    slot->sequence = slot->sequence + 1;
+}
+
+void sps30_latest_init(struct sps30_latest_table* table) {
+    uint16_t i;
+
+    sensirion_common_copy_bytes((const uint8_t*)SPS30_LATEST_MAGIC,
+                                (uint8_t*)table->magic, sizeof(table->magic));
+    table->version = SPS30_LATEST_VERSION;
+    table->slot_size = sizeof(struct sps30_latest_slot);
+    table->port_count = SENSIRION_UART_MAX_PORTS;
+    for (i = 0; i < 3; i++) {
+        table->reserved[i] = 0;
+    }
+    for (i = 0; i < SENSIRION_UART_MAX_PORTS; i++) {
+        table->slots[i].sequence = 0;
+        table->slots[i].reserved = 0;
+        table->slots[i].entry = latest_empty_entry;
+    }
+    SENSIRION_MEMORY_BARRIER();
+}
+
+int16_t sps30_latest_check(const struct sps30_latest_table* table) {
+    const char* magic = SPS30_LATEST_MAGIC;
+    uint16_t i;
+
+    for (i = 0; i < sizeof(table->magic); i++) {
+        if (table->magic[i] != magic[i]) {
+            return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+        }
+    }
+    if (table->version != SPS30_LATEST_VERSION ||
+        table->slot_size != sizeof(struct sps30_latest_slot) ||
+        table->port_count != SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    return NO_ERROR;
+}
+
+void sps30_latest_publish_to(struct sps30_latest_table* table) {
+    latest_table = table;
+}
+
+int16_t sps30_latest_read(const struct sps30_latest_table* table,
+                          uint16_t port, struct sps30_latest_entry* entry) {
+    const struct sps30_latest_slot* slot;
+    uint32_t sequence;
+    uint16_t attempt;
+
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    slot = &table->slots[port];
+    for (attempt = 0; attempt < SPS30_LATEST_READ_ATTEMPTS; attempt++) {
+        sequence = slot->sequence;
+        if (sequence == 0) {
+            return SENSIRION_SHDLC_ERR_NO_DATA;
+        }
+        if ((sequence & 1) != 0) {
+            continue;
+        }
+        SENSIRION_MEMORY_BARRIER();
+        *entry = slot->entry;
+        /* the copy is complete before the sequence is read again */
+        SENSIRION_MEMORY_BARRIER();
+        if (slot->sequence == sequence) {
+            return NO_ERROR;
+        }
+    }
+    return SENSIRION_SHDLC_ERR_NO_DATA;
+}
+
+void sps30_latest_sample_read(int16_t error,
+                              const struct sps30_sample* sample) {
+    struct sps30_latest_slot* slot;
+
+    if (error == SENSIRION_SHDLC_ERR_NO_DATA) {
+        return;
+    }
+    slot = sps30_latest_begin();
+    if (slot == NULL) {
+        return;
+    }
+    if (error == NO_ERROR) {
+        slot->entry.sample = *sample;
+        slot->entry.samples++;
+    } else {
+        slot->entry.last_error = error;
+    }
+    sps30_latest_end(slot);
+}
+
+void sps30_latest_device_status_read(uint32_t device_status) {
+    struct sps30_latest_slot* slot = sps30_latest_begin();
+
+    if (slot == NULL) {
+        return;
+    }
+    slot->entry.device_status = device_status;
+    slot->entry.device_status_time_us = sensirion_uart_hal_get_time_usec();
+    sps30_latest_end(slot);
+}
+
+void sps30_latest_health_updated(sps30_health_state state) {
+    uint16_t port = sensirion_uart_hal_get_selected_port();
+    struct sps30_latest_slot* slot;
+
+    /* most updates confirm the state, the writer reads its own entry */
+    if (latest_table == NULL || port >= SENSIRION_UART_MAX_PORTS ||
+        latest_table->slots[port].entry.health == (uint8_t)state) {
+        return;
+    }
+    slot = sps30_latest_begin();
+    slot->entry.health = (uint8_t)state;
+    sps30_latest_end(slot);
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_latest.h
+ *
+ *  Table of the latest measurement values, device status and health of the
+ *  SPS30 on every UART port, for readers in other threads or processes.
+ *
+ *  The process owning the serial ports publishes to a table with
+ *  sps30_latest_publish_to(). sps30_sample_read(),
+ *  sps30_read_device_status_register() and sps30_health_update() then update
+ *  the entry of the selected port, nothing else is needed. The table has a
+ *  fixed layout without pointers, so it can be placed in shared memory, see
+ *  sample-implementations/linux_user_space/sps30_latest_shm.h. Readers call
+ *  sps30_latest_read() at any rate without a transaction on the UART and
+ *  without a round trip to the owner.
+ *
+ *  Every entry is protected by a sequence counter (seqlock): the writer makes
+ *  it odd before and even after an update, a reader copies the entry and
+ *  retries if the counter was odd or changed meanwhile. The writer never
+ *  waits for readers and readers never block each other.
+ *
+ *  There must be only one writing thread per table.
+ */
+#ifndef SPS30_LATEST_H
+#define SPS30_LATEST_H
+
+#include "sensirion_config.h"
+#include "sensirion_uart_portdescriptor.h"
+#include "sps30_health.h"
+#include "sps30_sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPS30_LATEST_MAGIC "S30L"
+#define SPS30_LATEST_VERSION 1
+
+/** Copies sps30_latest_read() attempts before it gives up on a busy entry */
+#ifndef SPS30_LATEST_READ_ATTEMPTS
+#define SPS30_LATEST_READ_ATTEMPTS 100
+#endif
+
+struct sps30_latest_entry {
+    struct sps30_sample sample;      //< latest measurement values
+    uint64_t updated_us;             //< HAL clock of the last update
+    uint64_t device_status_time_us;  //< HAL clock of the status read, 0 never
+    uint32_t device_status;          //< latest device status register
+    uint32_t samples;                //< samples published in total
+    int16_t last_error;              //< result of the last failed read
+    uint8_t health;                  //< sps30_health_state
+    uint8_t reserved;                //< always 0
+};
+
+/* the members are private, use the functions below */
+struct sps30_latest_slot {
+    volatile uint32_t sequence;  //< odd while the entry is written
+    uint32_t reserved;
+    struct sps30_latest_entry entry;
+};
+
+struct sps30_latest_table {
+    char magic[4];        //< SPS30_LATEST_MAGIC
+    uint16_t version;     //< SPS30_LATEST_VERSION
+    uint16_t slot_size;   //< size of struct sps30_latest_slot
+    uint16_t port_count;  //< SENSIRION_UART_MAX_PORTS of the writer
+    uint16_t reserved[3];
+    struct sps30_latest_slot slots[SENSIRION_UART_MAX_PORTS];
+};
+
+/**
+ * sps30_latest_init() - Write the header and empty entries to a table.
+ *
+ * @param table Table to set up
+ */
+void sps30_latest_init(struct sps30_latest_table* table);
+
+/**
+ * sps30_latest_check() - Check that a table was set up by a writer with the
+ *                        same layout as the reader.
+ *
+ * @param table Table to check
+ *
+ * @return NO_ERROR if the table can be read,
+ *         SENSIRION_SHDLC_ERR_INVALID_ARGUMENT otherwise.
+ */
+int16_t sps30_latest_check(const struct sps30_latest_table* table);
+
+/**
+ * sps30_latest_publish_to() - Publish the driver state to a table from now
+ *                             on.
+ *
+ * @param table Table set up with sps30_latest_init(), NULL stops publishing
+ */
+void sps30_latest_publish_to(struct sps30_latest_table* table);
+
+/**
+ * sps30_latest_read() - Copy the latest entry of a port.
+ *
+ * Never waits for the writer. This may be called from any thread or process
+ * which has access to the table.
+ *
+ * @param table Table to read from
+ * @param port  UART port index, see sensirion_uart_hal_select_port()
+ * @param entry Memory where the entry is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT for an
+ *         invalid port, SENSIRION_SHDLC_ERR_NO_DATA for a port without any
+ *         update yet, or when no consistent copy was made within
+ *         SPS30_LATEST_READ_ATTEMPTS, e.g. because the writer stopped during
+ *         an update.
+ */
+int16_t sps30_latest_read(const struct sps30_latest_table* table,
+                          uint16_t port, struct sps30_latest_entry* entry);
+
+/**
+ * sps30_latest_sample_read() - Publish the result of a sample read on the
+ *                              selected port.
+ *
+ * This is called by sps30_sample_read(). SENSIRION_SHDLC_ERR_NO_DATA is not
+ * a failure and is not published.
+ *
+ * @param error  Result of the read
+ * @param sample Sample read, only used on success
+ */
+void sps30_latest_sample_read(int16_t error, const struct sps30_sample* sample);
+
+/**
+ * sps30_latest_device_status_read() - Publish the device status register of
+ *                                     the selected port.
+ *
+ * This is called through sps30_hooks.h when
+ * sps30_read_device_status_register() succeeds.
+ *
+ * @param device_status Value of the device status register
+ */
+void sps30_latest_device_status_read(uint32_t device_status);
+
+/**
+ * sps30_latest_health_updated() - Publish the health of the selected port
+ *                                 if it changed.
+ *
+ * This is called by sps30_health_update().
+ *
+ * @param state Health state after the update
+ */
+void sps30_latest_health_updated(sps30_health_state state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_LATEST_H
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_log.c
+ */
+#include "sps30_log.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+
+/* CRC-8 of the Sensirion sensors, polynomial 0x31, initialization 0xff */
+static uint8_t sps30_log_crc(const uint8_t* data, size_t size) {
+    uint8_t crc = 0xff;
+    uint8_t bit;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (bit = 0; bit < 8; bit++) {
+            if ((crc & 0x80) != 0) {
+                crc = (uint8_t)((crc << 1) ^ 0x31);
+            } else {
+                crc = (uint8_t)(crc << 1);
+            }
+        }
+    }
+    return crc;
+}
+
+/* small positive and negative differences both become small numbers */
+static uint64_t sps30_log_zigzag(uint64_t difference) {
+    return (difference << 1) ^ ((uint64_t)0 - (difference >> 63));
+}
+
+static uint64_t sps30_log_unzigzag(uint64_t value) {
+    return (value >> 1) ^ ((uint64_t)0 - (value & 1));
+}
+
+static uint8_t sps30_log_put_varint(uint8_t* buffer, uint64_t value) {
+    uint8_t len = 0;
+
+    while (value >= 0x80) {
+        buffer[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[len++] = (uint8_t)value;
+    return len;
+}
+
+static bool sps30_log_get_varint(const uint8_t* data, size_t end,
+                                 size_t* offset, uint64_t* value) {
+    uint64_t result = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+
+    do {
+        if (*offset >= end || shift > 63) {
+            return false;
+        }
+        byte = data[(*offset)++];
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        shift = (uint8_t)(shift + 7);
+    } while ((byte & 0x80) != 0);
+    *value = result;
+    return true;
+}
+
+/*
+ * Difference of the uint16 format, or XOR of the float format. Close floats
+ * share their high bits, round ones also their low bits, so the XOR drops
+ * its zero low bytes and stores their number in the two lowest bits.
+ */
+static uint64_t sps30_log_field_delta(uint8_t format, uint32_t value,
+                                      uint32_t previous) {
+    uint32_t xor_value = value ^ previous;
+    uint8_t zero_bytes = 0;
+
+    if (format != SPS30_LOG_FORMAT_FLOAT) {
+        return sps30_log_zigzag(
+            (uint64_t)(int64_t)(int32_t)(value - previous));
+    }
+    while (xor_value != 0 && zero_bytes < 3 && (xor_value & 0xff) == 0) {
+        xor_value >>= 8;
+        zero_bytes++;
+    }
+    return ((uint64_t)xor_value << 2) | zero_bytes;
+}
+
+static bool sps30_log_field_apply(uint8_t format, uint64_t delta,
+                                  uint32_t previous, uint32_t* value) {
+    uint8_t shift;
+
+    if (format != SPS30_LOG_FORMAT_FLOAT) {
+        *value = previous + (uint32_t)sps30_log_unzigzag(delta);
+        return true;
+    }
+    shift = (uint8_t)((delta & 3) * 8);
+    delta >>= 2;
+    if ((delta >> (32 - shift)) != 0) {
+        return false;
+    }
+    *value = (uint32_t)(delta << shift) ^ previous;
+    return true;
+}
+
+void sps30_log_header_init(struct sps30_log_header* header,
+                           sps30_log_format format,
+                           const struct sps30_identity* identity) {
+    uint16_t i;
+
+    sensirion_common_copy_bytes((const uint8_t*)SPS30_LOG_MAGIC,
+                                (uint8_t*)header->magic, sizeof(header->magic));
+    header->version = SPS30_LOG_VERSION;
+    header->format = (uint8_t)format;
+    header->firmware_major = identity->firmware_major;
+    header->firmware_minor = identity->firmware_minor;
+    header->hardware_revision = identity->hardware_revision;
+    header->reserved = 0;
+    for (i = 0; i < sizeof(header->product_type); i++) {
+        header->product_type[i] = 0;
+    }
+    sensirion_common_copy_bytes((const uint8_t*)identity->product_type,
+                                (uint8_t*)header->product_type,
+                                sizeof(identity->product_type));
+    sensirion_common_copy_bytes((const uint8_t*)identity->serial_number,
+                                (uint8_t*)header->serial_number,
+                                sizeof(header->serial_number));
+}
+
+void sps30_log_codec_init(struct sps30_log_codec* codec,
+                          sps30_log_format format) {
+    uint16_t i;
+
+    codec->format = (uint8_t)format;
+    codec->previous.timestamp_us = 0;
+    for (i = 0; i < SPS30_LOG_FIELD_COUNT; i++) {
+        codec->previous.fields[i] = 0;
+    }
+}
+
+uint8_t sps30_log_encode(struct sps30_log_codec* codec,
+                         const struct sps30_log_record* record,
+                         uint8_t* buffer) {
+    uint64_t delta;
+    uint8_t len = 1;
+    uint16_t i;
+
+    delta = sps30_log_zigzag(record->timestamp_us -
+                             codec->previous.timestamp_us);
+    len = (uint8_t)(len + sps30_log_put_varint(&buffer[len], delta));
+    for (i = 0; i < SPS30_LOG_FIELD_COUNT; i++) {
+        delta = sps30_log_field_delta(codec->format, record->fields[i],
+                                      codec->previous.fields[i]);
+        len = (uint8_t)(len + sps30_log_put_varint(&buffer[len], delta));
+    }
+    buffer[0] = (uint8_t)(len - 1);
+    buffer[len] = sps30_log_crc(buffer, len);
+    codec->previous = *record;
+    return (uint8_t)(len + 1);
+}
+
+int16_t sps30_log_decode(struct sps30_log_codec* codec, const uint8_t* data,
+                         size_t size, struct sps30_log_record* record,
+                         size_t* record_size) {
+    struct sps30_log_record decoded;
+    size_t offset = 1;
+    uint64_t delta;
+    size_t end;
+    uint16_t i;
+
+    /* a zero length is never written, it marks zeroed space after a crash */
+    if (size < 2 || data[0] == 0 || size < (size_t)data[0] + 2) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    end = (size_t)data[0] + 1;
+    if (sps30_log_crc(data, end) != data[end]) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    if (!sps30_log_get_varint(data, end, &offset, &delta)) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    decoded.timestamp_us =
+        codec->previous.timestamp_us + sps30_log_unzigzag(delta);
+    for (i = 0; i < SPS30_LOG_FIELD_COUNT; i++) {
+        if (!sps30_log_get_varint(data, end, &offset, &delta) ||
+            !sps30_log_field_apply(codec->format, delta,
+                                   codec->previous.fields[i],
+                                   &decoded.fields[i])) {
+            return SENSIRION_SHDLC_ERR_NO_DATA;
+        }
+    }
+    if (offset != end) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    codec->previous = decoded;
+    *record = decoded;
+    *record_size = end + 1;
+    return NO_ERROR;
+}
+
+void sps30_log_record_from_sample(struct sps30_log_record* record,
+                                  const struct sps30_sample* sample) {
+    const float values[SPS30_LOG_FIELD_COUNT] = {
+        sample->mc_1p0,  sample->mc_2p5, sample->mc_4p0,
+        sample->mc_10p0, sample->nc_0p5, sample->nc_1p0,
+        sample->nc_2p5,  sample->nc_4p0, sample->nc_10p0,
+        sample->typical_particle_size};
+    union {
+        uint32_t u32_value;
+        float float32;
+    } tmp;
+    uint16_t i;
+
+    record->timestamp_us = sample->timestamp_us;
+    for (i = 0; i < SPS30_LOG_FIELD_COUNT; i++) {
+        tmp.float32 = values[i];
+        record->fields[i] = tmp.u32_value;
+    }
+}
+
+void sps30_log_record_to_sample(const struct sps30_log_record* record,
+                                struct sps30_sample* sample) {
+    float* values[SPS30_LOG_FIELD_COUNT] = {
+        &sample->mc_1p0,  &sample->mc_2p5, &sample->mc_4p0,
+        &sample->mc_10p0, &sample->nc_0p5, &sample->nc_1p0,
+        &sample->nc_2p5,  &sample->nc_4p0, &sample->nc_10p0,
+        &sample->typical_particle_size};
+    union {
+        uint32_t u32_value;
+        float float32;
+    } tmp;
+    uint16_t i;
+
+    sample->timestamp_us = record->timestamp_us;
+    for (i = 0; i < SPS30_LOG_FIELD_COUNT; i++) {
+        tmp.u32_value = record->fields[i];
+        *values[i] = tmp.float32;
+    }
+}
+
+int16_t sps30_log_reader_init(struct sps30_log_reader* reader,
+                              const uint8_t* data, size_t size) {
+    const char* magic = SPS30_LOG_MAGIC;
+    uint16_t i;
+
+    if (size < sizeof(reader->header)) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    sensirion_common_copy_bytes(data, (uint8_t*)&reader->header,
+                                sizeof(reader->header));
+    for (i = 0; i < sizeof(reader->header.magic); i++) {
+        if (reader->header.magic[i] != magic[i]) {
+            return SENSIRION_SHDLC_ERR_NO_DATA;
+        }
+    }
+    if (reader->header.version != SPS30_LOG_VERSION ||
+        reader->header.format > SPS30_LOG_FORMAT_FLOAT) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
+    }
+    reader->data = data;
+    reader->size = size;
+    reader->offset = sizeof(reader->header);
+    sps30_log_codec_init(&reader->codec,
+                         (sps30_log_format)reader->header.format);
+    return NO_ERROR;
+}
+
+int16_t sps30_log_reader_next(struct sps30_log_reader* reader,
+                              struct sps30_log_record* record) {
+    size_t record_size;
+    int16_t error;
+
+    error = sps30_log_decode(&reader->codec, &reader->data[reader->offset],
+                             reader->size - reader->offset, record,
+                             &record_size);
+    if (error != NO_ERROR) {
+        return error;
+    }
+    reader->offset += record_size;
+    return NO_ERROR;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_log.h
+ *
+ *  Compact binary time series of the measurement values of one SPS30. A log
+ *  starts with struct sps30_log_header, which holds the identity of the
+ *  sensor and the output format of the values, followed by the records,
+ *  oldest first. The header is in host byte order, the records are byte
+ *  streams.
+ *
+ *  A record stores the difference to the previous record of the log: the
+ *  timestamp and, in the uint16 format, every value as a zigzag encoded
+ *  difference, in the float format every value as the XOR of its bits with
+ *  the previous bits, without the zero low bytes of the XOR. Both end up as
+ *  variable length integers of 7 bits per byte, so slowly changing values
+ *  take one or two bytes, noisy floats about three. Every record is
+ *  framed by its length and a CRC-8, a record cut short by a crash or
+ *  overwritten with garbage ends the log.
+ *
+ *  Encoding and decoding only work on memory. See
+ *  sample-implementations/linux_user_space/sps30_log_file.h for append-only
+ *  files and for readers which map them.
+ */
+#ifndef SPS30_LOG_H
+#define SPS30_LOG_H
+
+#include "sensirion_config.h"
+#include "sps30_identity.h"
+#include "sps30_sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPS30_LOG_MAGIC "S30T"
+#define SPS30_LOG_VERSION 1
+
+/** Values of a sample, in the order of sps30_read_measurement_values_*() */
+#define SPS30_LOG_FIELD_COUNT 10
+
+/** Length byte, timestamp, values and CRC of the largest record */
+#define SPS30_LOG_MAX_RECORD_SIZE (1 + 10 + SPS30_LOG_FIELD_COUNT * 5 + 1)
+
+typedef enum {
+    SPS30_LOG_FORMAT_UINT16 = 0,  //< sps30_read_measurement_values_uint16()
+    SPS30_LOG_FORMAT_FLOAT,       //< sps30_read_measurement_values_float()
+} sps30_log_format;
+
+struct sps30_log_header {
+    char magic[4];              //< SPS30_LOG_MAGIC
+    uint16_t version;           //< SPS30_LOG_VERSION
+    uint8_t format;             //< sps30_log_format
+    uint8_t firmware_major;     //< firmware of the sensor
+    uint8_t firmware_minor;     //< firmware of the sensor
+    uint8_t hardware_revision;  //< hardware of the sensor
+    uint16_t reserved;          //< always 0
+    int8_t product_type[12];    //< zero terminated
+    int8_t serial_number[32];   //< zero terminated
+};
+
+struct sps30_log_record {
+    uint64_t timestamp_us;                   //< HAL clock or wall clock
+    uint32_t fields[SPS30_LOG_FIELD_COUNT];  //< values or bits of floats
+};
+
+/* the members are private, the previous record of a writer or reader */
+struct sps30_log_codec {
+    uint8_t format;
+    struct sps30_log_record previous;
+};
+
+struct sps30_log_reader {
+    struct sps30_log_header header;  //< header of the log
+    const uint8_t* data;             //< log starting with the header
+    size_t size;                     //< size of the log
+    size_t offset;                   //< start of the next record
+    struct sps30_log_codec codec;
+};
+
+/**
+ * sps30_log_header_init() - Set up the header of a new log.
+ *
+ * @param header   Header to set up
+ * @param format   Output format of the values
+ * @param identity Identity of the sensor, see sps30_identity_read()
+ */
+void sps30_log_header_init(struct sps30_log_header* header,
+                           sps30_log_format format,
+                           const struct sps30_identity* identity);
+
+/**
+ * sps30_log_codec_init() - Start encoding or decoding the records of a log
+ *                          with its first record.
+ *
+ * @param codec  Codec to set up
+ * @param format Output format of the log
+ */
+void sps30_log_codec_init(struct sps30_log_codec* codec,
+                          sps30_log_format format);
+
+/**
+ * sps30_log_encode() - Encode the next record of a log.
+ *
+ * @param codec  Codec of the log
+ * @param record Record to encode, its timestamp may go backwards
+ * @param buffer Memory of SPS30_LOG_MAX_RECORD_SIZE bytes for the record
+ *
+ * @return Size of the encoded record
+ */
+uint8_t sps30_log_encode(struct sps30_log_codec* codec,
+                         const struct sps30_log_record* record,
+                         uint8_t* buffer);
+
+/**
+ * sps30_log_decode() - Decode the next record of a log.
+ *
+ * @param codec       Codec of the log
+ * @param data        Memory starting with the record
+ * @param size        Bytes available at data
+ * @param record      Memory where the record is stored
+ * @param record_size Set to the size of the encoded record
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_NO_DATA if the record is
+ *         incomplete or damaged. The codec is not changed then.
+ */
+int16_t sps30_log_decode(struct sps30_log_codec* codec, const uint8_t* data,
+                         size_t size, struct sps30_log_record* record,
+                         size_t* record_size);
+
+/**
+ * sps30_log_record_from_sample() - Store a sample of the float format in a
+ *                                  record.
+ *
+ * @param record Record to fill
+ * @param sample Sample read with sps30_sample_read()
+ */
+void sps30_log_record_from_sample(struct sps30_log_record* record,
+                                  const struct sps30_sample* sample);
+
+/**
+ * sps30_log_record_to_sample() - Get the sample of a record of the float
+ *                                format.
+ *
+ * @param record Record of a float log
+ * @param sample Memory where the sample is stored
+ */
+void sps30_log_record_to_sample(const struct sps30_log_record* record,
+                                struct sps30_sample* sample);
+
+/**
+ * sps30_log_reader_init() - Start reading a log in memory, e.g. a mapped
+ *                           file.
+ *
+ * @param reader Reader to set up
+ * @param data   Log starting with the header
+ * @param size   Size of the log
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_NO_DATA if the log does
+ *         not start with a header of this version.
+ */
+int16_t sps30_log_reader_init(struct sps30_log_reader* reader,
+                              const uint8_t* data, size_t size);
+
+/**
+ * sps30_log_reader_next() - Read the next record.
+ *
+ * @param reader Reader of the log
+ * @param record Memory where the record is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_NO_DATA at the end of the
+ *         log or at a damaged record, after which reader->offset is the end
+ *         of the valid records.
+ */
+int16_t sps30_log_reader_next(struct sps30_log_reader* reader,
+                              struct sps30_log_record* record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_LOG_H
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_ring.c
+ */
+#include "sps30_ring.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+
+int16_t sps30_ring_init(struct sps30_ring* ring,
+                        struct sps30_ring_record* records, uint32_t capacity) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        return SENSIRION_SHDLC_ERR_INVALID_ARGUMENT;
+    }
+    ring->head = 0;
+    ring->cached_tail = 0;
+    ring->dropped = 0;
+    ring->tail = 0;
+    ring->cached_head = 0;
+    ring->mask = capacity - 1;
+    ring->records = records;
+    SENSIRION_MEMORY_BARRIER();
+    return NO_ERROR;
+}
+
+bool sps30_ring_push(struct sps30_ring* ring,
+                     const struct sps30_ring_record* record) {
+    uint32_t head = ring->head;
+
+    if (head - ring->cached_tail > ring->mask) {
+        ring->cached_tail = ring->tail;
+        /* the consumer copied the record out before it advanced the tail */
+        SENSIRION_MEMORY_BARRIER();
+        if (head - ring->cached_tail > ring->mask) {
+            ring->dropped++;
+            return false;
+        }
+    }
+    ring->records[head & ring->mask] = *record;
+    /* publish the record before the index */
+    SENSIRION_MEMORY_BARRIER();
+    ring->head = head + 1;
+    return true;
+}
+
+int16_t sps30_ring_acquire(struct sps30_ring* ring) {
+    struct sps30_ring_record record;
+    int16_t error;
+
+    record.port = sensirion_uart_hal_get_selected_port();
+    error = sps30_sample_read(&record.sample);
+    if (error != NO_ERROR) {
+        return error;
+    }
+    (void)sps30_ring_push(ring, &record);
+    return NO_ERROR;
+}
+
+uint32_t sps30_ring_drain(struct sps30_ring* ring,
+                          struct sps30_ring_record* records,
+                          uint32_t max_records) {
+    uint32_t tail = ring->tail;
+    uint32_t available = ring->cached_head - tail;
+    uint32_t i;
+
+    if (available < max_records) {
+        ring->cached_head = ring->head;
+        /* the producer published the records before it advanced the head */
+        SENSIRION_MEMORY_BARRIER();
+        available = ring->cached_head - tail;
+    }
+    if (available > max_records) {
+        available = max_records;
+    }
+    for (i = 0; i < available; i++) {
+        records[i] = ring->records[(tail + i) & ring->mask];
+    }
+    /* release the slots only after they were copied */
+    SENSIRION_MEMORY_BARRIER();
+    ring->tail = tail + available;
+    return available;
+}
+
+uint32_t sps30_ring_get_count(const struct sps30_ring* ring) {
+    uint32_t tail = ring->tail;
+
+    return ring->head - tail;
+}
+
+uint32_t sps30_ring_get_dropped(const struct sps30_ring* ring) {
+    return ring->dropped;
+}
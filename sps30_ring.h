@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_ring.h
+ *
+ *  Lock-free single-producer/single-consumer ring of timestamped samples,
+ *  which decouples the thread polling the sensors from the consumers of the
+ *  samples. The acquisition thread pushes every sample it reads, another
+ *  thread drains them in batches and may block on disk or network I/O
+ *  without delaying the next transaction.
+ *
+ *  Exactly one thread may push and exactly one thread may drain a ring. The
+ *  index written by the producer and the one written by the consumer are
+ *  kept on separate cache lines of SENSIRION_CACHE_LINE_SIZE bytes, and each
+ *  side caches the index of the other, so a push or a drain only touches the
+ *  shared line of the other side when its cached copy runs out. Ordering is
+ *  provided by SENSIRION_MEMORY_BARRIER().
+ *
+ *  The ring is aligned to a cache line with SENSIRION_CACHE_ALIGNED, so
+ *  static and automatic rings start on a line of their own. Allocate rings on
+ *  the heap with aligned_alloc() or posix_memalign().
+ *
+ *  A full ring drops the new sample and counts it, the acquisition never
+ *  waits for a consumer.
+ */
+#ifndef SPS30_RING_H
+#define SPS30_RING_H
+
+#include "sensirion_config.h"
+#include "sps30_sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sps30_ring_record {
+    uint16_t port;  //< UART port index of the sensor
+    struct sps30_sample sample;
+};
+
+/* the members are private, use the functions below */
+struct sps30_ring {
+    /* written by the producer */
+    volatile uint32_t head;  //< records pushed
+    uint32_t cached_tail;    //< tail as last seen by the producer
+    volatile uint32_t dropped;
+    uint8_t producer_padding[SENSIRION_CACHE_LINE_SIZE - 3 * sizeof(uint32_t)];
+    /* written by the consumer */
+    volatile uint32_t tail;  //< records drained
+    uint32_t cached_head;    //< head as last seen by the consumer
+    uint8_t consumer_padding[SENSIRION_CACHE_LINE_SIZE - 2 * sizeof(uint32_t)];
+    /* constant after sps30_ring_init() */
+    uint32_t mask;
+    struct sps30_ring_record* records;
+} SENSIRION_CACHE_ALIGNED;
+
+/**
+ * sps30_ring_init() - Set up an empty ring on the given storage.
+ *
+ * @param ring     Ring to set up
+ * @param records  Storage of the records, owned by the caller
+ * @param capacity Number of records, a power of two of at least 2
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_INVALID_ARGUMENT if the
+ *         capacity is not a power of two of at least 2.
+ */
+int16_t sps30_ring_init(struct sps30_ring* ring,
+                        struct sps30_ring_record* records, uint32_t capacity);
+
+/**
+ * sps30_ring_push() - Append a record, producer only.
+ *
+ * @param ring   Ring
+ * @param record Record to append
+ *
+ * @return true if the record was appended, false if the ring was full and
+ *         the record was dropped.
+ */
+bool sps30_ring_push(struct sps30_ring* ring,
+                     const struct sps30_ring_record* record);
+
+/**
+ * sps30_ring_acquire() - Read the measurement values of the selected port
+ *                        and append them, producer only.
+ *
+ * @param ring Ring
+ *
+ * @return NO_ERROR if a sample was read, also when the full ring dropped it,
+ *         an error code of sps30_sample_read() otherwise.
+ */
+int16_t sps30_ring_acquire(struct sps30_ring* ring);
+
+/**
+ * sps30_ring_drain() - Remove the oldest records, consumer only.
+ *
+ * @param ring        Ring
+ * @param records     Memory where the records are copied to
+ * @param max_records Maximum number of records to remove
+ *
+ * @return Number of records removed, 0 if the ring is empty
+ */
+uint32_t sps30_ring_drain(struct sps30_ring* ring,
+                          struct sps30_ring_record* records,
+                          uint32_t max_records);
+
+/**
+ * sps30_ring_get_count() - Number of records waiting to be drained.
+ *
+ * The number is a snapshot, the producer may have appended more since.
+ *
+ * @param ring Ring
+ */
+uint32_t sps30_ring_get_count(const struct sps30_ring* ring);
+
+/**
+ * sps30_ring_get_dropped() - Number of records dropped because the ring was
+ *                            full, since sps30_ring_init().
+ *
+ * @param ring Ring
+ */
+uint32_t sps30_ring_get_dropped(const struct sps30_ring* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_RING_H
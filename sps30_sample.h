@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  @file sps30_sample.h
+ *
+ *  One set of measurement values of the SPS30 in the float output format,
+ *  with the time it was read. The modules which take samples on their own,
+ *  like sps30_duty_cycle.h and sps30_fast_start.h, return this struct.
+ */
+#ifndef SPS30_SAMPLE_H
+#define SPS30_SAMPLE_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sps30_sample {
+    float mc_1p0;                 //< Mass Concentration PM1.0 [µg/m³]
+    float mc_2p5;                 //< Mass Concentration PM2.5 [µg/m³]
+    float mc_4p0;                 //< Mass Concentration PM4.0 [µg/m³]
+    float mc_10p0;                //< Mass Concentration PM10.0 [µg/m³]
+    float nc_0p5;                 //< Number Concentration PM0.5 [#/cm³]
+    float nc_1p0;                 //< Number Concentration PM1.0 [#/cm³]
+    float nc_2p5;                 //< Number Concentration PM2.5 [#/cm³]
+    float nc_4p0;                 //< Number Concentration PM4.0 [#/cm³]
+    float nc_10p0;                //< Number Concentration PM10.0 [#/cm³]
+    float typical_particle_size;  //< Typical Particle Size [µm]
+    uint64_t timestamp_us;        //< HAL clock when the sample was read
+};
+
+/**
+ * sps30_sample_read() - Read the measurement values of the selected port.
+ *
+ * The measurement must run in the float output format.
+ *
+ * @param sample Memory where the sample is stored
+ *
+ * @return NO_ERROR on success, SENSIRION_SHDLC_ERR_NO_DATA if the sensor has
+ *         no new values since the last read, an error code of
+ *         sps30_read_measurement_values_float() otherwise.
+ */
+int16_t sps30_sample_read(struct sps30_sample* sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SPS30_SAMPLE_H
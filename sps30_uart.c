@@ -65,11 +65,9 @@ int16_t sps30_start_measurement(sps30_output_format measurement_output_format) {
     uint8_t* buffer_ptr = communication_buffer;
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0x0, SPS30_SHDLC_ADDR, 2);
     sensirion_add_uint16_t_argument(&stream, measurement_output_format);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 0, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 0, &header, SPS30_START_MEASUREMENT_TIMEOUT_MS,
+        SENSIRION_SHDLC_ATTEMPT_ONCE);
     return local_error;
 }
 
@@ -79,11 +77,9 @@ int16_t sps30_stop_measurement() {
     int16_t local_error = NO_ERROR;
     uint8_t* buffer_ptr = communication_buffer;
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0x1, SPS30_SHDLC_ADDR, 0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 0, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 0, &header, SPS30_STOP_MEASUREMENT_TIMEOUT_MS,
+        SENSIRION_SHDLC_ATTEMPT_ONCE);
     return local_error;
 }
 
@@ -96,11 +92,13 @@ int16_t sps30_read_measurement_values_uint16(
     int16_t local_error = NO_ERROR;
     uint8_t* buffer_ptr = communication_buffer;
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0x3, SPS30_SHDLC_ADDR, 0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
+    local_error = sensirion_shdlc_transceive(
+        &stream, 20, &header, SPS30_READ_MEASUREMENT_VALUES_TIMEOUT_MS,
+        SENSIRION_SHDLC_REPEAT_UNANSWERED);
+    /* the sensor sends an empty frame if it has no new values */
+    if (local_error == NO_ERROR && header.data_len == 0) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
     }
-    local_error = sensirion_shdlc_read_response(&stream, 20, &header, 50);
     *mc_1p0 = sensirion_common_bytes_to_uint16_t(&buffer_ptr[0]);
     *mc_2p5 = sensirion_common_bytes_to_uint16_t(&buffer_ptr[2]);
     *mc_4p0 = sensirion_common_bytes_to_uint16_t(&buffer_ptr[4]);
@@ -126,11 +124,13 @@ int16_t sps30_read_measurement_values_float(float* mc_1p0, float* mc_2p5,
     int16_t local_error = NO_ERROR;
     uint8_t* buffer_ptr = communication_buffer;
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0x3, SPS30_SHDLC_ADDR, 0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
+    local_error = sensirion_shdlc_transceive(
+        &stream, 40, &header, SPS30_READ_MEASUREMENT_VALUES_TIMEOUT_MS,
+        SENSIRION_SHDLC_REPEAT_UNANSWERED);
+    /* the sensor sends an empty frame if it has no new values */
+    if (local_error == NO_ERROR && header.data_len == 0) {
+        return SENSIRION_SHDLC_ERR_NO_DATA;
     }
-    local_error = sensirion_shdlc_read_response(&stream, 40, &header, 50);
     *mc_1p0 = sensirion_common_bytes_to_float(&buffer_ptr[0]);
     *mc_2p5 = sensirion_common_bytes_to_float(&buffer_ptr[4]);
     *mc_4p0 = sensirion_common_bytes_to_float(&buffer_ptr[8]);
@@ -151,11 +151,9 @@ int16_t sps30_sleep() {
     uint8_t* buffer_ptr = communication_buffer;
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0x10, SPS30_SHDLC_ADDR,
                                  0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 0, &header, 50);
+    local_error =
+        sensirion_shdlc_transceive(&stream, 0, &header, SPS30_SLEEP_TIMEOUT_MS,
+                                   SENSIRION_SHDLC_ATTEMPT_ONCE);
     return local_error;
 }
 
@@ -176,11 +174,9 @@ int16_t sps30_wake_up() {
     uint8_t* buffer_ptr = communication_buffer;
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0x11, SPS30_SHDLC_ADDR,
                                  0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 0, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 0, &header, SPS30_WAKE_UP_TIMEOUT_MS,
+        SENSIRION_SHDLC_ATTEMPT_ONCE);
     return local_error;
 }
 
@@ -191,11 +187,9 @@ int16_t sps30_start_fan_cleaning() {
     uint8_t* buffer_ptr = communication_buffer;
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0x56, SPS30_SHDLC_ADDR,
                                  0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 0, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 0, &header, SPS30_START_FAN_CLEANING_TIMEOUT_MS,
+        SENSIRION_SHDLC_ATTEMPT_ONCE);
     return local_error;
 }
 
@@ -207,11 +201,9 @@ int16_t sps30_read_auto_cleaning_interval(uint32_t* auto_cleaning_interval) {
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0x80, SPS30_SHDLC_ADDR,
                                  1);
     sensirion_add_uint8_t_argument(&stream, 0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 4, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 4, &header, SPS30_AUTO_CLEANING_INTERVAL_TIMEOUT_MS,
+        SENSIRION_SHDLC_IDEMPOTENT);
     *auto_cleaning_interval =
         sensirion_common_bytes_to_uint32_t(&buffer_ptr[0]);
     return local_error;
@@ -226,11 +218,9 @@ int16_t sps30_write_auto_cleaning_interval(uint32_t auto_cleaning_interval) {
                                  5);
     sensirion_add_uint8_t_argument(&stream, 0);
     sensirion_add_uint32_t_argument(&stream, auto_cleaning_interval);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 0, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 0, &header, SPS30_AUTO_CLEANING_INTERVAL_TIMEOUT_MS,
+        SENSIRION_SHDLC_IDEMPOTENT);
     return local_error;
 }
 
@@ -243,11 +233,9 @@ int16_t sps30_read_product_type(int8_t* product_type,
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0xd0, SPS30_SHDLC_ADDR,
                                  1);
     sensirion_add_uint8_t_argument(&stream, 0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 9, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 9, &header, SPS30_DEVICE_INFORMATION_TIMEOUT_MS,
+        SENSIRION_SHDLC_IDEMPOTENT);
     sensirion_common_copy_bytes(&buffer_ptr[0], (uint8_t*)product_type,
                                 product_type_size);
     return local_error;
@@ -262,11 +250,9 @@ int16_t sps30_read_serial_number(int8_t* serial_number,
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0xd0, SPS30_SHDLC_ADDR,
                                  1);
     sensirion_add_uint8_t_argument(&stream, 3);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 32, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 32, &header, SPS30_DEVICE_INFORMATION_TIMEOUT_MS,
+        SENSIRION_SHDLC_IDEMPOTENT);
     sensirion_common_copy_bytes(&buffer_ptr[0], (uint8_t*)serial_number,
                                 serial_number_size);
     return local_error;
@@ -283,11 +269,9 @@ int16_t sps30_read_version(uint8_t* firmware_major_version,
     uint8_t* buffer_ptr = communication_buffer;
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0xd1, SPS30_SHDLC_ADDR,
                                  0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 7, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 7, &header, SPS30_READ_VERSION_TIMEOUT_MS,
+        SENSIRION_SHDLC_IDEMPOTENT);
     *firmware_major_version = (uint8_t)buffer_ptr[0];
     *firmware_minor_version = (uint8_t)buffer_ptr[1];
     *reserved1 = (uint8_t)buffer_ptr[2];
@@ -308,11 +292,10 @@ int16_t sps30_read_device_status_register(bool clear_status_register,
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0xd2, SPS30_SHDLC_ADDR,
                                  1);
     sensirion_add_bool_argument(&stream, clear_status_register);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 5, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 5, &header, SPS30_READ_DEVICE_STATUS_REGISTER_TIMEOUT_MS,
+        clear_status_register ? SENSIRION_SHDLC_ATTEMPT_ONCE
+                              : SENSIRION_SHDLC_IDEMPOTENT);
     *device_status_register =
         sensirion_common_bytes_to_uint32_t(&buffer_ptr[0]);
     *reserved = (uint8_t)buffer_ptr[4];
@@ -326,10 +309,8 @@ int16_t sps30_device_reset() {
     uint8_t* buffer_ptr = communication_buffer;
     sensirion_shdlc_begin_stream(&stream, buffer_ptr, 0xd3, SPS30_SHDLC_ADDR,
                                  0);
-    local_error = sensirion_shdlc_write_request(&stream);
-    if (local_error) {
-        return local_error;
-    }
-    local_error = sensirion_shdlc_read_response(&stream, 0, &header, 50);
+    local_error = sensirion_shdlc_transceive(
+        &stream, 0, &header, SPS30_DEVICE_RESET_TIMEOUT_MS,
+        SENSIRION_SHDLC_ATTEMPT_ONCE);
     return local_error;
 }
@@ -64,6 +64,26 @@ typedef enum {
     SPS30_DEVICE_RESET_CMD_ID = 0xd3,
 } SPS30_CMD_ID;
 
+/*
+ * Response timeouts in milliseconds: the execution time of the command from
+ * the datasheet with margin for the transfer of the frames and the host.
+ * Starting a measurement and a device reset take longest, the sleep, wake-up
+ * and fan cleaning commands answer within 5 ms.
+ */
+typedef enum {
+    SPS30_START_MEASUREMENT_TIMEOUT_MS = 100,
+    SPS30_STOP_MEASUREMENT_TIMEOUT_MS = 50,
+    SPS30_READ_MEASUREMENT_VALUES_TIMEOUT_MS = 50,
+    SPS30_SLEEP_TIMEOUT_MS = 20,
+    SPS30_WAKE_UP_TIMEOUT_MS = 20,
+    SPS30_START_FAN_CLEANING_TIMEOUT_MS = 20,
+    SPS30_AUTO_CLEANING_INTERVAL_TIMEOUT_MS = 50,
+    SPS30_DEVICE_INFORMATION_TIMEOUT_MS = 50,
+    SPS30_READ_VERSION_TIMEOUT_MS = 50,
+    SPS30_READ_DEVICE_STATUS_REGISTER_TIMEOUT_MS = 50,
+    SPS30_DEVICE_RESET_TIMEOUT_MS = 100,
+} SPS30_TIMEOUT_MS;
+
 typedef enum {
     SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT = 259,
     SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_UINT16 = 261,
@@ -88,6 +108,9 @@ int16_t sps30_wake_up_sequence();
  *
  * @note This command can only be executed in Idle-Mode.
  *
+ * @note The uint16 output format requires firmware 2.0, see
+ * sps30_identity.h.
+ *
  * @return error_code 0 on success, an error code otherwise.
  *
  * Example:
@@ -132,7 +155,9 @@ int16_t sps30_stop_measurement();
  * @param[out] nc_10p0 Number Concentration PM10.0 [#/cm³]
  * @param[out] typical_particle_size Typical Particle Size [µm]
  *
- * @return error_code 0 on success, an error code otherwise.
+ * @return error_code 0 on success, SENSIRION_SHDLC_ERR_NO_DATA if the module
+ *         has no new values, which leaves the output values unchanged, an
+ *         error code otherwise.
  */
 int16_t sps30_read_measurement_values_uint16(
     uint16_t* mc_1p0, uint16_t* mc_2p5, uint16_t* mc_4p0, uint16_t* mc_10p0,
@@ -156,7 +181,9 @@ int16_t sps30_read_measurement_values_uint16(
  * @param[out] nc_10p0 Number Concentration PM10.0 [#/cm³]
  * @param[out] typical_particle_size Typical Particle Size [µm]
  *
- * @return error_code 0 on success, an error code otherwise.
+ * @return error_code 0 on success, SENSIRION_SHDLC_ERR_NO_DATA if the module
+ *         has no new values, which leaves the output values unchanged, an
+ *         error code otherwise.
  */
 int16_t sps30_read_measurement_values_float(float* mc_1p0, float* mc_2p5,
                                             float* mc_4p0, float* mc_10p0,
@@ -173,6 +200,8 @@ int16_t sps30_read_measurement_values_float(float* mc_1p0, float* mc_2p5,
  *
  * @note This command can only be executed in Idle-Mode.
  *
+ * @note Requires firmware 2.0, see sps30_identity.h.
+ *
  * @return error_code 0 on success, an error code otherwise.
  */
 int16_t sps30_sleep();
@@ -198,6 +227,8 @@ int16_t sps30_wake_up_communication();
  * succession. In this case the first Wake-up command is ignored, but causes the
  * interface to be activated.
  *
+ * @note Requires firmware 2.0, see sps30_identity.h.
+ *
  * @return error_code 0 on success, an error code otherwise.
  */
 int16_t sps30_wake_up();
@@ -301,6 +332,8 @@ int16_t sps30_read_version(uint8_t* firmware_major_version,
  * @param[out] device_status_register
  * @param[out] reserved
  *
+ * @note Requires firmware 2.2, see sps30_identity.h.
+ *
  * @return error_code 0 on success, an error code otherwise.
  */
 int16_t sps30_read_device_status_register(bool clear_status_register,
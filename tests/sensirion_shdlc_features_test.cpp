@@ -0,0 +1,338 @@
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_shdlc_counters.h"
+#include "sensirion_shdlc_latency.h"
+#include "sensirion_shdlc_recorder.h"
+#include "sensirion_shdlc_retry.h"
+#include "sensirion_shdlc_trace.h"
+#include "sensirion_test_setup.h"
+#include "sensirion_uart_hal.h"
+#include "sensirion_uart_hal_virtual.h"
+#include "sps30_simulator.h"
+#include "sps30_test_helpers.h"
+#include "sps30_uart.h"
+
+/*
+ * The optional instrumentation of the SHDLC layer, built with all of
+ * SENSIRION_SHDLC_LATENCY_HISTOGRAMS, SENSIRION_SHDLC_COUNTERS,
+ * SENSIRION_SHDLC_TRACE and SENSIRION_SHDLC_FLIGHT_RECORDER set.
+ */
+
+#define SPS30_RESPONSE_DELAY_US 5000
+#define SPS30_CMD_READ_VERSION 0xd1
+
+static struct sps30_simulator simulator;
+
+static const struct sensirion_shdlc_retry_policy three_attempts = {3, 5, 0};
+
+#define MAX_TRACED_FRAMES 4
+
+struct traced_frame {
+    struct sensirion_shdlc_trace_frame frame;
+    uint8_t raw[SENSIRION_SHDLC_TRACE_MAX_FRAME_SIZE];
+};
+
+static struct traced_frame traced_frames[MAX_TRACED_FRAMES];
+static uint8_t num_traced_frames;
+
+static void trace_frame(const struct sensirion_shdlc_trace_frame* frame,
+                        void* user_data) {
+    struct traced_frame* traced;
+    (void)user_data;
+    if (num_traced_frames >= MAX_TRACED_FRAMES) {
+        return;
+    }
+    traced = &traced_frames[num_traced_frames++];
+    traced->frame = *frame;
+    memcpy(traced->raw, frame->raw, frame->raw_len);
+    traced->frame.raw = traced->raw;
+}
+
+static uint8_t num_dumps;
+static int16_t dumped_error;
+
+static void dump_port(uint16_t port, void* user_data) {
+    struct sensirion_shdlc_recorder_entry
+        entries[SENSIRION_SHDLC_RECORDER_DEPTH];
+    uint16_t num_entries;
+    (void)user_data;
+    num_dumps++;
+    num_entries = sensirion_shdlc_recorder_snapshot(
+        port, entries, SENSIRION_SHDLC_RECORDER_DEPTH);
+    dumped_error = num_entries > 0 ? entries[num_entries - 1].error : NO_ERROR;
+}
+
+static const struct sensirion_shdlc_command_counters*
+find_command(const struct sensirion_shdlc_counters* counters,
+             uint8_t command) {
+    uint8_t i;
+    for (i = 0; i < counters->num_commands; i++) {
+        if (counters->commands[i].command == command) {
+            return &counters->commands[i];
+        }
+    }
+    return NULL;
+}
+
+TEST_GROUP (SHDLC_Features_Tests) {
+    void setup() {
+        int16_t error;
+        sensirion_uart_hal_virtual_reset();
+        sensirion_shdlc_latency_reset();
+        sensirion_shdlc_counters_reset(0);
+        error = sensirion_shdlc_retry_set_policy(0, &single_attempt);
+        CHECK_EQUAL_ZERO_TEXT(error, "sensirion_shdlc_retry_set_policy");
+        error = sensirion_uart_hal_init(SERIAL_0);
+        CHECK_EQUAL_ZERO_TEXT(error, "sensirion_uart_hal_init");
+        sps30_simulator_init(&simulator, 1);
+        sensirion_uart_hal_virtual_set_device(simulated_sps30, &simulator);
+        sensirion_uart_hal_virtual_set_response_delay_usec(
+            SPS30_RESPONSE_DELAY_US);
+        /* a timestamp of 0 means that it was not taken */
+        sensirion_uart_hal_virtual_advance_usec(1000);
+    }
+
+    void teardown() {
+        int16_t error;
+        sensirion_shdlc_trace_set_callback(NULL, NULL);
+        sensirion_shdlc_recorder_set_dump_callback(NULL, NULL);
+        error = sensirion_uart_hal_free();
+        CHECK_EQUAL_ZERO_TEXT(error, "sensirion_uart_hal_free");
+    }
+};
+
+TEST (SHDLC_Features_Tests, test_latency_percentiles_use_bucket_limits) {
+    struct sensirion_shdlc_latency_summary summary;
+    int16_t local_error = 0;
+    uint8_t i;
+    for (i = 0; i < 9; i++) {
+        local_error = read_version();
+        CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    }
+    sensirion_uart_hal_virtual_set_response_delay_usec(20000);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "slow read_version");
+    local_error = sensirion_shdlc_latency_get_summary(
+        0, SPS30_CMD_READ_VERSION, SENSIRION_SHDLC_LATENCY_WAIT, &summary);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "latency_get_summary");
+    CHECK_EQUAL(10, summary.count);
+    /* 5000 us fall into the bucket from 4096 to 5119 us */
+    CHECK_EQUAL(5119, summary.p50_us);
+    CHECK_EQUAL(5119, summary.p90_us);
+    /* the bucket of 20000 us ends above the maximum */
+    CHECK_EQUAL(20000, summary.p99_us);
+    CHECK_EQUAL(20000, summary.max_us);
+}
+
+TEST (SHDLC_Features_Tests, test_latency_counts_commands_without_slot) {
+    uint16_t command;
+    for (command = 0; command < SENSIRION_SHDLC_LATENCY_MAX_COMMANDS + 2;
+         command++) {
+        sensirion_shdlc_latency_record((uint8_t)command,
+                                       SENSIRION_SHDLC_LATENCY_TX, 0, 100);
+    }
+    CHECK_EQUAL(2, sensirion_shdlc_latency_get_dropped(0));
+}
+
+TEST (SHDLC_Features_Tests, test_counters_count_crc_mismatch) {
+    struct sensirion_shdlc_counters counters;
+    const struct sensirion_shdlc_command_counters* read_version_counters;
+    uint8_t crc_mismatch;
+    int16_t local_error = 0;
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT, 1);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CRC_MISMATCH, local_error);
+    local_error = sensirion_shdlc_counters_snapshot(0, &counters);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "counters_snapshot");
+    read_version_counters = find_command(&counters, SPS30_CMD_READ_VERSION);
+    CHECK(read_version_counters != NULL);
+    CHECK_EQUAL(1, read_version_counters->outcomes[0]);
+    crc_mismatch = sensirion_shdlc_counters_outcome_index(
+        SENSIRION_SHDLC_ERR_CRC_MISMATCH);
+    CHECK_EQUAL(1, read_version_counters->outcomes[crc_mismatch]);
+    CHECK_EQUAL(0, read_version_counters->timeouts);
+}
+
+TEST (SHDLC_Features_Tests, test_counters_count_lost_response_as_timeout) {
+    struct sensirion_shdlc_counters counters;
+    const struct sensirion_shdlc_command_counters* read_version_counters;
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_DROP, 1);
+    local_error = read_version();
+    CHECK(local_error != NO_ERROR);
+    local_error = sensirion_shdlc_counters_snapshot(0, &counters);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "counters_snapshot");
+    read_version_counters = find_command(&counters, SPS30_CMD_READ_VERSION);
+    CHECK(read_version_counters != NULL);
+    CHECK_EQUAL(1, read_version_counters->timeouts);
+    CHECK_EQUAL(0, read_version_counters->outcomes[0]);
+}
+
+TEST (SHDLC_Features_Tests, test_counters_count_retries) {
+    struct sensirion_shdlc_counters counters;
+    const struct sensirion_shdlc_command_counters* read_version_counters;
+    int16_t local_error = 0;
+    sensirion_shdlc_retry_set_policy(0, &three_attempts);
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT, 1);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version after corruption");
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_DROP, 3);
+    local_error = read_version();
+    CHECK(local_error != NO_ERROR);
+    local_error = sensirion_shdlc_counters_snapshot(0, &counters);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "counters_snapshot");
+    read_version_counters = find_command(&counters, SPS30_CMD_READ_VERSION);
+    CHECK(read_version_counters != NULL);
+    CHECK_EQUAL(1 + 2, read_version_counters->retries);
+    CHECK_EQUAL(1, read_version_counters->retries_exhausted);
+    CHECK_EQUAL(3, read_version_counters->timeouts);
+}
+
+TEST (SHDLC_Features_Tests, test_io_counters_count_bytes_and_escapes) {
+    struct sensirion_shdlc_counters counters;
+    uint32_t auto_cleaning_interval = 0;
+    int16_t local_error = 0;
+    /* 0x7e in the payload is stuffed in both directions */
+    local_error = sps30_write_auto_cleaning_interval(0x7e);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "write_auto_cleaning_interval");
+    local_error = sps30_read_auto_cleaning_interval(&auto_cleaning_interval);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_auto_cleaning_interval");
+    CHECK_EQUAL(0x7e, auto_cleaning_interval);
+    local_error = sensirion_shdlc_counters_snapshot(0, &counters);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "counters_snapshot");
+    /* 7e 00 80 05 00 00 00 00 7d 5e fc 7e */
+    /* 7e 00 80 01 00 7d 5e 7e, the checksum is stuffed */
+    CHECK_EQUAL(12 + 8, counters.io.tx_bytes);
+    /* the streaming encoder writes byte by byte */
+    CHECK_EQUAL(counters.io.tx_bytes, counters.io.tx_calls);
+    CHECK_EQUAL(2, counters.io.tx_escapes);
+    /* 7e 00 80 00 00 7f 7e */
+    /* 7e 00 80 00 04 00 00 00 7d 5e fd 7e */
+    CHECK_EQUAL(7 + 12, counters.io.rx_bytes);
+    CHECK_EQUAL(1, counters.io.rx_escapes);
+    CHECK_EQUAL(0, counters.io.hal_errors);
+    CHECK(counters.io.rx_calls >= 2);
+}
+
+TEST (SHDLC_Features_Tests, test_trace_passes_wire_bytes) {
+    static const uint8_t request[] = {0x7e, 0x00, 0xd1, 0x00, 0x2e, 0x7e};
+    const struct sensirion_shdlc_trace_frame* frame;
+    int16_t local_error = 0;
+    uint8_t i;
+    num_traced_frames = 0;
+    sensirion_shdlc_trace_set_callback(trace_frame, NULL);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    CHECK_EQUAL(2, num_traced_frames);
+
+    frame = &traced_frames[0].frame;
+    CHECK_EQUAL(SENSIRION_SHDLC_TRACE_TX, frame->direction);
+    CHECK_EQUAL(NO_ERROR, frame->error);
+    CHECK_EQUAL(SPS30_CMD_READ_VERSION, frame->cmd);
+    CHECK(!frame->truncated);
+    CHECK_EQUAL(sizeof(request), frame->raw_len);
+    for (i = 0; i < sizeof(request); i++) {
+        CHECK_EQUAL(request[i], frame->raw[i]);
+    }
+
+    frame = &traced_frames[1].frame;
+    CHECK_EQUAL(SENSIRION_SHDLC_TRACE_RX, frame->direction);
+    CHECK_EQUAL(NO_ERROR, frame->error);
+    CHECK_EQUAL(SPS30_CMD_READ_VERSION, frame->cmd);
+    CHECK_EQUAL(7, frame->data_len);
+    CHECK(frame->timestamp_us >= traced_frames[0].frame.timestamp_us +
+                                     SPS30_RESPONSE_DELAY_US);
+    CHECK_EQUAL(0x7e, frame->raw[0]);
+    CHECK_EQUAL(0x7e, frame->raw[frame->raw_len - 1]);
+}
+
+TEST (SHDLC_Features_Tests, test_trace_reports_crc_mismatch) {
+    int16_t local_error = 0;
+    num_traced_frames = 0;
+    sensirion_shdlc_trace_set_callback(trace_frame, NULL);
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT, 1);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CRC_MISMATCH, local_error);
+    CHECK_EQUAL(2, num_traced_frames);
+    CHECK_EQUAL(SENSIRION_SHDLC_TRACE_RX, traced_frames[1].frame.direction);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CRC_MISMATCH,
+                traced_frames[1].frame.error);
+}
+
+TEST (SHDLC_Features_Tests, test_recorder_keeps_newest_transactions) {
+    struct sensirion_shdlc_recorder_entry
+        entries[SENSIRION_SHDLC_RECORDER_DEPTH + 1];
+    const struct sensirion_shdlc_recorder_entry* newest;
+    uint16_t num_entries;
+    int16_t local_error = 0;
+    uint8_t i;
+    /* wrap the ring, the last transaction is the slow one */
+    for (i = 0; i < SENSIRION_SHDLC_RECORDER_DEPTH + 2; i++) {
+        local_error = read_version();
+        CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    }
+    sensirion_uart_hal_virtual_set_response_delay_usec(7000);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "slow read_version");
+
+    num_entries = sensirion_shdlc_recorder_snapshot(
+        0, entries, SENSIRION_SHDLC_RECORDER_DEPTH + 1);
+    CHECK_EQUAL(SENSIRION_SHDLC_RECORDER_DEPTH, num_entries);
+    for (i = 1; i < num_entries; i++) {
+        CHECK(entries[i].tx_timestamp_us > entries[i - 1].tx_timestamp_us);
+        CHECK_EQUAL(SPS30_RESPONSE_DELAY_US,
+                    entries[i - 1].rx_timestamp_us -
+                        entries[i - 1].tx_timestamp_us);
+    }
+    newest = &entries[num_entries - 1];
+    CHECK_EQUAL(NO_ERROR, newest->error);
+    CHECK_EQUAL(SPS30_CMD_READ_VERSION, newest->command);
+    CHECK_EQUAL(7000, newest->rx_timestamp_us - newest->tx_timestamp_us);
+    CHECK_EQUAL(6, newest->tx_len);
+    CHECK_EQUAL(0x2e, newest->tx[4]);
+
+    /* too little room returns the newest entries */
+    num_entries = sensirion_shdlc_recorder_snapshot(0, entries, 1);
+    CHECK_EQUAL(1, num_entries);
+    CHECK_EQUAL(7000, entries[0].rx_timestamp_us - entries[0].tx_timestamp_us);
+}
+
+TEST (SHDLC_Features_Tests, test_recorder_dumps_once_per_failure_burst) {
+    int16_t local_error = 0;
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    num_dumps = 0;
+    sensirion_shdlc_recorder_set_dump_callback(dump_port, NULL);
+
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT, 3);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CRC_MISMATCH, local_error);
+    CHECK_EQUAL(1, num_dumps);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CRC_MISMATCH, dumped_error);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CRC_MISMATCH, local_error);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CRC_MISMATCH, local_error);
+    CHECK_EQUAL(1, num_dumps);
+
+    /* the next failure after a success is a new burst */
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    CHECK_EQUAL(1, num_dumps);
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT, 1);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CRC_MISMATCH, local_error);
+    CHECK_EQUAL(2, num_dumps);
+
+    sensirion_shdlc_recorder_trigger_dump(0);
+    CHECK_EQUAL(3, num_dumps);
+}
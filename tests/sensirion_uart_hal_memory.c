@@ -0,0 +1,114 @@
+/* Enable clock_gettime function */
+#define _DEFAULT_SOURCE
+
+#include "sensirion_uart_hal_memory.h"
+#include "sensirion_common.h"
+#include <time.h>
+
+struct sensirion_uart_hal_memory_queue {
+    uint16_t head;
+    uint16_t tail;
+    uint8_t data[SENSIRION_UART_HAL_MEMORY_SIZE];
+};
+
+static struct sensirion_uart_hal_memory_queue tx_queue;
+static struct sensirion_uart_hal_memory_queue rx_queue;
+static uint16_t memory_port;
+
+static uint16_t
+sensirion_uart_hal_memory_push(struct sensirion_uart_hal_memory_queue* queue,
+                               const uint8_t* data, uint16_t data_len) {
+    uint16_t free_len;
+
+    /* move pending bytes to the front, copy_bytes copies upwards */
+    if (queue->head > 0) {
+        queue->tail = (uint16_t)(queue->tail - queue->head);
+        sensirion_common_copy_bytes(&queue->data[queue->head], queue->data,
+                                    queue->tail);
+        queue->head = 0;
+    }
+    free_len = (uint16_t)(sizeof(queue->data) - queue->tail);
+    if (data_len > free_len) {
+        data_len = free_len;
+    }
+    sensirion_common_copy_bytes(data, &queue->data[queue->tail], data_len);
+    queue->tail = (uint16_t)(queue->tail + data_len);
+    return data_len;
+}
+
+static uint16_t
+sensirion_uart_hal_memory_pop(struct sensirion_uart_hal_memory_queue* queue,
+                              uint8_t* data, uint16_t max_data_len) {
+    uint16_t len = (uint16_t)(queue->tail - queue->head);
+
+    if (len > max_data_len) {
+        len = max_data_len;
+    }
+    sensirion_common_copy_bytes(&queue->data[queue->head], data, len);
+    queue->head = (uint16_t)(queue->head + len);
+    return len;
+}
+
+void sensirion_uart_hal_memory_reset(void) {
+    tx_queue.head = tx_queue.tail = 0;
+    rx_queue.head = rx_queue.tail = 0;
+}
+
+uint16_t sensirion_uart_hal_memory_feed(const uint8_t* data,
+                                        uint16_t data_len) {
+    return sensirion_uart_hal_memory_push(&rx_queue, data, data_len);
+}
+
+uint16_t sensirion_uart_hal_memory_take(uint8_t* data, uint16_t max_data_len) {
+    uint16_t len = sensirion_uart_hal_memory_pop(&tx_queue, data, max_data_len);
+
+    tx_queue.head = tx_queue.tail = 0;
+    return len;
+}
+
+int16_t sensirion_uart_hal_select_port(uint16_t port) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return -1;
+    }
+    memory_port = port;
+    return NO_ERROR;
+}
+
+uint16_t sensirion_uart_hal_get_selected_port(void) {
+    return memory_port;
+}
+
+int16_t sensirion_uart_hal_init(UartDescr port) {
+    (void)port;
+    sensirion_uart_hal_memory_reset();
+    return NO_ERROR;
+}
+
+int16_t sensirion_uart_hal_free() {
+    return NO_ERROR;
+}
+
+int16_t sensirion_uart_hal_tx(uint16_t data_len, const uint8_t* data) {
+    return (int16_t)sensirion_uart_hal_memory_push(&tx_queue, data, data_len);
+}
+
+int16_t sensirion_uart_hal_rx(uint16_t max_data_len, uint8_t* data) {
+    return (int16_t)sensirion_uart_hal_memory_pop(&rx_queue, data,
+                                                  max_data_len);
+}
+
+int16_t sensirion_uart_hal_wait_rx_usec(uint32_t timeout_us) {
+    (void)timeout_us;
+    return NOT_IMPLEMENTED_ERROR;
+}
+
+void sensirion_uart_hal_sleep_usec(uint32_t useconds) {
+    (void)useconds;
+}
+
+uint64_t sensirion_uart_hal_get_time_usec(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
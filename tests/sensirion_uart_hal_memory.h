@@ -0,0 +1,43 @@
+#ifndef SENSIRION_UART_HAL_MEMORY_H
+#define SENSIRION_UART_HAL_MEMORY_H
+
+/**
+ * In-memory implementation of sensirion_uart_hal.h for host benchmarks and
+ * tests. Transmitted bytes are appended to a TX queue, received bytes are
+ * taken from an RX queue filled by the test. All ports share the same queues,
+ * sensirion_uart_hal_sleep_usec() returns immediately and
+ * sensirion_uart_hal_get_time_usec() follows CLOCK_MONOTONIC.
+ */
+
+#include "sensirion_uart_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SENSIRION_UART_HAL_MEMORY_SIZE 1024
+
+/**
+ * Empty both queues.
+ */
+void sensirion_uart_hal_memory_reset(void);
+
+/**
+ * Append bytes to the RX queue.
+ *
+ * @return Number of bytes queued, less than data_len if the queue is full
+ */
+uint16_t sensirion_uart_hal_memory_feed(const uint8_t* data, uint16_t data_len);
+
+/**
+ * Move all bytes from the TX queue to the caller.
+ *
+ * @return Number of bytes copied, the rest is dropped if data is too small
+ */
+uint16_t sensirion_uart_hal_memory_take(uint8_t* data, uint16_t max_data_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSIRION_UART_HAL_MEMORY_H */
@@ -0,0 +1,271 @@
+#include "sensirion_uart_hal_virtual.h"
+#include "sensirion_common.h"
+
+struct sensirion_uart_hal_virtual_port {
+    sensirion_uart_hal_virtual_device device;
+    void* user_data;
+    uint32_t response_delay_us;
+    sensirion_uart_hal_virtual_fault fault;
+    uint16_t fault_count;
+    uint32_t byte_error_rate;  //< corrupted bytes per million
+    uint32_t corrupted_bytes;
+
+    /* received bytes and the virtual time they arrive at */
+    uint16_t rx_head;
+    uint16_t rx_tail;
+    uint8_t rx_data[SENSIRION_UART_HAL_VIRTUAL_SIZE];
+    uint64_t rx_due_us[SENSIRION_UART_HAL_VIRTUAL_SIZE];
+
+    /* transmitted bytes when no device is attached */
+    uint16_t tx_len;
+    uint8_t tx_data[SENSIRION_UART_HAL_VIRTUAL_SIZE];
+};
+
+static struct sensirion_uart_hal_virtual_port
+    virtual_ports[SENSIRION_UART_MAX_PORTS];
+static uint16_t virtual_port;
+static uint64_t virtual_now_us;
+static uint32_t virtual_random;
+
+#define SENSIRION_UART_HAL_VIRTUAL_SEED 0x2545f491
+
+static struct sensirion_uart_hal_virtual_port*
+sensirion_uart_hal_virtual(void) {
+    return &virtual_ports[virtual_port];
+}
+
+void sensirion_uart_hal_virtual_reset(void) {
+    uint16_t i;
+
+    for (i = 0; i < SENSIRION_UART_MAX_PORTS; i++) {
+        virtual_ports[i].device = NULL;
+        virtual_ports[i].user_data = NULL;
+        virtual_ports[i].response_delay_us = 0;
+        virtual_ports[i].fault = SENSIRION_UART_HAL_VIRTUAL_FAULT_NONE;
+        virtual_ports[i].fault_count = 0;
+        virtual_ports[i].byte_error_rate = 0;
+        virtual_ports[i].corrupted_bytes = 0;
+        virtual_ports[i].rx_head = 0;
+        virtual_ports[i].rx_tail = 0;
+        virtual_ports[i].tx_len = 0;
+    }
+    virtual_port = 0;
+    virtual_now_us = 0;
+    virtual_random = SENSIRION_UART_HAL_VIRTUAL_SEED;
+}
+
+void sensirion_uart_hal_virtual_set_device(
+    sensirion_uart_hal_virtual_device device, void* user_data) {
+    sensirion_uart_hal_virtual()->device = device;
+    sensirion_uart_hal_virtual()->user_data = user_data;
+}
+
+void sensirion_uart_hal_virtual_set_response_delay_usec(uint32_t delay_us) {
+    sensirion_uart_hal_virtual()->response_delay_us = delay_us;
+}
+
+void sensirion_uart_hal_virtual_inject_fault(
+    sensirion_uart_hal_virtual_fault fault, uint16_t count) {
+    sensirion_uart_hal_virtual()->fault = fault;
+    sensirion_uart_hal_virtual()->fault_count = count;
+}
+
+void sensirion_uart_hal_virtual_set_byte_error_rate(
+    uint32_t errors_per_million) {
+    sensirion_uart_hal_virtual()->byte_error_rate = errors_per_million;
+}
+
+uint32_t sensirion_uart_hal_virtual_get_corrupted_bytes(void) {
+    return sensirion_uart_hal_virtual()->corrupted_bytes;
+}
+
+/* xorshift32, deterministic across platforms */
+static uint32_t sensirion_uart_hal_virtual_next_random(void) {
+    virtual_random ^= virtual_random << 13;
+    virtual_random ^= virtual_random >> 17;
+    virtual_random ^= virtual_random << 5;
+    return virtual_random;
+}
+
+/* flip one bit in every byte hit by the error rate */
+static void
+sensirion_uart_hal_virtual_corrupt(struct sensirion_uart_hal_virtual_port* port,
+                                   uint8_t* data, uint16_t data_len) {
+    uint32_t bit;
+    uint16_t i;
+
+    if (port->byte_error_rate == 0) {
+        return;
+    }
+    for (i = 0; i < data_len; i++) {
+        if (sensirion_uart_hal_virtual_next_random() % 1000000 <
+            port->byte_error_rate) {
+            bit = sensirion_uart_hal_virtual_next_random() % 8;
+            data[i] ^= (uint8_t)(1u << bit);
+            port->corrupted_bytes++;
+        }
+    }
+}
+
+uint16_t sensirion_uart_hal_virtual_schedule_rx(uint32_t delay_us,
+                                                const uint8_t* data,
+                                                uint16_t data_len) {
+    struct sensirion_uart_hal_virtual_port* port = sensirion_uart_hal_virtual();
+    uint64_t due_us = virtual_now_us + delay_us;
+    uint16_t i;
+
+    /* move pending bytes to the front */
+    if (port->rx_head > 0) {
+        for (i = port->rx_head; i < port->rx_tail; i++) {
+            port->rx_data[i - port->rx_head] = port->rx_data[i];
+            port->rx_due_us[i - port->rx_head] = port->rx_due_us[i];
+        }
+        port->rx_tail = (uint16_t)(port->rx_tail - port->rx_head);
+        port->rx_head = 0;
+    }
+    /* a serial line delivers in order */
+    if (port->rx_tail > 0 && port->rx_due_us[port->rx_tail - 1] > due_us) {
+        due_us = port->rx_due_us[port->rx_tail - 1];
+    }
+    for (i = 0; i < data_len && port->rx_tail < SENSIRION_UART_HAL_VIRTUAL_SIZE;
+         i++) {
+        port->rx_data[port->rx_tail] = data[i];
+        port->rx_due_us[port->rx_tail] = due_us;
+        port->rx_tail++;
+    }
+    return i;
+}
+
+uint16_t sensirion_uart_hal_virtual_take_tx(uint8_t* data,
+                                            uint16_t max_data_len) {
+    struct sensirion_uart_hal_virtual_port* port = sensirion_uart_hal_virtual();
+    uint16_t len = port->tx_len;
+
+    if (len > max_data_len) {
+        len = max_data_len;
+    }
+    sensirion_common_copy_bytes(port->tx_data, data, len);
+    port->tx_len = 0;
+    return len;
+}
+
+void sensirion_uart_hal_virtual_advance_usec(uint64_t duration_us) {
+    virtual_now_us += duration_us;
+}
+
+/* pass the request to the device and schedule the response */
+static void
+sensirion_uart_hal_virtual_respond(struct sensirion_uart_hal_virtual_port* port,
+                                   uint16_t data_len, const uint8_t* data) {
+    uint8_t request[SENSIRION_UART_HAL_VIRTUAL_SIZE];
+    uint8_t response[SENSIRION_UART_HAL_VIRTUAL_SIZE];
+    sensirion_uart_hal_virtual_fault fault =
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_NONE;
+    uint16_t len;
+
+    if (data_len > sizeof(request)) {
+        data_len = sizeof(request);
+    }
+    sensirion_common_copy_bytes(data, request, data_len);
+    sensirion_uart_hal_virtual_corrupt(port, request, data_len);
+    len = port->device(port->user_data, virtual_now_us, request, data_len,
+                       response, sizeof(response));
+    if (len == 0) {
+        return;
+    }
+    if (port->fault_count > 0) {
+        fault = port->fault;
+        port->fault_count--;
+    }
+    switch (fault) {
+        case SENSIRION_UART_HAL_VIRTUAL_FAULT_DROP:
+            return;
+        case SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT:
+            /* the byte before the stop delimiter, part of the checksum */
+            response[len - 2] ^= 0x01;
+            break;
+        case SENSIRION_UART_HAL_VIRTUAL_FAULT_TRUNCATE:
+            len = (uint16_t)(len / 2);
+            break;
+        default:
+            break;
+    }
+    sensirion_uart_hal_virtual_corrupt(port, response, len);
+    sensirion_uart_hal_virtual_schedule_rx(port->response_delay_us, response,
+                                           len);
+}
+
+int16_t sensirion_uart_hal_select_port(uint16_t port) {
+    if (port >= SENSIRION_UART_MAX_PORTS) {
+        return -1;
+    }
+    virtual_port = port;
+    return NO_ERROR;
+}
+
+uint16_t sensirion_uart_hal_get_selected_port(void) {
+    return virtual_port;
+}
+
+int16_t sensirion_uart_hal_init(UartDescr port) {
+    (void)port;
+    sensirion_uart_hal_virtual()->rx_head = 0;
+    sensirion_uart_hal_virtual()->rx_tail = 0;
+    sensirion_uart_hal_virtual()->tx_len = 0;
+    return NO_ERROR;
+}
+
+int16_t sensirion_uart_hal_free() {
+    return NO_ERROR;
+}
+
+int16_t sensirion_uart_hal_tx(uint16_t data_len, const uint8_t* data) {
+    struct sensirion_uart_hal_virtual_port* port = sensirion_uart_hal_virtual();
+    uint16_t free_len;
+
+    if (port->device != NULL) {
+        sensirion_uart_hal_virtual_respond(port, data_len, data);
+        return (int16_t)data_len;
+    }
+    free_len = (uint16_t)(sizeof(port->tx_data) - port->tx_len);
+    if (data_len > free_len) {
+        data_len = free_len;
+    }
+    sensirion_common_copy_bytes(data, &port->tx_data[port->tx_len], data_len);
+    port->tx_len = (uint16_t)(port->tx_len + data_len);
+    return (int16_t)data_len;
+}
+
+int16_t sensirion_uart_hal_rx(uint16_t max_data_len, uint8_t* data) {
+    struct sensirion_uart_hal_virtual_port* port = sensirion_uart_hal_virtual();
+    uint16_t len = 0;
+
+    while (len < max_data_len && port->rx_head < port->rx_tail &&
+           port->rx_due_us[port->rx_head] <= virtual_now_us) {
+        data[len++] = port->rx_data[port->rx_head++];
+    }
+    return (int16_t)len;
+}
+
+int16_t sensirion_uart_hal_wait_rx_usec(uint32_t timeout_us) {
+    struct sensirion_uart_hal_virtual_port* port = sensirion_uart_hal_virtual();
+    uint64_t deadline_us = virtual_now_us + timeout_us;
+
+    if (port->rx_head < port->rx_tail &&
+        port->rx_due_us[port->rx_head] <= deadline_us) {
+        if (port->rx_due_us[port->rx_head] > virtual_now_us) {
+            virtual_now_us = port->rx_due_us[port->rx_head];
+        }
+        return 1;
+    }
+    virtual_now_us = deadline_us;
+    return 0;
+}
+
+void sensirion_uart_hal_sleep_usec(uint32_t useconds) {
+    virtual_now_us += useconds;
+}
+
+uint64_t sensirion_uart_hal_get_time_usec(void) {
+    return virtual_now_us;
+}
@@ -0,0 +1,118 @@
+#ifndef SENSIRION_UART_HAL_VIRTUAL_H
+#define SENSIRION_UART_HAL_VIRTUAL_H
+
+/**
+ * Virtual-time implementation of sensirion_uart_hal.h for host tests.
+ *
+ * Time only passes when the code under test sleeps or waits:
+ * sensirion_uart_hal_sleep_usec() and sensirion_uart_hal_wait_rx_usec()
+ * advance a virtual clock, which sensirion_uart_hal_get_time_usec() returns.
+ * Timeouts, retries and measurement cadences therefore run instantly, while
+ * the driver observes the same timing as on a real serial port.
+ *
+ * Every port has a device callback which is passed the transmitted bytes and
+ * returns the response. The response is received after the configured
+ * response delay in virtual time. Bytes can also be scheduled directly,
+ * faults can be injected into the next responses and bytes on the wire can
+ * be corrupted at a given error rate.
+ */
+
+#include "sensirion_uart_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SENSIRION_UART_HAL_VIRTUAL_SIZE 1024
+
+/**
+ * Emulated device: decode the transmitted bytes and store the response.
+ *
+ * @return Number of response bytes stored
+ */
+typedef uint16_t (*sensirion_uart_hal_virtual_device)(
+    void* user_data, uint64_t now_us, const uint8_t* data, uint16_t data_len,
+    uint8_t* response, uint16_t max_response_len);
+
+typedef enum {
+    SENSIRION_UART_HAL_VIRTUAL_FAULT_NONE = 0,
+    SENSIRION_UART_HAL_VIRTUAL_FAULT_DROP,      //< the response is lost
+    SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT,   //< one bit flips
+    SENSIRION_UART_HAL_VIRTUAL_FAULT_TRUNCATE,  //< only half is received
+} sensirion_uart_hal_virtual_fault;
+
+/**
+ * Reset the clock to 0 and remove devices, queues and faults of all ports.
+ */
+void sensirion_uart_hal_virtual_reset(void);
+
+/**
+ * Attach an emulated device to the selected port, NULL detaches it.
+ */
+void sensirion_uart_hal_virtual_set_device(
+    sensirion_uart_hal_virtual_device device, void* user_data);
+
+/**
+ * Set the virtual time between a request and its response on the selected
+ * port.
+ */
+void sensirion_uart_hal_virtual_set_response_delay_usec(uint32_t delay_us);
+
+/**
+ * Apply a fault to the next responses of the selected port.
+ *
+ * @param fault Fault to inject
+ * @param count Number of responses to apply it to
+ */
+void sensirion_uart_hal_virtual_inject_fault(
+    sensirion_uart_hal_virtual_fault fault, uint16_t count);
+
+/**
+ * Corrupt bytes on the wire of the selected port at random. Every byte of a
+ * request and of a response is hit independently with the given probability
+ * and has one of its bits flipped. The random sequence restarts with
+ * sensirion_uart_hal_virtual_reset(), so runs are reproducible.
+ *
+ * @param errors_per_million Probability of a corrupted byte in 1e-6
+ */
+void sensirion_uart_hal_virtual_set_byte_error_rate(
+    uint32_t errors_per_million);
+
+/**
+ * Number of bytes corrupted on the selected port since the last reset.
+ */
+uint32_t sensirion_uart_hal_virtual_get_corrupted_bytes(void);
+
+/**
+ * Schedule bytes to be received on the selected port. Bytes are received in
+ * order, never before bytes scheduled earlier.
+ *
+ * @param delay_us Virtual time from now until the bytes arrive
+ * @param data     Bytes to receive
+ * @param data_len Number of bytes
+ *
+ * @return Number of bytes scheduled, less than data_len if the queue is full
+ */
+uint16_t sensirion_uart_hal_virtual_schedule_rx(uint32_t delay_us,
+                                                const uint8_t* data,
+                                                uint16_t data_len);
+
+/**
+ * Move all transmitted bytes of the selected port which were not passed to a
+ * device to the caller.
+ *
+ * @return Number of bytes copied, the rest is dropped if data is too small
+ */
+uint16_t sensirion_uart_hal_virtual_take_tx(uint8_t* data,
+                                            uint16_t max_data_len);
+
+/**
+ * Advance the virtual clock, e.g. to let hours pass between measurements.
+ */
+void sensirion_uart_hal_virtual_advance_usec(uint64_t duration_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSIRION_UART_HAL_VIRTUAL_H */
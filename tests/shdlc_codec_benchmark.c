@@ -0,0 +1,334 @@
+/*
+ * Microbenchmark of the SHDLC codec paths over the in-memory UART HAL.
+ *
+ * Requests are encoded with sensirion_shdlc_tx(), the frame builder with
+ * sensirion_shdlc_tx_frame() and the streaming sensirion_shdlc_write_request().
+ * Responses are decoded with sensirion_shdlc_rx(), sensirion_shdlc_rx_inplace()
+ * and the streaming sensirion_shdlc_read_response(). Every path is first
+ * checked against a reference encoding, the program fails if any path
+ * produces a different frame or payload.
+ *
+ * The timings include the copies into and out of the in-memory transport.
+ */
+
+/* Enable clock_gettime function */
+#define _DEFAULT_SOURCE
+
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_streaming_shdlc.h"
+#include "sensirion_uart_hal_memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCHMARK_ADDR 0x00
+#define BENCHMARK_CMD 0x03
+#define BENCHMARK_TIMEOUT_MS 50
+#define BENCHMARK_DEFAULT_ITERATIONS 20000
+
+#define SHDLC_FRAME_DELIMITER 0x7e
+#define SHDLC_STUFF_BYTE 0x7d
+
+/** start/stop + (5 header + 255 data) * 2 because of byte stuffing */
+#define SHDLC_MAX_FRAME_SIZE (2 + (5 + 255) * 2)
+
+struct codec_case {
+    uint8_t data_len;
+    uint8_t escape_percent;
+    uint8_t data[255];
+    uint16_t request_len;
+    uint8_t request[SHDLC_MAX_FRAME_SIZE];
+    uint16_t response_len;
+    uint8_t response[SHDLC_MAX_FRAME_SIZE];
+};
+
+/* encode the request of a case, returns NO_ERROR or an error code */
+typedef int16_t (*encode_path)(const struct codec_case* c);
+
+/* decode the response of a case into data, returns the SHDLC error code */
+typedef int16_t (*decode_path)(const struct codec_case* c,
+                               struct sensirion_shdlc_rx_header* header,
+                               uint8_t** data);
+
+static const uint8_t data_lengths[] = {0, 10, 40, 255};
+static const uint8_t escape_percents[] = {0, 10, 25, 50, 100};
+static const uint8_t escaped_bytes[] = {0x11, 0x13, 0x7d, 0x7e};
+
+static uint8_t frame_buffer[SHDLC_MAX_FRAME_SIZE];
+static uint8_t wire_buffer[SHDLC_MAX_FRAME_SIZE];
+
+static uint64_t benchmark_now_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+static uint16_t reference_stuff(uint8_t byte, uint8_t* out) {
+    switch (byte) {
+        case 0x11:
+        case 0x13:
+        case SHDLC_STUFF_BYTE:
+        case SHDLC_FRAME_DELIMITER:
+            out[0] = SHDLC_STUFF_BYTE;
+            out[1] = byte ^ (1 << 5);
+            return 2;
+        default:
+            out[0] = byte;
+            return 1;
+    }
+}
+
+/* straightforward encoder of a frame with the given header bytes */
+static uint16_t reference_encode(const uint8_t* header, uint8_t header_len,
+                                 const uint8_t* data, uint8_t data_len,
+                                 uint8_t* out) {
+    uint8_t checksum = 0;
+    uint16_t len = 0;
+    uint16_t i;
+
+    out[len++] = SHDLC_FRAME_DELIMITER;
+    for (i = 0; i < header_len; i++) {
+        checksum = (uint8_t)(checksum + header[i]);
+        len += reference_stuff(header[i], &out[len]);
+    }
+    for (i = 0; i < data_len; i++) {
+        checksum = (uint8_t)(checksum + data[i]);
+        len += reference_stuff(data[i], &out[len]);
+    }
+    len += reference_stuff((uint8_t)~checksum, &out[len]);
+    out[len++] = SHDLC_FRAME_DELIMITER;
+    return len;
+}
+
+/* spread escape_percent % of bytes needing stuffing evenly over the data */
+static void codec_case_init(struct codec_case* c, uint8_t data_len,
+                            uint8_t escape_percent) {
+    uint8_t request_header[] = {BENCHMARK_ADDR, BENCHMARK_CMD, data_len};
+    uint8_t response_header[] = {BENCHMARK_ADDR, BENCHMARK_CMD, 0, data_len};
+    uint16_t i;
+
+    c->data_len = data_len;
+    c->escape_percent = escape_percent;
+    for (i = 0; i < data_len; i++) {
+        if ((i + 1) * escape_percent / 100 != i * escape_percent / 100) {
+            c->data[i] = escaped_bytes[i % sizeof(escaped_bytes)];
+        } else {
+            c->data[i] = (uint8_t)(0x20 + i % 0x40);
+        }
+    }
+    c->request_len = reference_encode(request_header, sizeof(request_header),
+                                      c->data, data_len, c->request);
+    c->response_len =
+        reference_encode(response_header, sizeof(response_header), c->data,
+                         data_len, c->response);
+}
+
+static int16_t encode_tx(const struct codec_case* c) {
+    return sensirion_shdlc_tx(BENCHMARK_ADDR, BENCHMARK_CMD, c->data_len,
+                              c->data);
+}
+
+static int16_t encode_builder(const struct codec_case* c) {
+    struct sensirion_shdlc_buffer frame;
+
+    sensirion_shdlc_begin_frame(&frame, frame_buffer, BENCHMARK_CMD,
+                                BENCHMARK_ADDR, c->data_len);
+    sensirion_shdlc_add_bytes_to_frame(&frame, c->data, c->data_len);
+    sensirion_shdlc_finish_frame(&frame);
+    return sensirion_shdlc_tx_frame(&frame);
+}
+
+static int16_t encode_stream(const struct codec_case* c) {
+    sensirion_streaming_state stream;
+
+    sensirion_shdlc_begin_stream(&stream, frame_buffer, BENCHMARK_CMD,
+                                 BENCHMARK_ADDR, c->data_len);
+    sensirion_add_bytes_argument(&stream, c->data, c->data_len);
+    return sensirion_shdlc_write_request(&stream);
+}
+
+static int16_t decode_rx(const struct codec_case* c,
+                         struct sensirion_shdlc_rx_header* header,
+                         uint8_t** data) {
+    sensirion_uart_hal_memory_feed(c->response, c->response_len);
+    *data = frame_buffer;
+    return sensirion_shdlc_rx(c->data_len, header, frame_buffer);
+}
+
+static int16_t decode_rx_inplace(const struct codec_case* c,
+                                 struct sensirion_shdlc_rx_header* header,
+                                 uint8_t** data) {
+    struct sensirion_shdlc_buffer frame;
+
+    sensirion_uart_hal_memory_feed(c->response, c->response_len);
+    frame.data = frame_buffer;
+    *data = frame_buffer;
+    return sensirion_shdlc_rx_inplace(&frame, c->data_len, header);
+}
+
+static int16_t decode_stream(const struct codec_case* c,
+                             struct sensirion_shdlc_rx_header* header,
+                             uint8_t** data) {
+    sensirion_streaming_state stream;
+
+    sensirion_uart_hal_memory_feed(c->response, c->response_len);
+    sensirion_shdlc_begin_stream(&stream, frame_buffer, BENCHMARK_CMD,
+                                 BENCHMARK_ADDR, 0);
+    *data = frame_buffer;
+    return sensirion_shdlc_read_response(&stream, c->data_len, header,
+                                         BENCHMARK_TIMEOUT_MS);
+}
+
+static bool check_encode(const char* name, encode_path path,
+                         const struct codec_case* c) {
+    int16_t error;
+    uint16_t len;
+    uint16_t i;
+
+    sensirion_uart_hal_memory_reset();
+    error = path(c);
+    len = sensirion_uart_hal_memory_take(wire_buffer, sizeof(wire_buffer));
+    if (error != NO_ERROR || len != c->request_len) {
+        fprintf(stderr, "%s: len %u escapes %u%%: error %d, %u bytes\n", name,
+                c->data_len, c->escape_percent, error, len);
+        return false;
+    }
+    for (i = 0; i < len; i++) {
+        if (wire_buffer[i] != c->request[i]) {
+            fprintf(stderr, "%s: len %u escapes %u%%: byte %u differs\n",
+                    name, c->data_len, c->escape_percent, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool check_decode(const char* name, decode_path path,
+                         const struct codec_case* c) {
+    struct sensirion_shdlc_rx_header header;
+    uint8_t* data;
+    int16_t error;
+    uint16_t i;
+
+    sensirion_uart_hal_memory_reset();
+    error = path(c, &header, &data);
+    if (error != NO_ERROR || header.addr != BENCHMARK_ADDR ||
+        header.cmd != BENCHMARK_CMD || header.state != 0 ||
+        header.data_len != c->data_len) {
+        fprintf(stderr, "%s: len %u escapes %u%%: error %d\n", name,
+                c->data_len, c->escape_percent, error);
+        return false;
+    }
+    for (i = 0; i < c->data_len; i++) {
+        if (data[i] != c->data[i]) {
+            fprintf(stderr, "%s: len %u escapes %u%%: byte %u differs\n",
+                    name, c->data_len, c->escape_percent, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void report(const char* name, const struct codec_case* c,
+                   uint16_t wire_len, uint32_t iterations, uint64_t ns) {
+    double ns_per_frame = (double)ns / iterations;
+
+    printf("%-12s %5u %7u%% %6u %10.1f %10.2f\n", name, c->data_len,
+           c->escape_percent, wire_len, ns_per_frame,
+           wire_len * 1e3 / ns_per_frame);
+}
+
+static void run_encode(const char* name, encode_path path,
+                       const struct codec_case* c, uint32_t iterations) {
+    uint64_t start;
+    uint32_t i;
+
+    start = benchmark_now_ns();
+    for (i = 0; i < iterations; i++) {
+        path(c);
+        sensirion_uart_hal_memory_reset();
+    }
+    report(name, c, c->request_len, iterations, benchmark_now_ns() - start);
+}
+
+static void run_decode(const char* name, decode_path path,
+                       const struct codec_case* c, uint32_t iterations) {
+    struct sensirion_shdlc_rx_header header;
+    uint8_t* data;
+    uint64_t start;
+    uint32_t i;
+
+    start = benchmark_now_ns();
+    for (i = 0; i < iterations; i++) {
+        path(c, &header, &data);
+        sensirion_uart_hal_memory_reset();
+    }
+    report(name, c, c->response_len, iterations, benchmark_now_ns() - start);
+}
+
+int main(int argc, char** argv) {
+    static const struct {
+        const char* name;
+        encode_path path;
+    } encoders[] = {
+        {"tx", encode_tx},
+        {"tx_frame", encode_builder},
+        {"write_req", encode_stream},
+    };
+    static const struct {
+        const char* name;
+        decode_path path;
+    } decoders[] = {
+        {"rx", decode_rx},
+        {"rx_inplace", decode_rx_inplace},
+        {"read_resp", decode_stream},
+    };
+    static struct codec_case c;
+    uint32_t iterations = BENCHMARK_DEFAULT_ITERATIONS;
+    bool ok = true;
+    size_t l, e, p;
+
+    if (argc > 1) {
+        iterations = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if (iterations == 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+    sensirion_uart_hal_init(NULL);
+
+    printf("%-12s %5s %8s %6s %10s %10s\n", "path", "data", "escapes",
+           "wire", "ns/frame", "MB/s");
+    for (l = 0; l < sizeof(data_lengths); l++) {
+        for (e = 0; e < sizeof(escape_percents); e++) {
+            if (data_lengths[l] == 0 && escape_percents[e] != 0) {
+                continue;
+            }
+            codec_case_init(&c, data_lengths[l], escape_percents[e]);
+            for (p = 0; p < sizeof(encoders) / sizeof(encoders[0]); p++) {
+                if (!check_encode(encoders[p].name, encoders[p].path, &c)) {
+                    ok = false;
+                    continue;
+                }
+                run_encode(encoders[p].name, encoders[p].path, &c,
+                           iterations);
+            }
+            for (p = 0; p < sizeof(decoders) / sizeof(decoders[0]); p++) {
+                if (!check_decode(decoders[p].name, decoders[p].path, &c)) {
+                    ok = false;
+                    continue;
+                }
+                run_decode(decoders[p].name, decoders[p].path, &c,
+                           iterations);
+            }
+        }
+    }
+    sensirion_uart_hal_free();
+    if (!ok) {
+        fprintf(stderr, "codec paths disagree\n");
+        return 1;
+    }
+    return 0;
+}
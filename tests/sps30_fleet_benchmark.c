@@ -0,0 +1,363 @@
+/*
+ * Fleet scalability benchmark: one thread polls N simulated SPS30 on
+ * pseudo-terminals at 1 Hz through the port selection of the UART HAL.
+ *
+ * Every simulator produces a new measurement per second. Each round the
+ * poller selects every port in turn and reads the measured values, then
+ * sleeps until the next round. For each fleet size the benchmark reports
+ *   - the achieved rate of new samples against the ideal N samples/s,
+ *   - samples which were overwritten before they were read,
+ *   - the CPU time of the polling thread per sample and its share of a core,
+ *   - the resident memory per device, including the simulator,
+ *   - the worst-case age of a sample when it was read and
+ *   - the round duration, which bounds how many sensors one sequential
+ *     poller can serve at 1 Hz with this transport and
+ *   - the time sps30_discovery_scan() takes to find the fleet at startup,
+ *     optionally among empty ports which never answer.
+ *
+ * The simulators run on a second thread and are not included in the CPU time
+ * of the poller. Build with SENSIRION_UART_HAL_POLL=1 to measure the poll(2)
+ * transport of the Linux HAL instead of its sleep-polling reads.
+ */
+
+/* Enable getopt, RUSAGE_THREAD and clock_nanosleep */
+#define _GNU_SOURCE
+
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_discovery.h"
+#include "sps30_simulator_pty.h"
+#include "sps30_uart.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#if SENSIRION_UART_HAL_POLL
+#define BENCHMARK_VARIANT "poll"
+#else
+#define BENCHMARK_VARIANT "sleep-poll"
+#endif
+
+#define BENCHMARK_DEFAULT_SECONDS 10
+#define BENCHMARK_POLL_PERIOD_US 1000000
+
+static const uint32_t default_fleet_sizes[] = {10, 100, 1000};
+#define FLEET_DEFAULT_SIZES                                                    \
+    (int)(sizeof(default_fleet_sizes) / sizeof(default_fleet_sizes[0]))
+
+struct fleet_result {
+    uint32_t devices;
+    uint32_t rounds;
+    uint32_t overruns;  //< rounds which took longer than the poll period
+    uint64_t samples;
+    uint64_t lost_samples;
+    uint64_t errors;
+    uint64_t elapsed_us;
+    uint64_t cpu_us;
+    uint64_t max_age_us;
+    uint64_t max_round_us;
+    uint64_t total_round_us;
+    uint64_t discovery_us;
+    long rss_per_device;
+};
+
+struct fleet_device {
+    uint64_t samples_seen;
+};
+
+static struct sps30_simulator_pty* fleet;
+static size_t fleet_size;
+static volatile bool stop_server;
+
+static void* serve(void* arg) {
+    (void)arg;
+    if (sps30_simulator_pty_serve(fleet, fleet_size, &stop_server) != 0) {
+        perror("simulator");
+    }
+    return NULL;
+}
+
+static uint64_t thread_cpu_us(void) {
+    struct rusage usage;
+
+    getrusage(RUSAGE_THREAD, &usage);
+    return (uint64_t)usage.ru_utime.tv_sec * 1000000 +
+           (uint64_t)usage.ru_utime.tv_usec +
+           (uint64_t)usage.ru_stime.tv_sec * 1000000 +
+           (uint64_t)usage.ru_stime.tv_usec;
+}
+
+static long resident_bytes(void) {
+    long size = 0;
+    long resident = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+
+    if (statm == NULL) {
+        return 0;
+    }
+    if (fscanf(statm, "%ld %ld", &size, &resident) != 2) {
+        resident = 0;
+    }
+    fclose(statm);
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+/* each pseudo-terminal needs three file descriptors */
+static void raise_file_limit(size_t devices) {
+    struct rlimit limit;
+
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return;
+    }
+    if (limit.rlim_cur < devices * 3 + 16) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+static void sleep_until_us(uint64_t deadline_us) {
+    struct timespec deadline;
+
+    deadline.tv_sec = (time_t)(deadline_us / 1000000);
+    deadline.tv_nsec = (long)(deadline_us % 1000000) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) !=
+           0) {
+    }
+}
+
+static int16_t read_sample(void) {
+    float values[10];
+
+    return sps30_read_measurement_values_float(
+        &values[0], &values[1], &values[2], &values[3], &values[4], &values[5],
+        &values[6], &values[7], &values[8], &values[9]);
+}
+
+/* account a successful read which completed at now_us */
+static void account_sample(struct fleet_result* result,
+                           struct fleet_device* device,
+                           const struct sps30_simulator* sim, uint64_t now_us) {
+    uint64_t samples_read = sim->samples_read;
+    uint64_t produced_us;
+
+    if (samples_read <= device->samples_seen) {
+        return;
+    }
+    result->samples++;
+    result->lost_samples += samples_read - device->samples_seen - 1;
+    device->samples_seen = samples_read;
+
+    /* the sample became available one interval after the previous one */
+    produced_us = sim->measurement_start_us +
+                  samples_read * sim->measurement_interval_us;
+    if (now_us > produced_us && now_us - produced_us > result->max_age_us) {
+        result->max_age_us = now_us - produced_us;
+    }
+}
+
+static int run_fleet(uint32_t devices, uint32_t empty_ports, uint32_t seconds,
+                     uint32_t response_delay_us, struct fleet_result* result) {
+    uint32_t ports = devices + empty_ports;
+    struct sps30_discovery_device* registry;
+    struct fleet_device* state;
+    UartDescr* paths;
+    pthread_t server;
+    uint64_t discovery_start_us;
+    int16_t found;
+    int16_t error;
+    uint64_t start_us;
+    uint64_t round_start_us;
+    uint64_t round_us;
+    uint64_t cpu_start_us;
+    long rss_start;
+    uint32_t i;
+
+    raise_file_limit(ports);
+    rss_start = resident_bytes();
+    fleet = calloc(ports, sizeof(*fleet));
+    state = calloc(devices, sizeof(*state));
+    paths = calloc(ports, sizeof(*paths));
+    registry = calloc(ports, sizeof(*registry));
+    if (fleet == NULL || state == NULL || paths == NULL || registry == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return -1;
+    }
+    /* the simulators of the empty ports are never served */
+    for (i = 0; i < ports; i++) {
+        if (sps30_simulator_pty_open(&fleet[i], i) != 0) {
+            perror("pseudo-terminal");
+            return -1;
+        }
+        fleet[i].sim.response_delay_us = response_delay_us;
+        paths[i] = fleet[i].slave_path;
+    }
+    fleet_size = devices;
+    stop_server = false;
+    if (pthread_create(&server, NULL, serve, NULL) != 0) {
+        fprintf(stderr, "failed to start the simulators\n");
+        return -1;
+    }
+
+    discovery_start_us = sps30_simulator_pty_now_us();
+    found = sps30_discovery_scan(paths, (uint16_t)ports, 0,
+                                 SPS30_DEVICE_INFORMATION_TIMEOUT_MS, registry,
+                                 (uint16_t)ports);
+    *result = (struct fleet_result){0};
+    result->discovery_us = sps30_simulator_pty_now_us() - discovery_start_us;
+    if (found != (int16_t)devices) {
+        fprintf(stderr, "discovered %d of %u devices\n", found, devices);
+        return -1;
+    }
+    for (i = 0; i < devices; i++) {
+        if (registry[i].port != i ||
+            sensirion_uart_hal_select_port((uint16_t)i) != NO_ERROR ||
+            sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT) !=
+                NO_ERROR) {
+            fprintf(stderr, "failed to start device %u\n", i);
+            return -1;
+        }
+    }
+
+    result->devices = devices;
+    /* the first round finds a sample on every device */
+    start_us = sps30_simulator_pty_now_us() + BENCHMARK_POLL_PERIOD_US;
+    sleep_until_us(start_us);
+    cpu_start_us = thread_cpu_us();
+    for (result->rounds = 0; result->rounds < seconds; result->rounds++) {
+        round_start_us =
+            start_us + (uint64_t)result->rounds * BENCHMARK_POLL_PERIOD_US;
+        sleep_until_us(round_start_us);
+        round_start_us = sps30_simulator_pty_now_us();
+        for (i = 0; i < devices; i++) {
+            sensirion_uart_hal_select_port((uint16_t)i);
+            error = read_sample();
+            /* polled before the next sample, lost samples show it */
+            if (error == SENSIRION_SHDLC_ERR_NO_DATA) {
+                continue;
+            }
+            if (error != NO_ERROR) {
+                result->errors++;
+                continue;
+            }
+            account_sample(result, &state[i], &fleet[i].sim,
+                           sps30_simulator_pty_now_us());
+        }
+        round_us = sps30_simulator_pty_now_us() - round_start_us;
+        result->total_round_us += round_us;
+        if (round_us > result->max_round_us) {
+            result->max_round_us = round_us;
+        }
+        if (round_us > BENCHMARK_POLL_PERIOD_US) {
+            result->overruns++;
+        }
+    }
+    /* rounds which overran stretch the run beyond its nominal duration */
+    result->elapsed_us = sps30_simulator_pty_now_us() - start_us;
+    if (result->elapsed_us < (uint64_t)seconds * BENCHMARK_POLL_PERIOD_US) {
+        result->elapsed_us = (uint64_t)seconds * BENCHMARK_POLL_PERIOD_US;
+    }
+    result->cpu_us = thread_cpu_us() - cpu_start_us;
+    result->rss_per_device = (resident_bytes() - rss_start) / (long)devices;
+
+    for (i = 0; i < devices; i++) {
+        sensirion_uart_hal_select_port((uint16_t)i);
+        sps30_stop_measurement();
+        sensirion_uart_hal_free();
+    }
+    stop_server = true;
+    pthread_join(server, NULL);
+    for (i = 0; i < ports; i++) {
+        sps30_simulator_pty_close(&fleet[i]);
+    }
+    free(registry);
+    free(paths);
+    free(state);
+    free(fleet);
+    return 0;
+}
+
+static void print_result(const struct fleet_result* r) {
+    double seconds = (double)r->elapsed_us / 1e6;
+    double core = (double)r->cpu_us / (double)r->elapsed_us;
+    double mean_round_us = (double)r->total_round_us / r->rounds;
+
+    printf("%7u %9.1f %9.1f %6llu %6llu %8.1f %6.2f %7ld %9.1f %9.1f "
+           "%9.1f %5u %9.0f %9.0f %8.1f\n",
+           r->devices, (double)r->samples / seconds, (double)r->devices,
+           (unsigned long long)r->lost_samples,
+           (unsigned long long)r->errors,
+           r->samples ? (double)r->cpu_us / r->samples : 0.0, core * 100,
+           r->rss_per_device, (double)r->max_age_us / 1000,
+           mean_round_us / 1000, (double)r->max_round_us / 1000, r->overruns,
+           core > 0 ? r->devices / core : 0.0,
+           r->devices * BENCHMARK_POLL_PERIOD_US / mean_round_us,
+           (double)r->discovery_us / 1000);
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t seconds = BENCHMARK_DEFAULT_SECONDS;
+    uint32_t response_delay_us = 0;
+    uint32_t empty_ports = 0;
+    struct fleet_result result;
+    uint32_t devices;
+    int failures = 0;
+    int count;
+    int opt;
+    int i;
+
+    while ((opt = getopt(argc, argv, "s:d:e:")) != -1) {
+        switch (opt) {
+            case 's':
+                seconds = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'd':
+                response_delay_us = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'e':
+                empty_ports = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr,
+                        "usage: %s [-s seconds] [-d delay_us] [-e empty_ports] "
+                        "[devices...]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+    if (seconds == 0) {
+        seconds = 1;
+    }
+
+    printf("%s transport, %u s per fleet, emulated device delay %u us, "
+           "%u empty ports\n",
+           BENCHMARK_VARIANT, seconds, response_delay_us, empty_ports);
+    printf("%7s %9s %9s %6s %6s %8s %6s %7s %9s %9s %9s %5s %9s %9s %8s\n",
+           "devices", "samples/s", "ideal", "lost", "errors", "cpu us",
+           "core%", "rss B", "age ms", "round ms", "max ms", "overr",
+           "max/core", "max/seq", "disc ms");
+
+    count = optind < argc ? argc - optind : FLEET_DEFAULT_SIZES;
+    for (i = 0; i < count; i++) {
+        devices = optind < argc ? (uint32_t)strtoul(argv[optind + i], NULL, 0)
+                                : default_fleet_sizes[i];
+        if (devices == 0 || devices + empty_ports > SENSIRION_UART_MAX_PORTS) {
+            fprintf(stderr, "%u devices not supported, at most %u ports\n",
+                    devices + empty_ports, (unsigned)SENSIRION_UART_MAX_PORTS);
+            failures++;
+            continue;
+        }
+        if (run_fleet(devices, empty_ports, seconds, response_delay_us,
+                      &result) != 0) {
+            return 1;
+        }
+        print_result(&result);
+        if (result.errors != 0) {
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,392 @@
+/*
+ * End-to-end latency benchmark of the sps30_* functions against a simulated
+ * SPS30 on a pseudo-terminal.
+ *
+ * The driver talks to the simulator through the Linux UART HAL like it would
+ * to a real serial port. Every public command is executed repeatedly and the
+ * round-trip time is split into the time the simulator spent before writing
+ * its response (the emulated device delay, see -d) and the remainder, which is
+ * the latency added by the driver, the HAL and the kernel.
+ *
+ * The transport variant is selected at build time: the default Linux HAL
+ * sleeps between reads, with SENSIRION_UART_HAL_POLL=1 it waits in poll(2).
+ * Both builds also measure the legacy sensirion_shdlc_xcv() path, which polls
+ * for the response through the same HAL.
+ */
+
+/* Enable getopt */
+#define _DEFAULT_SOURCE
+
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart_hal.h"
+#include "sps30_simulator_pty.h"
+#include "sps30_uart.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#if SENSIRION_UART_HAL_POLL
+#define BENCHMARK_VARIANT "poll"
+#else
+#define BENCHMARK_VARIANT "sleep-poll"
+#endif
+
+#define BENCHMARK_DEFAULT_ITERATIONS 1000
+
+struct latency_stats {
+    const char* name;
+    uint32_t errors;
+    uint32_t count;
+    uint32_t* rtt_us;
+    uint32_t* device_us;
+    uint32_t* overhead_us;
+};
+
+struct api_command {
+    const char* name;
+    int16_t (*run)(void);
+};
+
+struct xcv_command {
+    const char* name;
+    uint8_t cmd;
+    uint8_t tx_data_len;
+    uint8_t tx_data[5];
+    uint8_t max_rx_data_len;
+};
+
+static struct sps30_simulator_pty device;
+static volatile bool stop_server;
+
+static int16_t run_read_product_type(void) {
+    int8_t product_type[32];
+
+    return sps30_read_product_type(product_type, sizeof(product_type));
+}
+
+static int16_t run_read_serial_number(void) {
+    int8_t serial_number[32];
+
+    return sps30_read_serial_number(serial_number, sizeof(serial_number));
+}
+
+static int16_t run_read_version(void) {
+    uint8_t major, minor, reserved1, hardware, reserved2, shdlc_major,
+        shdlc_minor;
+
+    return sps30_read_version(&major, &minor, &reserved1, &hardware,
+                              &reserved2, &shdlc_major, &shdlc_minor);
+}
+
+static int16_t run_read_device_status_register(void) {
+    uint32_t status;
+    uint8_t reserved;
+
+    return sps30_read_device_status_register(false, &status, &reserved);
+}
+
+static int16_t run_read_auto_cleaning_interval(void) {
+    uint32_t interval;
+
+    return sps30_read_auto_cleaning_interval(&interval);
+}
+
+static int16_t run_write_auto_cleaning_interval(void) {
+    return sps30_write_auto_cleaning_interval(604800);
+}
+
+static int16_t run_start_measurement_uint16(void) {
+    return sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_UINT16);
+}
+
+static int16_t run_read_measurement_values_uint16(void) {
+    uint16_t values[10];
+
+    return sps30_read_measurement_values_uint16(
+        &values[0], &values[1], &values[2], &values[3], &values[4], &values[5],
+        &values[6], &values[7], &values[8], &values[9]);
+}
+
+static int16_t run_start_measurement_float(void) {
+    return sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+}
+
+static int16_t run_read_measurement_values_float(void) {
+    float values[10];
+
+    return sps30_read_measurement_values_float(
+        &values[0], &values[1], &values[2], &values[3], &values[4], &values[5],
+        &values[6], &values[7], &values[8], &values[9]);
+}
+
+/*
+ * One iteration covers every public function and leaves the simulator idle.
+ * sps30_wake_up_sequence() covers sps30_wake_up_communication() and
+ * sps30_wake_up().
+ */
+static const struct api_command api_commands[] = {
+    {"read_product_type", run_read_product_type},
+    {"read_serial_number", run_read_serial_number},
+    {"read_version", run_read_version},
+    {"read_device_status_register", run_read_device_status_register},
+    {"read_auto_cleaning_interval", run_read_auto_cleaning_interval},
+    {"write_auto_cleaning_interval", run_write_auto_cleaning_interval},
+    {"start_measurement (uint16)", run_start_measurement_uint16},
+    {"read_measurement_values_uint16", run_read_measurement_values_uint16},
+    {"device_reset", sps30_device_reset},
+    {"start_measurement (float)", run_start_measurement_float},
+    {"read_measurement_values_float", run_read_measurement_values_float},
+    {"start_fan_cleaning", sps30_start_fan_cleaning},
+    {"stop_measurement", sps30_stop_measurement},
+    {"sleep", sps30_sleep},
+    {"wake_up_sequence", sps30_wake_up_sequence},
+};
+
+#define API_COMMAND_COUNT (sizeof(api_commands) / sizeof(api_commands[0]))
+
+/* the same sequence as raw SHDLC transactions, the wake-up pulse is sent
+ * separately before the wake-up command */
+static const struct xcv_command xcv_commands[] = {
+    {"read_product_type", 0xd0, 1, {0x00}, 32},
+    {"read_serial_number", 0xd0, 1, {0x03}, 32},
+    {"read_version", 0xd1, 0, {0}, 7},
+    {"read_device_status_register", 0xd2, 1, {0x00}, 5},
+    {"read_auto_cleaning_interval", 0x80, 1, {0x00}, 4},
+    {"write_auto_cleaning_interval", 0x80, 5, {0x00, 0x00, 0x09, 0x3a, 0x80},
+     0},
+    {"start_measurement (uint16)", 0x00, 2, {0x01, 0x05}, 0},
+    {"read_measurement_values_uint16", 0x03, 0, {0}, 20},
+    {"device_reset", 0xd3, 0, {0}, 0},
+    {"start_measurement (float)", 0x00, 2, {0x01, 0x03}, 0},
+    {"read_measurement_values_float", 0x03, 0, {0}, 40},
+    {"start_fan_cleaning", 0x56, 0, {0}, 0},
+    {"stop_measurement", 0x01, 0, {0}, 0},
+    {"sleep", 0x10, 0, {0}, 0},
+    {"wake_up", 0x11, 0, {0}, 0},
+};
+
+#define XCV_COMMAND_COUNT (sizeof(xcv_commands) / sizeof(xcv_commands[0]))
+#define XCV_WAKE_UP_CMD 0x11
+
+static int16_t run_xcv(const struct xcv_command* command) {
+    struct sensirion_shdlc_rx_header header;
+    uint8_t rx_data[255];
+    int16_t ret;
+
+    if (command->cmd == XCV_WAKE_UP_CMD) {
+        ret = sensirion_shdlc_tx(SPS30_SHDLC_ADDR, 0xff, 0, NULL);
+        if (ret != NO_ERROR) {
+            return ret;
+        }
+    }
+    return sensirion_shdlc_xcv(SPS30_SHDLC_ADDR, command->cmd,
+                               command->tx_data_len, command->tx_data,
+                               command->max_rx_data_len, &header, rx_data);
+}
+
+static void* serve(void* arg) {
+    (void)arg;
+    if (sps30_simulator_pty_serve(&device, 1, &stop_server) != 0) {
+        perror("simulator");
+    }
+    return NULL;
+}
+
+static int stats_init(struct latency_stats* stats, size_t count,
+                      uint32_t iterations) {
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        stats[i].errors = 0;
+        stats[i].count = 0;
+        stats[i].rtt_us = calloc(iterations, sizeof(uint32_t));
+        stats[i].device_us = calloc(iterations, sizeof(uint32_t));
+        stats[i].overhead_us = calloc(iterations, sizeof(uint32_t));
+        if (stats[i].rtt_us == NULL || stats[i].device_us == NULL ||
+            stats[i].overhead_us == NULL) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void stats_free(struct latency_stats* stats, size_t count) {
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        free(stats[i].rtt_us);
+        free(stats[i].device_us);
+        free(stats[i].overhead_us);
+    }
+}
+
+static void stats_record(struct latency_stats* stats, int16_t ret,
+                         uint64_t rtt_us) {
+    uint64_t device_us = device.last_response_delay_us;
+
+    if (ret != NO_ERROR) {
+        stats->errors++;
+        return;
+    }
+    if (device_us > rtt_us) {
+        device_us = rtt_us;
+    }
+    stats->rtt_us[stats->count] = (uint32_t)rtt_us;
+    stats->device_us[stats->count] = (uint32_t)device_us;
+    stats->overhead_us[stats->count] = (uint32_t)(rtt_us - device_us);
+    stats->count++;
+}
+
+static int compare_uint32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+/* nearest-rank percentile, sorts the samples */
+static uint32_t percentile(uint32_t* samples, uint32_t count,
+                           uint32_t percent) {
+    uint32_t rank;
+
+    if (count == 0) {
+        return 0;
+    }
+    qsort(samples, count, sizeof(*samples), compare_uint32);
+    rank = (count * percent + 99) / 100;
+    return samples[rank > 0 ? rank - 1 : 0];
+}
+
+static void stats_print(const char* variant, struct latency_stats* stats,
+                        size_t count) {
+    size_t i;
+
+    printf("\n%s\n", variant);
+    printf("%-32s %6s %6s %8s %8s %8s %8s %8s %8s\n", "command", "n", "errors",
+           "rtt p50", "p99", "dev p50", "p99", "drv p50", "p99");
+    for (i = 0; i < count; i++) {
+        struct latency_stats* s = &stats[i];
+
+        printf("%-32s %6u %6u %8u %8u %8u %8u %8u %8u\n", s->name, s->count,
+               s->errors, percentile(s->rtt_us, s->count, 50),
+               percentile(s->rtt_us, s->count, 99),
+               percentile(s->device_us, s->count, 50),
+               percentile(s->device_us, s->count, 99),
+               percentile(s->overhead_us, s->count, 50),
+               percentile(s->overhead_us, s->count, 99));
+    }
+}
+
+static uint32_t benchmark_api(uint32_t iterations) {
+    struct latency_stats stats[API_COMMAND_COUNT];
+    uint32_t errors = 0;
+    uint64_t start_us;
+    int16_t ret;
+    uint32_t n;
+    size_t i;
+
+    if (stats_init(stats, API_COMMAND_COUNT, iterations) != 0) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    for (n = 0; n < iterations; n++) {
+        for (i = 0; i < API_COMMAND_COUNT; i++) {
+            stats[i].name = api_commands[i].name;
+            device.last_response_delay_us = 0;
+            start_us = sps30_simulator_pty_now_us();
+            ret = api_commands[i].run();
+            stats_record(&stats[i], ret,
+                         sps30_simulator_pty_now_us() - start_us);
+        }
+    }
+    stats_print("sps30_* (" BENCHMARK_VARIANT ")", stats, API_COMMAND_COUNT);
+    for (i = 0; i < API_COMMAND_COUNT; i++) {
+        errors += stats[i].errors;
+    }
+    stats_free(stats, API_COMMAND_COUNT);
+    return errors;
+}
+
+static uint32_t benchmark_xcv(uint32_t iterations) {
+    struct latency_stats stats[XCV_COMMAND_COUNT];
+    uint32_t errors = 0;
+    uint64_t start_us;
+    int16_t ret;
+    uint32_t n;
+    size_t i;
+
+    if (stats_init(stats, XCV_COMMAND_COUNT, iterations) != 0) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    for (n = 0; n < iterations; n++) {
+        for (i = 0; i < XCV_COMMAND_COUNT; i++) {
+            stats[i].name = xcv_commands[i].name;
+            device.last_response_delay_us = 0;
+            start_us = sps30_simulator_pty_now_us();
+            ret = run_xcv(&xcv_commands[i]);
+            stats_record(&stats[i], ret,
+                         sps30_simulator_pty_now_us() - start_us);
+        }
+    }
+    stats_print("sensirion_shdlc_xcv (" BENCHMARK_VARIANT ")", stats,
+                XCV_COMMAND_COUNT);
+    for (i = 0; i < XCV_COMMAND_COUNT; i++) {
+        errors += stats[i].errors;
+    }
+    stats_free(stats, XCV_COMMAND_COUNT);
+    return errors;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t iterations = BENCHMARK_DEFAULT_ITERATIONS;
+    uint32_t response_delay_us = 0;
+    uint32_t errors;
+    pthread_t server;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:d:")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'd':
+                response_delay_us = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations] [-d delay_us]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    if (sps30_simulator_pty_open(&device, 1) != 0) {
+        perror("pseudo-terminal");
+        return 1;
+    }
+    device.sim.measurement_interval_us = 0;
+    device.sim.response_delay_us = response_delay_us;
+    if (pthread_create(&server, NULL, serve, NULL) != 0) {
+        fprintf(stderr, "failed to start the simulator\n");
+        return 1;
+    }
+    if (sensirion_uart_hal_init(device.slave_path) != NO_ERROR) {
+        return 1;
+    }
+
+    printf("%u iterations, emulated device delay %u us, times in us\n",
+           iterations, response_delay_us);
+    errors = benchmark_api(iterations);
+    errors += benchmark_xcv(iterations);
+
+    sensirion_uart_hal_free();
+    stop_server = true;
+    pthread_join(server, NULL);
+    sps30_simulator_pty_close(&device);
+    return errors == 0 ? 0 : 1;
+}
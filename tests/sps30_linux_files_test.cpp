@@ -0,0 +1,299 @@
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_shdlc_recorder.h"
+#include "sensirion_shdlc_recorder_file.h"
+#include "sensirion_shdlc_retry.h"
+#include "sensirion_test_setup.h"
+#include "sensirion_uart_hal.h"
+#include "sensirion_uart_hal_virtual.h"
+#include "sensirion_uart_hotplug.h"
+#include "sps30_log.h"
+#include "sps30_log_file.h"
+#include "sps30_simulator.h"
+#include "sps30_test_helpers.h"
+#include "sps30_uart.h"
+#include <dirent.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * The file and device helpers of sample-implementations/linux_user_space,
+ * run in a temporary directory. The virtual HAL accepts any path as a port,
+ * so the hotplug tests can stand in regular files for device nodes.
+ */
+
+#define SPS30_RESPONSE_DELAY_US 5000
+
+static struct sps30_simulator simulator;
+static char directory[] = "/tmp/sps30_linux_files_test.XXXXXX";
+
+/* path of a file in the temporary directory */
+static const char* file_path(const char* name) {
+    static char path[sizeof(directory) + 64];
+
+    snprintf(path, sizeof(path), "%s/%s", directory, name);
+    return path;
+}
+
+static uint16_t count_files() {
+    struct dirent* entry;
+    uint16_t count = 0;
+    DIR* dir = opendir(directory);
+
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            count++;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+static int remove_file(const char* path, const struct stat* st, int type,
+                       struct FTW* ftw) {
+    (void)st;
+    (void)type;
+    (void)ftw;
+    return remove(path);
+}
+
+static uint8_t num_connects;
+static uint8_t num_disconnects;
+
+static void count_hotplug(uint16_t port, bool connected, void* user_data) {
+    (void)port;
+    (void)user_data;
+    if (connected) {
+        num_connects++;
+    } else {
+        num_disconnects++;
+    }
+}
+
+static void create_file(const char* name) {
+    FILE* file = fopen(file_path(name), "w");
+
+    CHECK(file != NULL);
+    fclose(file);
+}
+
+static void make_record(struct sps30_log_record* record, uint16_t i) {
+    uint16_t j;
+
+    record->timestamp_us = (uint64_t)i * 1000000;
+    for (j = 0; j < SPS30_LOG_FIELD_COUNT; j++) {
+        record->fields[j] = (uint32_t)(i * 3 + j);
+    }
+}
+
+TEST_GROUP (SPS30_Linux_Files_Tests) {
+    void setup() {
+        int16_t error;
+        strcpy(directory + sizeof(directory) - 7, "XXXXXX");
+        CHECK(mkdtemp(directory) != NULL);
+        sensirion_uart_hal_virtual_reset();
+        error = sensirion_shdlc_retry_set_policy(0, &single_attempt);
+        CHECK_EQUAL_ZERO_TEXT(error, "sensirion_shdlc_retry_set_policy");
+        error = sensirion_uart_hal_init(SERIAL_0);
+        CHECK_EQUAL_ZERO_TEXT(error, "sensirion_uart_hal_init");
+        sps30_simulator_init(&simulator, 1);
+        sensirion_uart_hal_virtual_set_device(simulated_sps30, &simulator);
+        sensirion_uart_hal_virtual_set_response_delay_usec(
+            SPS30_RESPONSE_DELAY_US);
+        /* a timestamp of 0 means that it was not taken */
+        sensirion_uart_hal_virtual_advance_usec(1000);
+    }
+
+    void teardown() {
+        int16_t error;
+        sensirion_shdlc_recorder_set_dump_callback(NULL, NULL);
+        sensirion_uart_hotplug_close();
+        sensirion_uart_hotplug_set_callback(NULL, NULL);
+        error = sensirion_uart_hal_free();
+        CHECK_EQUAL_ZERO_TEXT(error, "sensirion_uart_hal_free");
+        nftw(directory, remove_file, 8, FTW_DEPTH | FTW_PHYS);
+    }
+};
+
+TEST (SPS30_Linux_Files_Tests, test_recorder_file_holds_snapshot) {
+    struct sensirion_shdlc_recorder_entry
+        expected[SENSIRION_SHDLC_RECORDER_DEPTH];
+    struct sensirion_shdlc_recorder_entry
+        entries[SENSIRION_SHDLC_RECORDER_DEPTH];
+    struct sensirion_shdlc_recorder_file_header header;
+    uint16_t num_entries;
+    int16_t local_error = 0;
+    FILE* file;
+    uint8_t i;
+    for (i = 0; i < 3; i++) {
+        local_error = read_version();
+        CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    }
+    num_entries = sensirion_shdlc_recorder_snapshot(
+        0, expected, SENSIRION_SHDLC_RECORDER_DEPTH);
+    CHECK(num_entries >= 3);
+    local_error = sensirion_shdlc_recorder_write_file(0, file_path("dump"));
+    CHECK_EQUAL_ZERO_TEXT(local_error, "recorder_write_file");
+    /* the temporary file was renamed */
+    CHECK_EQUAL(1, count_files());
+
+    file = fopen(file_path("dump"), "rb");
+    CHECK(file != NULL);
+    CHECK_EQUAL(1, fread(&header, sizeof(header), 1, file));
+    CHECK_EQUAL(0, memcmp(header.magic, SENSIRION_SHDLC_RECORDER_FILE_MAGIC,
+                          sizeof(header.magic)));
+    CHECK_EQUAL(SENSIRION_SHDLC_RECORDER_FILE_VERSION, header.version);
+    CHECK_EQUAL(0, header.port);
+    CHECK_EQUAL(sizeof(entries[0]), header.entry_size);
+    CHECK_EQUAL(SENSIRION_SHDLC_RECORDER_FRAME_SIZE, header.frame_size);
+    CHECK_EQUAL(num_entries, header.count);
+    CHECK_EQUAL(num_entries,
+                fread(entries, sizeof(entries[0]), num_entries, file));
+    CHECK(fgetc(file) == EOF);
+    fclose(file);
+    CHECK_EQUAL(0, memcmp(entries, expected, num_entries * sizeof(entries[0])));
+}
+
+TEST (SPS30_Linux_Files_Tests, test_recorder_dumps_to_directory) {
+    int16_t local_error = 0;
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    sensirion_shdlc_recorder_set_dump_callback(
+        sensirion_shdlc_recorder_dump_to_directory, directory);
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT, 1);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CRC_MISMATCH, local_error);
+    CHECK_EQUAL(1, count_files());
+}
+
+TEST (SPS30_Linux_Files_Tests, test_hotplug_reopens_recreated_device) {
+    char path[sizeof(directory) + 64];
+    int16_t local_error = 0;
+    num_connects = 0;
+    num_disconnects = 0;
+    strcpy(path, file_path("ttyUSB0"));
+    local_error = sensirion_uart_hotplug_open();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "hotplug_open");
+    sensirion_uart_hotplug_set_callback(count_hotplug, NULL);
+    local_error = sensirion_uart_hotplug_watch(0, path);
+    CHECK_EQUAL(1, local_error);
+    CHECK(!sensirion_uart_hotplug_is_connected(0));
+    CHECK_EQUAL(0, sensirion_uart_hotplug_process(0));
+
+    create_file("ttyUSB0");
+    CHECK_EQUAL(1, sensirion_uart_hotplug_process(1000));
+    CHECK(sensirion_uart_hotplug_is_connected(0));
+    CHECK_EQUAL(1, num_connects);
+
+    unlink(path);
+    CHECK_EQUAL(1, sensirion_uart_hotplug_process(1000));
+    CHECK(!sensirion_uart_hotplug_is_connected(0));
+    CHECK_EQUAL(1, num_disconnects);
+
+    create_file("ttyUSB0");
+    CHECK_EQUAL(1, sensirion_uart_hotplug_process(1000));
+    CHECK(sensirion_uart_hotplug_is_connected(0));
+    CHECK_EQUAL(2, num_connects);
+
+    /* another node under the same path is another adapter */
+    create_file("ttyUSB0.new");
+    CHECK_EQUAL(0, rename(file_path("ttyUSB0.new"), path));
+    CHECK_EQUAL(2, sensirion_uart_hotplug_process(1000));
+    CHECK(sensirion_uart_hotplug_is_connected(0));
+    CHECK_EQUAL(3, num_connects);
+    CHECK_EQUAL(2, num_disconnects);
+
+    /* the device is still usable through the HAL */
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+}
+
+TEST (SPS30_Linux_Files_Tests, test_hotplug_watches_created_directory) {
+    char path[sizeof(directory) + 64];
+    int16_t local_error = 0;
+    strcpy(path, file_path("by-id/usb-FTDI-port0"));
+    local_error = sensirion_uart_hotplug_open();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "hotplug_open");
+    local_error = sensirion_uart_hotplug_watch(0, path);
+    CHECK_EQUAL(1, local_error);
+
+    CHECK_EQUAL(0, mkdir(file_path("by-id"), 0755));
+    CHECK_EQUAL(0, sensirion_uart_hotplug_process(1000));
+    create_file("by-id/usb-FTDI-port0");
+    CHECK_EQUAL(1, sensirion_uart_hotplug_process(1000));
+    CHECK(sensirion_uart_hotplug_is_connected(0));
+}
+
+TEST (SPS30_Linux_Files_Tests, test_log_file_reopens_after_truncated_write) {
+    struct sps30_identity identity = {{0}};
+    struct sps30_log_header header;
+    struct sps30_log_reader reader;
+    struct sps30_log_record expected;
+    struct sps30_log_record record;
+    struct sps30_log_file file;
+    uint64_t ends[5];
+    int16_t local_error = 0;
+    uint16_t i;
+    sps30_log_header_init(&header, SPS30_LOG_FORMAT_UINT16, &identity);
+    local_error = sps30_log_file_open(&file, file_path("log"), &header);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "log_file_open");
+    for (i = 0; i < 5; i++) {
+        make_record(&record, i);
+        local_error = sps30_log_file_append(&file, &record);
+        CHECK_EQUAL_ZERO_TEXT(local_error, "log_file_append");
+        ends[i] = file.size;
+    }
+    sps30_log_file_close(&file);
+
+    /* a crash cut the last record short */
+    CHECK_EQUAL(0, truncate(file_path("log"), (off_t)(ends[4] - 1)));
+    local_error = sps30_log_file_open(&file, file_path("log"), &header);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "log_file_open after crash");
+    CHECK_EQUAL(ends[3], file.size);
+    /* the next records are encoded against the last complete one */
+    for (i = 5; i < 7; i++) {
+        make_record(&record, i);
+        local_error = sps30_log_file_append(&file, &record);
+        CHECK_EQUAL_ZERO_TEXT(local_error, "log_file_append");
+    }
+    sps30_log_file_close(&file);
+
+    local_error = sps30_log_file_map(file_path("log"), &reader);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "log_file_map");
+    for (i = 0; i < 7; i++) {
+        if (i == 4) {
+            continue;
+        }
+        local_error = sps30_log_reader_next(&reader, &record);
+        CHECK_EQUAL_ZERO_TEXT(local_error, "log_reader_next");
+        make_record(&expected, i);
+        CHECK(memcmp(&expected, &record, sizeof(record)) == 0);
+    }
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA,
+                sps30_log_reader_next(&reader, &record));
+    CHECK_EQUAL(reader.size, reader.offset);
+    sps30_log_file_unmap(&reader);
+}
+
+TEST (SPS30_Linux_Files_Tests, test_log_file_refuses_other_header) {
+    struct sps30_identity identity = {{0}};
+    struct sps30_log_header header;
+    struct sps30_log_file file;
+    int16_t local_error = 0;
+    sps30_log_header_init(&header, SPS30_LOG_FORMAT_UINT16, &identity);
+    local_error = sps30_log_file_open(&file, file_path("log"), &header);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "log_file_open");
+    sps30_log_file_close(&file);
+
+    /* a replaced sensor needs a new file */
+    identity.serial_number[0] = 'B';
+    sps30_log_header_init(&header, SPS30_LOG_FORMAT_UINT16, &identity);
+    local_error = sps30_log_file_open(&file, file_path("log"), &header);
+    CHECK_EQUAL(-1, local_error);
+    CHECK_EQUAL(-1, file.fd);
+}
@@ -0,0 +1,322 @@
+#include "sps30_simulator.h"
+#include "sensirion_common.h"
+#include <stdio.h>
+
+#define SHDLC_FRAME_DELIMITER 0x7e
+#define SHDLC_STUFF_BYTE 0x7d
+#define SPS30_WAKE_UP_BYTE 0xff
+
+#define SPS30_ADDR 0x00
+#define SPS30_FORMAT_FLOAT 0x03
+#define SPS30_FORMAT_UINT16 0x05
+
+struct sps30_simulator_response {
+    uint8_t state;
+    uint8_t data_len;
+    uint8_t data[255];
+};
+
+void sps30_simulator_init(struct sps30_simulator* sim, uint32_t id) {
+    sim->mode = SPS30_SIMULATOR_IDLE;
+    sim->interface_awake = false;
+    sim->output_format = SPS30_FORMAT_FLOAT;
+    sim->firmware_major = 2;
+    sim->firmware_minor = 3;
+    sim->auto_cleaning_interval_s = 604800;
+    sim->status_register = 0;
+    sim->concentration_offset = 0;
+    snprintf(sim->serial_number, sizeof(sim->serial_number), "SIM%013u",
+             (unsigned)id);
+    sim->measurement_interval_us = SPS30_SIMULATOR_MEASUREMENT_INTERVAL_US;
+    sim->response_delay_us = 0;
+    sim->measurement_start_us = 0;
+    sim->samples_read = 0;
+    sim->requests = 0;
+    sim->in_frame = false;
+    sim->unstuff_next = false;
+    sim->frame_len = 0;
+}
+
+static void sps30_simulator_add_uint16(struct sps30_simulator_response* r,
+                                       uint16_t value) {
+    sensirion_common_uint16_t_to_bytes(value, &r->data[r->data_len]);
+    r->data_len += 2;
+}
+
+static void sps30_simulator_add_float(struct sps30_simulator_response* r,
+                                      float value) {
+    sensirion_common_float_to_bytes(value, &r->data[r->data_len]);
+    r->data_len += 4;
+}
+
+/* deterministic values which change with every sample */
+static void sps30_simulator_measurement(struct sps30_simulator* sim,
+                                        struct sps30_simulator_response* r) {
+    uint16_t mc =
+        (uint16_t)(10 + sim->concentration_offset + sim->samples_read % 7);
+    uint16_t i;
+
+    for (i = 0; i < 4; i++) {
+        if (sim->output_format == SPS30_FORMAT_UINT16) {
+            sps30_simulator_add_uint16(r, (uint16_t)(mc + i));
+        } else {
+            sps30_simulator_add_float(r, (float)(mc + i) + 0.25f);
+        }
+    }
+    for (i = 0; i < 5; i++) {
+        if (sim->output_format == SPS30_FORMAT_UINT16) {
+            sps30_simulator_add_uint16(r, (uint16_t)(mc * 7 + i));
+        } else {
+            sps30_simulator_add_float(r, (float)(mc * 7 + i) + 0.5f);
+        }
+    }
+    if (sim->output_format == SPS30_FORMAT_UINT16) {
+        sps30_simulator_add_uint16(r, 550);
+    } else {
+        sps30_simulator_add_float(r, 0.55f);
+    }
+}
+
+static uint8_t sps30_simulator_execute(struct sps30_simulator* sim,
+                                       uint64_t now_us, uint8_t command,
+                                       const uint8_t* data, uint8_t data_len,
+                                       struct sps30_simulator_response* r) {
+    uint64_t available;
+
+    if (sim->mode == SPS30_SIMULATOR_SLEEPING && command != 0x11) {
+        return SPS30_SIMULATOR_ERR_NOT_ALLOWED;
+    }
+    switch (command) {
+        case 0x00: /* start measurement */
+            if (data_len != 2) {
+                return SPS30_SIMULATOR_ERR_WRONG_DATA_LENGTH;
+            }
+            if (data[0] != 0x01 || (data[1] != SPS30_FORMAT_FLOAT &&
+                                    data[1] != SPS30_FORMAT_UINT16)) {
+                return SPS30_SIMULATOR_ERR_ILLEGAL_PARAMETER;
+            }
+            if (sim->mode != SPS30_SIMULATOR_IDLE) {
+                return SPS30_SIMULATOR_ERR_NOT_ALLOWED;
+            }
+            sim->mode = SPS30_SIMULATOR_MEASURING;
+            sim->output_format = data[1];
+            sim->measurement_start_us = now_us;
+            sim->samples_read = 0;
+            return 0;
+        case 0x01: /* stop measurement */
+            sim->mode = SPS30_SIMULATOR_IDLE;
+            return 0;
+        case 0x03: /* read measured values */
+            if (sim->mode != SPS30_SIMULATOR_MEASURING) {
+                return SPS30_SIMULATOR_ERR_NOT_ALLOWED;
+            }
+            available = sim->measurement_interval_us == 0
+                            ? sim->samples_read + 1
+                            : (now_us - sim->measurement_start_us) /
+                                  sim->measurement_interval_us;
+            if (available > sim->samples_read) {
+                sim->samples_read = available;
+                sps30_simulator_measurement(sim, r);
+            }
+            return 0;
+        case 0x10: /* sleep */
+            if (sim->mode != SPS30_SIMULATOR_IDLE) {
+                return SPS30_SIMULATOR_ERR_NOT_ALLOWED;
+            }
+            sim->mode = SPS30_SIMULATOR_SLEEPING;
+            sim->interface_awake = false;
+            return 0;
+        case 0x11: /* wake-up */
+            if (sim->mode != SPS30_SIMULATOR_SLEEPING) {
+                return SPS30_SIMULATOR_ERR_NOT_ALLOWED;
+            }
+            sim->mode = SPS30_SIMULATOR_IDLE;
+            return 0;
+        case 0x56: /* start fan cleaning */
+            if (sim->mode != SPS30_SIMULATOR_MEASURING) {
+                return SPS30_SIMULATOR_ERR_NOT_ALLOWED;
+            }
+            return 0;
+        case 0x80: /* read/write auto cleaning interval */
+            if (data_len < 1 || data[0] != 0x00) {
+                return SPS30_SIMULATOR_ERR_ILLEGAL_PARAMETER;
+            }
+            if (data_len == 1) {
+                sensirion_common_uint32_t_to_bytes(
+                    sim->auto_cleaning_interval_s, r->data);
+                r->data_len = 4;
+                return 0;
+            }
+            if (data_len != 5) {
+                return SPS30_SIMULATOR_ERR_WRONG_DATA_LENGTH;
+            }
+            sim->auto_cleaning_interval_s =
+                sensirion_common_bytes_to_uint32_t(&data[1]);
+            return 0;
+        case 0xd0: /* device information */
+            if (data_len != 1) {
+                return SPS30_SIMULATOR_ERR_WRONG_DATA_LENGTH;
+            }
+            if (data[0] == 0x00) {
+                sensirion_common_copy_bytes((const uint8_t*)"00080000",
+                                            r->data, 9);
+                r->data_len = 9;
+                return 0;
+            }
+            if (data[0] == 0x03) {
+                sensirion_common_copy_bytes((const uint8_t*)sim->serial_number,
+                                            r->data,
+                                            sizeof(sim->serial_number));
+                r->data_len = sizeof(sim->serial_number);
+                return 0;
+            }
+            return SPS30_SIMULATOR_ERR_ILLEGAL_PARAMETER;
+        case 0xd1: /* read version */
+            r->data[0] = sim->firmware_major;
+            r->data[1] = sim->firmware_minor;
+            r->data[2] = 0;
+            r->data[3] = 7;
+            r->data[4] = 0;
+            r->data[5] = 2;
+            r->data[6] = 0;
+            r->data_len = 7;
+            return 0;
+        case 0xd2: /* read device status register */
+            if (data_len != 1) {
+                return SPS30_SIMULATOR_ERR_WRONG_DATA_LENGTH;
+            }
+            sensirion_common_uint32_t_to_bytes(sim->status_register, r->data);
+            r->data[4] = 0;
+            r->data_len = 5;
+            if (data[0]) {
+                sim->status_register = 0;
+            }
+            return 0;
+        case 0xd3: /* device reset */
+            sim->mode = SPS30_SIMULATOR_IDLE;
+            return 0;
+        default:
+            return SPS30_SIMULATOR_ERR_UNKNOWN_COMMAND;
+    }
+}
+
+static uint16_t sps30_simulator_stuff(uint8_t byte, uint8_t* out) {
+    switch (byte) {
+        case 0x11:
+        case 0x13:
+        case SHDLC_STUFF_BYTE:
+        case SHDLC_FRAME_DELIMITER:
+            out[0] = SHDLC_STUFF_BYTE;
+            out[1] = byte ^ (1 << 5);
+            return 2;
+        default:
+            out[0] = byte;
+            return 1;
+    }
+}
+
+static uint16_t sps30_simulator_encode(uint8_t command,
+                                       const struct sps30_simulator_response* r,
+                                       uint8_t* out) {
+    uint8_t header[] = {SPS30_ADDR, command, r->state, r->data_len};
+    uint8_t checksum = 0;
+    uint16_t len = 0;
+    uint16_t i;
+
+    out[len++] = SHDLC_FRAME_DELIMITER;
+    for (i = 0; i < sizeof(header); i++) {
+        checksum = (uint8_t)(checksum + header[i]);
+        len += sps30_simulator_stuff(header[i], &out[len]);
+    }
+    for (i = 0; i < r->data_len; i++) {
+        checksum = (uint8_t)(checksum + r->data[i]);
+        len += sps30_simulator_stuff(r->data[i], &out[len]);
+    }
+    len += sps30_simulator_stuff((uint8_t)~checksum, &out[len]);
+    out[len++] = SHDLC_FRAME_DELIMITER;
+    return len;
+}
+
+/* decode a complete request, returns the response length */
+static uint16_t sps30_simulator_process(struct sps30_simulator* sim,
+                                        uint64_t now_us, uint8_t* out) {
+    struct sps30_simulator_response r;
+    uint8_t checksum = 0;
+    uint16_t i;
+
+    /* address, command, length and checksum */
+    if (sim->frame_len < 4 || sim->frame[2] != sim->frame_len - 4) {
+        return 0;
+    }
+    for (i = 0; i < sim->frame_len; i++) {
+        checksum = (uint8_t)(checksum + sim->frame[i]);
+    }
+    /* the sensor ignores corrupted frames and the wake-up pulse */
+    if (checksum != 0xFF || sim->frame[0] != SPS30_ADDR ||
+        sim->frame[1] == SPS30_WAKE_UP_BYTE) {
+        return 0;
+    }
+    sim->requests++;
+    r.data_len = 0;
+    r.state = sps30_simulator_execute(sim, now_us, sim->frame[1],
+                                      &sim->frame[3], sim->frame[2], &r);
+    if (r.state != 0) {
+        r.state |= 0x80;
+        r.data_len = 0;
+    }
+    return sps30_simulator_encode(sim->frame[1], &r, out);
+}
+
+uint16_t sps30_simulator_receive(struct sps30_simulator* sim, uint64_t now_us,
+                                 const uint8_t* data, uint16_t data_len,
+                                 uint8_t* response, uint16_t max_response_len) {
+    uint8_t encoded[SPS30_SIMULATOR_MAX_FRAME_SIZE];
+    uint16_t response_len = 0;
+    uint16_t encoded_len;
+    uint16_t i;
+
+    for (i = 0; i < data_len; i++) {
+        uint8_t byte = data[i];
+
+        if (sim->mode == SPS30_SIMULATOR_SLEEPING && !sim->interface_awake) {
+            /* the UART is off, only the wake-up pulse gets through */
+            sim->interface_awake = byte == SPS30_WAKE_UP_BYTE;
+            sim->in_frame = false;
+            continue;
+        }
+        if (byte == SHDLC_FRAME_DELIMITER) {
+            if (sim->in_frame && sim->frame_len > 0) {
+                sim->in_frame = false;
+                encoded_len = sps30_simulator_process(sim, now_us, encoded);
+                if (encoded_len > 0 &&
+                    encoded_len <= max_response_len - response_len) {
+                    sensirion_common_copy_bytes(
+                        encoded, &response[response_len], encoded_len);
+                    response_len = (uint16_t)(response_len + encoded_len);
+                }
+            } else {
+                sim->in_frame = true;
+                sim->unstuff_next = false;
+                sim->frame_len = 0;
+            }
+            continue;
+        }
+        if (!sim->in_frame) {
+            continue;
+        }
+        if (byte == SHDLC_STUFF_BYTE) {
+            sim->unstuff_next = true;
+            continue;
+        }
+        if (sim->unstuff_next) {
+            byte ^= 1 << 5;
+            sim->unstuff_next = false;
+        }
+        if (sim->frame_len == sizeof(sim->frame)) {
+            sim->in_frame = false;
+            continue;
+        }
+        sim->frame[sim->frame_len++] = byte;
+    }
+    return response_len;
+}
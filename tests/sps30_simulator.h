@@ -0,0 +1,93 @@
+#ifndef SPS30_SIMULATOR_H
+#define SPS30_SIMULATOR_H
+
+/**
+ * Transport independent model of an SPS30 speaking SHDLC. Bytes written by
+ * the driver are passed to sps30_simulator_receive(), which decodes the
+ * requests and returns the encoded responses. The transport decides when the
+ * response is delivered, see response_delay_us.
+ *
+ * The model covers the commands of sps30_uart.h, the operating modes idle,
+ * measuring and sleep and the state byte errors of the sensor. New
+ * measurement values become available every measurement_interval_us after
+ * the measurement was started.
+ */
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** start/stop + (5 header + 255 data) * 2 because of byte stuffing */
+#define SPS30_SIMULATOR_MAX_FRAME_SIZE (2 + (5 + 255) * 2)
+
+#define SPS30_SIMULATOR_MEASUREMENT_INTERVAL_US 1000000
+
+/* state byte of the response, the MSB flags a device error */
+#define SPS30_SIMULATOR_ERR_WRONG_DATA_LENGTH 0x01
+#define SPS30_SIMULATOR_ERR_UNKNOWN_COMMAND 0x02
+#define SPS30_SIMULATOR_ERR_ILLEGAL_PARAMETER 0x04
+#define SPS30_SIMULATOR_ERR_NOT_ALLOWED 0x43
+
+typedef enum {
+    SPS30_SIMULATOR_IDLE = 0,
+    SPS30_SIMULATOR_MEASURING,
+    SPS30_SIMULATOR_SLEEPING,
+} sps30_simulator_mode;
+
+struct sps30_simulator {
+    sps30_simulator_mode mode;
+    bool interface_awake;  //< sleeping, but woken up by a 0xff byte
+    uint8_t output_format;  //< 0x03 float, 0x05 uint16
+    uint8_t firmware_major;
+    uint8_t firmware_minor;
+    uint32_t auto_cleaning_interval_s;
+    uint32_t status_register;
+    char serial_number[32];
+    uint16_t concentration_offset;  //< added to the mass concentrations
+
+    uint32_t measurement_interval_us;  //< 0 for new values on every read
+    uint32_t response_delay_us;  //< emulated processing time per request
+    uint64_t measurement_start_us;
+    uint64_t samples_read;
+    uint32_t requests;  //< number of decoded requests
+
+    /* receive state of the SHDLC decoder */
+    bool in_frame;
+    bool unstuff_next;
+    uint16_t frame_len;
+    uint8_t frame[5 + 255];
+};
+
+/**
+ * Reset the simulator to a freshly powered sensor in idle mode.
+ *
+ * @param sim Simulator
+ * @param id  Number encoded into the serial number
+ */
+void sps30_simulator_init(struct sps30_simulator* sim, uint32_t id);
+
+/**
+ * Pass bytes written by the driver to the simulator.
+ *
+ * @param sim              Simulator
+ * @param now_us           Monotonic time the bytes were received
+ * @param data             Received bytes
+ * @param data_len         Number of received bytes
+ * @param response         Memory where the responses to all completed requests
+ *                         are stored
+ * @param max_response_len Capacity of response, responses which do not fit
+ *                         are dropped
+ *
+ * @return Number of response bytes stored
+ */
+uint16_t sps30_simulator_receive(struct sps30_simulator* sim, uint64_t now_us,
+                                 const uint8_t* data, uint16_t data_len,
+                                 uint8_t* response, uint16_t max_response_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_SIMULATOR_H */
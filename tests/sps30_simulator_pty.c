@@ -0,0 +1,147 @@
+/* Enable posix_openpt, ptsname_r, ppoll and cfmakeraw */
+#define _GNU_SOURCE
+
+#include "sps30_simulator_pty.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* upper bound of a ppoll() so a stop request is noticed */
+#define SPS30_SIMULATOR_PTY_MAX_WAIT_US 10000
+
+uint64_t sps30_simulator_pty_now_us(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+int sps30_simulator_pty_open(struct sps30_simulator_pty* pty, uint32_t id) {
+    struct termios options;
+
+    pty->slave_fd = -1;
+    pty->master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty->master_fd == -1) {
+        return -1;
+    }
+    if (grantpt(pty->master_fd) != 0 || unlockpt(pty->master_fd) != 0 ||
+        ptsname_r(pty->master_fd, pty->slave_path, sizeof(pty->slave_path)) !=
+            0) {
+        sps30_simulator_pty_close(pty);
+        return -1;
+    }
+    pty->slave_fd = open(pty->slave_path, O_RDWR | O_NOCTTY);
+    if (pty->slave_fd == -1 || tcgetattr(pty->slave_fd, &options) != 0) {
+        sps30_simulator_pty_close(pty);
+        return -1;
+    }
+    cfmakeraw(&options);
+    tcsetattr(pty->slave_fd, TCSANOW, &options);
+
+    sps30_simulator_init(&pty->sim, id);
+    pty->pending_len = 0;
+    pty->last_response_delay_us = 0;
+    return 0;
+}
+
+void sps30_simulator_pty_close(struct sps30_simulator_pty* pty) {
+    if (pty->slave_fd != -1) {
+        close(pty->slave_fd);
+        pty->slave_fd = -1;
+    }
+    if (pty->master_fd != -1) {
+        close(pty->master_fd);
+        pty->master_fd = -1;
+    }
+}
+
+static void sps30_simulator_pty_respond(struct sps30_simulator_pty* pty) {
+    uint16_t written = 0;
+    ssize_t ret;
+
+    /* published before the write so the driver never sees a stale value */
+    pty->last_response_delay_us =
+        sps30_simulator_pty_now_us() - pty->request_us;
+    while (written < pty->pending_len) {
+        ret = write(pty->master_fd, &pty->pending[written],
+                    pty->pending_len - written);
+        if (ret <= 0) {
+            break;
+        }
+        written = (uint16_t)(written + ret);
+    }
+    pty->pending_len = 0;
+}
+
+static void sps30_simulator_pty_read(struct sps30_simulator_pty* pty,
+                                     uint64_t now_us) {
+    uint8_t buffer[SPS30_SIMULATOR_MAX_FRAME_SIZE];
+    uint16_t response_len;
+    ssize_t ret;
+
+    ret = read(pty->master_fd, buffer, sizeof(buffer));
+    if (ret <= 0) {
+        return;
+    }
+    response_len = sps30_simulator_receive(
+        &pty->sim, now_us, buffer, (uint16_t)ret,
+        &pty->pending[pty->pending_len],
+        (uint16_t)(sizeof(pty->pending) - pty->pending_len));
+    if (response_len > 0 && pty->pending_len == 0) {
+        pty->request_us = now_us;
+        pty->due_us = now_us + pty->sim.response_delay_us;
+    }
+    pty->pending_len = (uint16_t)(pty->pending_len + response_len);
+}
+
+int sps30_simulator_pty_serve(struct sps30_simulator_pty* ptys, size_t count,
+                              volatile bool* stop) {
+    struct pollfd* fds = calloc(count, sizeof(*fds));
+    struct timespec timeout;
+    uint64_t wait_us;
+    uint64_t now_us;
+    size_t i;
+
+    if (fds == NULL) {
+        return -1;
+    }
+    for (i = 0; i < count; i++) {
+        fds[i].fd = ptys[i].master_fd;
+        fds[i].events = POLLIN;
+    }
+    while (!*stop) {
+        now_us = sps30_simulator_pty_now_us();
+        wait_us = SPS30_SIMULATOR_PTY_MAX_WAIT_US;
+        for (i = 0; i < count; i++) {
+            if (ptys[i].pending_len == 0) {
+                continue;
+            }
+            if (ptys[i].due_us <= now_us) {
+                sps30_simulator_pty_respond(&ptys[i]);
+            } else if (ptys[i].due_us - now_us < wait_us) {
+                wait_us = ptys[i].due_us - now_us;
+            }
+        }
+        timeout.tv_sec = 0;
+        timeout.tv_nsec = (long)(wait_us * 1000);
+        if (ppoll(fds, count, &timeout, NULL) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            free(fds);
+            return -1;
+        }
+        now_us = sps30_simulator_pty_now_us();
+        for (i = 0; i < count; i++) {
+            if (fds[i].revents & POLLIN) {
+                sps30_simulator_pty_read(&ptys[i], now_us);
+            }
+        }
+    }
+    free(fds);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#ifndef SPS30_SIMULATOR_PTY_H
+#define SPS30_SIMULATOR_PTY_H
+
+/**
+ * Serves SPS30 simulators on pseudo-terminals. The driver opens the slave
+ * side with the Linux UART HAL like a real serial port, one thread serves the
+ * master sides of any number of simulators.
+ */
+
+#include "sps30_simulator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sps30_simulator_pty {
+    int master_fd;
+    int slave_fd;  //< kept open so the master never sees a hang-up
+    char slave_path[64];  //< device to pass to sensirion_uart_hal_init()
+    struct sps30_simulator sim;
+
+    /* response scheduled after the emulated processing time */
+    uint64_t request_us;
+    uint64_t due_us;
+    uint16_t pending_len;
+    uint8_t pending[SPS30_SIMULATOR_MAX_FRAME_SIZE];
+
+    /** time from the end of the last request until its response is written */
+    volatile uint64_t last_response_delay_us;
+};
+
+/**
+ * Create a pseudo-terminal and initialize its simulator.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int sps30_simulator_pty_open(struct sps30_simulator_pty* pty, uint32_t id);
+
+/**
+ * Close both sides of the pseudo-terminal.
+ */
+void sps30_simulator_pty_close(struct sps30_simulator_pty* pty);
+
+/**
+ * Serve the simulators until *stop is set. Meant to run on its own thread.
+ *
+ * @return 0 when stopped, -1 on failure
+ */
+int sps30_simulator_pty_serve(struct sps30_simulator_pty* ptys, size_t count,
+                              volatile bool* stop);
+
+/**
+ * Monotonic time in microseconds, the time base of the simulators.
+ */
+uint64_t sps30_simulator_pty_now_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_SIMULATOR_PTY_H */
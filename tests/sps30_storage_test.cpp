@@ -0,0 +1,218 @@
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_test_setup.h"
+#include "sps30_identity.h"
+#include "sps30_log.h"
+#include "sps30_ring.h"
+#include "sps30_sample.h"
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+/*
+ * The sample ring and the binary log codec, which run on memory alone and
+ * need neither a UART HAL nor a simulated sensor.
+ */
+
+/* slowly changing values one second apart, like a sensor measuring */
+static void float_sample(struct sps30_sample* sample, uint16_t i) {
+    float mc = (float)(10 + i % 7);
+
+    sample->mc_1p0 = mc + 0.25f;
+    sample->mc_2p5 = mc + 1.25f;
+    sample->mc_4p0 = mc + 2.25f;
+    sample->mc_10p0 = mc + 3.25f;
+    sample->nc_0p5 = mc * 7 + 0.5f;
+    sample->nc_1p0 = mc * 7 + 1.5f;
+    sample->nc_2p5 = mc * 7 + 2.5f;
+    sample->nc_4p0 = mc * 7 + 3.5f;
+    sample->nc_10p0 = mc * 7 + 4.5f;
+    sample->typical_particle_size = 0.55f;
+    sample->timestamp_us = 1000000 * (uint64_t)(i + 1) + 5000;
+}
+
+TEST_GROUP (SPS30_Storage_Tests) {};
+
+TEST (SPS30_Storage_Tests, test_ring_drains_in_batches) {
+    struct sps30_ring_record storage[8];
+    struct sps30_ring_record batch[16];
+    struct sps30_ring_record record;
+    struct sps30_ring ring;
+    const uint64_t expected[8] = {3, 4, 5, 6, 7, 9, 10, 11};
+    int16_t local_error = 0;
+    uint32_t drained;
+    uint32_t i;
+    /* producer and consumer each own a cache line */
+    CHECK_EQUAL(0, (uintptr_t)&ring % SENSIRION_CACHE_LINE_SIZE);
+    CHECK_EQUAL(0, (uintptr_t)&ring.tail % SENSIRION_CACHE_LINE_SIZE);
+    /* the capacity must be a power of two */
+    local_error = sps30_ring_init(&ring, storage, 6);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT, local_error);
+    local_error = sps30_ring_init(&ring, storage, 8);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "ring_init");
+    record.port = 0;
+    for (i = 0; i < 9; i++) {
+        record.sample.timestamp_us = i;
+        CHECK_EQUAL(i < 8, sps30_ring_push(&ring, &record));
+    }
+    CHECK_EQUAL(1, sps30_ring_get_dropped(&ring));
+    CHECK_EQUAL(3, sps30_ring_drain(&ring, batch, 3));
+    CHECK_EQUAL(2, batch[2].sample.timestamp_us);
+    /* the next records wrap around */
+    for (i = 9; i < 12; i++) {
+        record.sample.timestamp_us = i;
+        CHECK(sps30_ring_push(&ring, &record));
+    }
+    CHECK_EQUAL(8, sps30_ring_get_count(&ring));
+    drained = sps30_ring_drain(&ring, batch, 16);
+    CHECK_EQUAL(8, drained);
+    for (i = 0; i < drained; i++) {
+        CHECK_EQUAL(expected[i], batch[i].sample.timestamp_us);
+    }
+    CHECK_EQUAL(0, sps30_ring_drain(&ring, batch, 16));
+}
+
+#define RING_STRESS_RECORDS 100000
+
+struct ring_stress {
+    struct sps30_ring ring;
+    struct sps30_ring_record storage[64];
+    uint32_t received;
+    uint32_t out_of_order;
+};
+
+static void* ring_stress_consumer(void* arg) {
+    struct ring_stress* stress = (struct ring_stress*)arg;
+    struct sps30_ring_record batch[16];
+    uint32_t drained;
+    uint32_t i;
+
+    while (stress->received < RING_STRESS_RECORDS) {
+        drained = sps30_ring_drain(&stress->ring, batch, 16);
+        if (drained == 0) {
+            sched_yield();
+        }
+        for (i = 0; i < drained; i++) {
+            if (batch[i].sample.timestamp_us != stress->received) {
+                stress->out_of_order++;
+            }
+            stress->received++;
+        }
+    }
+    return NULL;
+}
+
+TEST (SPS30_Storage_Tests, test_ring_passes_records_between_threads) {
+    static struct ring_stress stress;
+    struct sps30_ring_record record;
+    pthread_t consumer;
+    uint32_t i;
+    sps30_ring_init(&stress.ring, stress.storage, 64);
+    stress.received = 0;
+    stress.out_of_order = 0;
+    CHECK_EQUAL(0, pthread_create(&consumer, NULL, ring_stress_consumer,
+                                  &stress));
+    record.port = 0;
+    for (i = 0; i < RING_STRESS_RECORDS; i++) {
+        record.sample.timestamp_us = i;
+        /* a test producer waits for the consumer instead of dropping */
+        while (!sps30_ring_push(&stress.ring, &record)) {
+            sched_yield();
+        }
+    }
+    CHECK_EQUAL(0, pthread_join(consumer, NULL));
+    CHECK_EQUAL(RING_STRESS_RECORDS, stress.received);
+    CHECK_EQUAL(0, stress.out_of_order);
+}
+
+TEST (SPS30_Storage_Tests, test_log_compresses_float_samples) {
+    static uint8_t log[sizeof(struct sps30_log_header) +
+                      60 * SPS30_LOG_MAX_RECORD_SIZE];
+    struct sps30_sample samples[60];
+    struct sps30_identity identity = {{0}};
+    struct sps30_log_header header;
+    struct sps30_log_reader reader;
+    struct sps30_log_record record;
+    struct sps30_log_codec codec;
+    struct sps30_sample sample;
+    int16_t local_error = 0;
+    size_t size = sizeof(header);
+    uint16_t i;
+    strcpy((char*)identity.serial_number, "F5D3A2B1C0E49870");
+    sps30_log_header_init(&header, SPS30_LOG_FORMAT_FLOAT, &identity);
+    memcpy(log, &header, sizeof(header));
+    sps30_log_codec_init(&codec, SPS30_LOG_FORMAT_FLOAT);
+    for (i = 0; i < 60; i++) {
+        float_sample(&samples[i], i);
+        sps30_log_record_from_sample(&record, &samples[i]);
+        size += sps30_log_encode(&codec, &record, &log[size]);
+    }
+    /* a sample takes 48 bytes in memory */
+    CHECK((size - sizeof(header)) / 60 <= 24);
+    local_error = sps30_log_reader_init(&reader, log, size);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "log_reader_init");
+    STRCMP_EQUAL((const char*)identity.serial_number,
+                 (const char*)reader.header.serial_number);
+    for (i = 0; i < 60; i++) {
+        local_error = sps30_log_reader_next(&reader, &record);
+        CHECK_EQUAL_ZERO_TEXT(local_error, "log_reader_next");
+        sps30_log_record_to_sample(&record, &sample);
+        CHECK(memcmp(&samples[i], &sample, sizeof(sample)) == 0);
+    }
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA,
+                sps30_log_reader_next(&reader, &record));
+    CHECK_EQUAL(size, reader.offset);
+}
+
+TEST (SPS30_Storage_Tests, test_log_ends_at_damaged_record) {
+    static uint8_t log[sizeof(struct sps30_log_header) +
+                      4 * SPS30_LOG_MAX_RECORD_SIZE];
+    struct sps30_identity identity = {{0}};
+    struct sps30_log_header header;
+    struct sps30_log_reader reader;
+    struct sps30_log_record record;
+    struct sps30_log_codec codec;
+    size_t ends[4];
+    size_t size = sizeof(header);
+    uint16_t i;
+    uint16_t j;
+    sps30_log_header_init(&header, SPS30_LOG_FORMAT_UINT16, &identity);
+    memcpy(log, &header, sizeof(header));
+    sps30_log_codec_init(&codec, SPS30_LOG_FORMAT_UINT16);
+    for (i = 0; i < 4; i++) {
+        /* values going up and down, a clock going backwards once */
+        record.timestamp_us = i == 2 ? 500000 : 1000000 * (uint64_t)(i + 1);
+        for (j = 0; j < SPS30_LOG_FIELD_COUNT; j++) {
+            record.fields[j] = (uint32_t)(i % 2 == 0 ? 65535 - j : j);
+        }
+        size += sps30_log_encode(&codec, &record, &log[size]);
+        ends[i] = size;
+    }
+    /* the stored values are the ones encoded */
+    sps30_log_reader_init(&reader, log, size);
+    for (i = 0; i < 4; i++) {
+        CHECK_EQUAL(NO_ERROR, sps30_log_reader_next(&reader, &record));
+    }
+    CHECK_EQUAL(3, record.fields[3]);
+    CHECK_EQUAL(4000000, record.timestamp_us);
+    /* a bit flipped in the third record */
+    log[ends[2] - 2] ^= 0x10;
+    sps30_log_reader_init(&reader, log, size);
+    CHECK_EQUAL(NO_ERROR, sps30_log_reader_next(&reader, &record));
+    CHECK_EQUAL(NO_ERROR, sps30_log_reader_next(&reader, &record));
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA,
+                sps30_log_reader_next(&reader, &record));
+    CHECK_EQUAL(ends[1], reader.offset);
+    /* space a crash left zeroed */
+    memset(&log[ends[1]], 0, size - ends[1]);
+    sps30_log_reader_init(&reader, log, size);
+    sps30_log_reader_next(&reader, &record);
+    sps30_log_reader_next(&reader, &record);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA,
+                sps30_log_reader_next(&reader, &record));
+    /* a log of another format version is rejected */
+    header.version = SPS30_LOG_VERSION + 1;
+    memcpy(log, &header, sizeof(header));
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA,
+                sps30_log_reader_init(&reader, log, size));
+}
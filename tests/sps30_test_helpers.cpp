@@ -0,0 +1,20 @@
+#include "sps30_test_helpers.h"
+#include "sps30_simulator.h"
+#include "sps30_uart.h"
+
+const struct sensirion_shdlc_retry_policy single_attempt = {1, 0, 0};
+
+uint16_t simulated_sps30(void* user_data, uint64_t now_us, const uint8_t* data,
+                         uint16_t data_len, uint8_t* response,
+                         uint16_t max_response_len) {
+    return sps30_simulator_receive((struct sps30_simulator*)user_data, now_us,
+                                   data, data_len, response, max_response_len);
+}
+
+int16_t read_version() {
+    uint8_t major, minor, reserved1, hardware, reserved2, shdlc_major,
+        shdlc_minor;
+
+    return sps30_read_version(&major, &minor, &reserved1, &hardware,
+                              &reserved2, &shdlc_major, &shdlc_minor);
+}
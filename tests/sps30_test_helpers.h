@@ -0,0 +1,23 @@
+#ifndef SPS30_TEST_HELPERS_H
+#define SPS30_TEST_HELPERS_H
+
+#include "sensirion_config.h"
+#include "sensirion_shdlc_retry.h"
+
+/*
+ * Glue between the virtual-time UART HAL and the SPS30 simulator, shared by
+ * the tests which talk to a simulated sensor.
+ */
+
+/* every transaction is observed once */
+extern const struct sensirion_shdlc_retry_policy single_attempt;
+
+/* device callback of the virtual HAL, user_data is a struct sps30_simulator */
+uint16_t simulated_sps30(void* user_data, uint64_t now_us, const uint8_t* data,
+                         uint16_t data_len, uint8_t* response,
+                         uint16_t max_response_len);
+
+/* read the version of the sensor on the selected port, dropping the values */
+int16_t read_version();
+
+#endif /* SPS30_TEST_HELPERS_H */
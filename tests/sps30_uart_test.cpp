@@ -56,6 +56,8 @@ TEST (SPS30_Tests, test_start_measurement1) {
     uint8_t reserved = 0;
     local_error = sps30_start_measurement((sps30_output_format)(261));
     CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    /* the first values are available one second after the start */
+    sensirion_hal_sleep_us(1000000);
     local_error = sps30_read_measurement_values_uint16(
         &mc_1p0, &mc_2p5, &mc_4p0, &mc_10p0, &nc_0p5, &nc_1p0, &nc_2p5, &nc_4p0,
         &nc_10p0, &typical_particle_size);
@@ -0,0 +1,1132 @@
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_shdlc_retry.h"
+#include "sensirion_shdlc_timeout.h"
+#include "sensirion_test_setup.h"
+#include "sensirion_uart_hal.h"
+#include "sensirion_uart_hal_virtual.h"
+#include "sps30_cleaning.h"
+#include "sps30_config.h"
+#include "sps30_discovery.h"
+#include "sps30_duty_cycle.h"
+#include "sps30_fast_start.h"
+#include "sps30_health.h"
+#include "sps30_hooks.h"
+#include "sps30_identity.h"
+#include "sps30_latest.h"
+#include "sps30_ring.h"
+#include "sps30_simulator.h"
+#include "sps30_test_helpers.h"
+#include "sps30_uart.h"
+
+#define SPS30_RESPONSE_DELAY_US 5000
+#define SPS30_RESPONSE_TIMEOUT_US 50000
+
+static struct sps30_simulator simulator;
+
+static const struct sensirion_shdlc_retry_policy three_attempts = {3, 5, 250};
+
+typedef enum {
+    SENSOR_WORKING = 0,
+    SENSOR_HUNG,  //< ignores every command up to a reset
+    SENSOR_DEAD,  //< ignores every command
+} sensor_condition;
+
+static sensor_condition condition;
+static uint8_t last_bytes[2];
+
+static uint16_t faulty_sps30(void* user_data, uint64_t now_us,
+                             const uint8_t* data, uint16_t data_len,
+                             uint8_t* response, uint16_t max_response_len) {
+    uint16_t i;
+
+    /* a reset frame starts with 0x7e, 0x00, 0xd3 and wakes a hung sensor */
+    for (i = 0; i < data_len; i++) {
+        if (condition == SENSOR_HUNG && last_bytes[0] == 0x7e &&
+            last_bytes[1] == 0x00 && data[i] == 0xd3) {
+            condition = SENSOR_WORKING;
+        }
+        last_bytes[0] = last_bytes[1];
+        last_bytes[1] = data[i];
+    }
+    if (condition != SENSOR_WORKING) {
+        return 0;
+    }
+    return simulated_sps30(user_data, now_us, data, data_len, response,
+                           max_response_len);
+}
+
+/* response to stop measurement, no SPS30 command expects it here */
+static const uint8_t stop_measurement_response[] = {0x7e, 0x00, 0x01, 0x00,
+                                                    0x00, 0xfe, 0x7e};
+
+static int16_t read_serial_number() {
+    int8_t serial_number[32];
+
+    return sps30_read_serial_number(serial_number, sizeof(serial_number));
+}
+
+/* poll the duty cycle like an application sleeping in between */
+static uint32_t run_duty_cycle(uint64_t end_us) {
+    struct sps30_sample sample;
+    uint32_t samples = 0;
+    uint32_t wait_ms;
+    int16_t error;
+
+    while (sensirion_uart_hal_get_time_usec() < end_us) {
+        error = sps30_duty_cycle_poll(&sample);
+        if (error == NO_ERROR) {
+            samples++;
+        } else {
+            CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA, error);
+        }
+        wait_ms = sps30_duty_cycle_get_wait_ms();
+        sensirion_uart_hal_sleep_usec(wait_ms * 1000);
+    }
+    return samples;
+}
+
+/* the samples of one day at 1 Hz on a link with one corrupted byte in 10000 */
+struct noisy_day {
+    uint32_t received;         //< reads which returned a sample
+    uint32_t failures;         //< reads which returned an error
+    uint32_t lost;             //< samples the application did not get
+    uint64_t max_duration_us;  //< longest read
+};
+
+static void acquire_noisy_day(struct noisy_day* day) {
+    uint16_t values[10];
+    uint64_t start_us;
+    uint64_t read_us;
+    int16_t local_error;
+    uint32_t i;
+    day->received = 0;
+    day->failures = 0;
+    day->max_duration_us = 0;
+    sensirion_uart_hal_virtual_set_byte_error_rate(0);
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_UINT16);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    start_us = sensirion_uart_hal_get_time_usec();
+    sensirion_uart_hal_virtual_set_byte_error_rate(100);
+    for (i = 0; i < 24 * 3600; i++) {
+        /* halfway through the interval, every read finds one new sample */
+        read_us = start_us + (uint64_t)i * 1000000 + 1500000;
+        sensirion_uart_hal_sleep_usec(
+            (uint32_t)(read_us - sensirion_uart_hal_get_time_usec()));
+        local_error = sps30_read_measurement_values_uint16(
+            &values[0], &values[1], &values[2], &values[3], &values[4],
+            &values[5], &values[6], &values[7], &values[8], &values[9]);
+        if (local_error == NO_ERROR) {
+            day->received++;
+        } else {
+            day->failures++;
+        }
+        if (sensirion_uart_hal_get_time_usec() - read_us >
+            day->max_duration_us) {
+            day->max_duration_us = sensirion_uart_hal_get_time_usec() - read_us;
+        }
+    }
+    day->lost = 24 * 3600 - day->received;
+}
+
+TEST_GROUP (SPS30_Virtual_Time_Tests) {
+    void setup() {
+        int16_t error;
+        sensirion_uart_hal_virtual_reset();
+        sps30_hooks_install();
+#if SENSIRION_SHDLC_ADAPTIVE_TIMEOUT
+        sensirion_shdlc_timeout_reset(0);
+#endif
+        error = sensirion_shdlc_retry_set_policy(0, &single_attempt);
+        CHECK_EQUAL_ZERO_TEXT(error, "sensirion_shdlc_retry_set_policy");
+        error = sps30_health_set_config(0, NULL);
+        CHECK_EQUAL_ZERO_TEXT(error, "sps30_health_set_config");
+        sps30_health_reset(0);
+        sps30_identity_invalidate(0);
+        sps30_config_invalidate(0);
+        sps30_cleaning_invalidate(0);
+        error = sps30_duty_cycle_set_config(0, NULL);
+        CHECK_EQUAL_ZERO_TEXT(error, "sps30_duty_cycle_set_config");
+        condition = SENSOR_WORKING;
+        error = sensirion_uart_hal_init(SERIAL_0);
+        CHECK_EQUAL_ZERO_TEXT(error, "sensirion_uart_hal_init");
+        sps30_simulator_init(&simulator, 1);
+        sensirion_uart_hal_virtual_set_device(simulated_sps30, &simulator);
+        sensirion_uart_hal_virtual_set_response_delay_usec(
+            SPS30_RESPONSE_DELAY_US);
+    }
+
+    void teardown() {
+        int16_t error;
+        sps30_latest_publish_to(NULL);
+        error = sensirion_uart_hal_free();
+        CHECK_EQUAL_ZERO_TEXT(error, "sensirion_uart_hal_free");
+    }
+};
+
+TEST (SPS30_Virtual_Time_Tests, test_response_arrives_after_delay) {
+    int16_t local_error = 0;
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    CHECK_EQUAL(SPS30_RESPONSE_DELAY_US, sensirion_uart_hal_get_time_usec());
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_missing_response_times_out) {
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_set_device(NULL, NULL);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, local_error);
+    CHECK(sensirion_uart_hal_get_time_usec() >= SPS30_RESPONSE_TIMEOUT_US);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_slow_response_times_out) {
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_set_response_delay_usec(
+        SPS30_RESPONSE_TIMEOUT_US - 1000);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version within timeout");
+    sensirion_uart_hal_virtual_set_response_delay_usec(
+        SPS30_RESPONSE_TIMEOUT_US + 1000);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, local_error);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_dropped_response_recovers) {
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_DROP, 1);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, local_error);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version after drop");
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_truncated_response_recovers) {
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_TRUNCATE, 1);
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_STOP, local_error);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version after truncation");
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_corrupted_response_fails) {
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT, 1);
+    local_error = read_version();
+    CHECK_TEXT(local_error != NO_ERROR, "corrupted response accepted");
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_legacy_xcv_waits_in_virtual_time) {
+    struct sensirion_shdlc_rx_header header;
+    uint8_t version[7];
+    int16_t local_error = 0;
+    local_error = sensirion_shdlc_xcv(SPS30_SHDLC_ADDR, 0xd1, 0, NULL,
+                                      sizeof(version), &header, version);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "xcv read_version");
+    CHECK_EQUAL(2, version[0]);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_legacy_xcv_times_first_byte) {
+    struct sensirion_shdlc_rx_header header;
+    uint8_t version[7];
+    int16_t local_error = 0;
+    /* slower than the fixed delay xcv used to wait before a single read */
+    sensirion_uart_hal_virtual_set_response_delay_usec(30000);
+    local_error = sensirion_shdlc_xcv(SPS30_SHDLC_ADDR, 0xd1, 0, NULL,
+                                      sizeof(version), &header, version);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "xcv read_version");
+    CHECK_EQUAL(header.tx_timestamp_us + 30000, header.rx_timestamp_us);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_late_response_is_drained) {
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_set_response_delay_usec(
+        SPS30_RESPONSE_TIMEOUT_US + 10000);
+    local_error = read_serial_number();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, local_error);
+    /* the late response is waiting when the next request is sent */
+    sensirion_uart_hal_virtual_advance_usec(20000);
+    sensirion_uart_hal_virtual_set_response_delay_usec(SPS30_RESPONSE_DELAY_US);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version after late response");
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_late_response_is_skipped) {
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_set_response_delay_usec(
+        SPS30_RESPONSE_TIMEOUT_US + 2000);
+    local_error = read_serial_number();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, local_error);
+    /* the late response arrives after the next request was sent */
+    sensirion_uart_hal_virtual_set_response_delay_usec(SPS30_RESPONSE_DELAY_US);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version after late response");
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_foreign_response_is_rejected) {
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_set_device(NULL, NULL);
+    sensirion_uart_hal_virtual_schedule_rx(1000, stop_measurement_response,
+                                           sizeof(stop_measurement_response));
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH, local_error);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_legacy_xcv_rejects_foreign_response) {
+    struct sensirion_shdlc_rx_header header;
+    uint8_t version[7];
+    int16_t local_error = 0;
+    sensirion_uart_hal_virtual_set_device(NULL, NULL);
+    sensirion_uart_hal_virtual_schedule_rx(1000, stop_measurement_response,
+                                           sizeof(stop_measurement_response));
+    local_error = sensirion_shdlc_xcv(SPS30_SHDLC_ADDR, 0xd1, 0, NULL,
+                                      sizeof(version), &header, version);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_RESPONSE_MISMATCH, local_error);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_execution_failure_consumes_frame) {
+    int16_t local_error = 0;
+    /* fan cleaning is only allowed while measuring */
+    local_error = sps30_start_fan_cleaning();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_EXECUTION_FAILURE, local_error);
+    sensirion_uart_hal_virtual_set_device(NULL, NULL);
+    /* nothing of the failed response is left to be received */
+    CHECK_EQUAL(0, sensirion_uart_hal_wait_rx_usec(1000000));
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_noisy_link_loses_single_samples) {
+    struct noisy_day day;
+    acquire_noisy_day(&day);
+    /*
+     * Without retries a corrupted byte costs one sample, or two if it hit
+     * the stop byte of a request and the sensor lost the next start byte.
+     */
+    CHECK(day.lost > 0);
+    CHECK(day.lost <= 2 * sensirion_uart_hal_virtual_get_corrupted_bytes());
+    /* every lost sample was reported by its read */
+    CHECK_EQUAL(day.failures, day.lost);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_hours_of_acquisition) {
+    int16_t local_error = 0;
+    uint16_t values[10];
+    uint64_t samples_read = 0;
+    uint32_t samples = 0;
+    uint32_t i;
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_UINT16);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    /* three hours at 1 Hz, as the example usage polls */
+    for (i = 0; i < 3 * 3600; i++) {
+        sensirion_uart_hal_sleep_usec(1000000);
+        local_error = sps30_read_measurement_values_uint16(
+            &values[0], &values[1], &values[2], &values[3], &values[4],
+            &values[5], &values[6], &values[7], &values[8], &values[9]);
+        CHECK_EQUAL_ZERO_TEXT(local_error, "read_measurement_values_uint16");
+        /* an empty response leaves the values unchanged */
+        if (simulator.samples_read > samples_read) {
+            samples_read = simulator.samples_read;
+            samples++;
+        }
+    }
+    CHECK_EQUAL(3 * 3600, samples);
+    CHECK(sensirion_uart_hal_get_time_usec() >= (uint64_t)3 * 3600 * 1000000);
+    local_error = sps30_stop_measurement();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "stop_measurement");
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_retry_recovers_damaged_responses) {
+    int16_t local_error = 0;
+    sensirion_shdlc_retry_set_policy(0, &three_attempts);
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_CORRUPT, 1);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version after corruption");
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_TRUNCATE, 1);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version after truncation");
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_DROP, 1);
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version after drop");
+    CHECK_EQUAL(6, simulator.requests);
+    /* the damaged responses did not leave bytes behind */
+    local_error = read_version();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    CHECK_EQUAL(7, simulator.requests);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_retry_skips_non_idempotent_commands) {
+    int16_t local_error = 0;
+    sensirion_shdlc_retry_set_policy(0, &three_attempts);
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_UINT16);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    sensirion_uart_hal_virtual_inject_fault(
+        SENSIRION_UART_HAL_VIRTUAL_FAULT_DROP, 1);
+    local_error = sps30_start_fan_cleaning();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, local_error);
+    CHECK_EQUAL(2, simulator.requests);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_retry_stays_within_budget) {
+    struct sensirion_shdlc_retry_policy policy = {10, 5, 120};
+    int16_t local_error = 0;
+    uint64_t start_us;
+    sensirion_shdlc_retry_set_policy(0, &policy);
+    sensirion_uart_hal_virtual_set_device(NULL, NULL);
+    start_us = sensirion_uart_hal_get_time_usec();
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, local_error);
+    CHECK(sensirion_uart_hal_get_time_usec() - start_us <=
+          policy.budget_ms * 1000);
+    /* 50 ms, 5 ms backoff, 50 ms, 10 ms backoff, 5 ms left */
+    CHECK(sensirion_uart_hal_get_time_usec() - start_us >= 115000);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_retry_keeps_cadence_on_noisy_link) {
+    struct noisy_day once;
+    struct noisy_day day;
+    acquire_noisy_day(&once);
+    sps30_simulator_init(&simulator, 1);
+    sensirion_shdlc_retry_set_policy(0, &three_attempts);
+    acquire_noisy_day(&day);
+    CHECK_EQUAL(day.failures, day.lost);
+    CHECK(day.max_duration_us <= three_attempts.budget_ms * 1000);
+    /*
+     * Only reads whose request the sensor ignored are repeated. A damaged
+     * response took its sample with it, which no retry recovers, so the
+     * samples are not all read but fewer are lost than without retries.
+     */
+    CHECK(day.lost > 0);
+    CHECK(day.lost < once.lost);
+    /* the sensor handed out every lost sample in a damaged response */
+    CHECK_EQUAL(day.lost, (uint32_t)(simulator.samples_read - day.received));
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_health_ignores_execution_failures) {
+    struct sps30_health_status status;
+    int16_t local_error = 0;
+    uint32_t i;
+    for (i = 0; i < 2 * SPS30_HEALTH_FAILURE_THRESHOLD; i++) {
+        /* fan cleaning is only allowed while measuring */
+        local_error = sps30_start_fan_cleaning();
+        CHECK_EQUAL(SPS30_HEALTH_ONLINE, sps30_health_update(local_error));
+    }
+    sps30_health_get_status(0, &status);
+    CHECK_EQUAL(0, status.failures);
+    CHECK_EQUAL(0, status.recoveries);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_health_wakes_sleeping_sensor) {
+    struct sps30_health_status status;
+    int16_t local_error = 0;
+    uint32_t i;
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    /* a brown-out the driver did not notice */
+    simulator.mode = SPS30_SIMULATOR_SLEEPING;
+    simulator.interface_awake = false;
+    for (i = 1; i < SPS30_HEALTH_FAILURE_THRESHOLD; i++) {
+        CHECK_EQUAL(SPS30_HEALTH_FAILING,
+                    sps30_health_update(read_serial_number()));
+    }
+    CHECK_EQUAL(SPS30_HEALTH_ONLINE,
+                sps30_health_update(read_serial_number()));
+    sps30_health_get_status(0, &status);
+    CHECK_EQUAL(SPS30_HEALTH_STEP_WAKE_UP, status.last_step);
+    CHECK_EQUAL(1, status.recoveries);
+    CHECK_EQUAL(SPS30_SIMULATOR_MEASURING, simulator.mode);
+    CHECK_EQUAL(0x03, simulator.output_format);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_health_resets_hung_sensor) {
+    struct sps30_health_status status;
+    int16_t local_error = 0;
+    uint16_t values[10];
+    uint32_t missed = 0;
+    uint32_t i;
+    sensirion_uart_hal_virtual_set_device(faulty_sps30, &simulator);
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_UINT16);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    for (i = 0; i < 60; i++) {
+        if (i == 10) {
+            condition = SENSOR_HUNG;
+        }
+        sensirion_uart_hal_sleep_usec(1000000);
+        local_error = sps30_read_measurement_values_uint16(
+            &values[0], &values[1], &values[2], &values[3], &values[4],
+            &values[5], &values[6], &values[7], &values[8], &values[9]);
+        if (local_error != NO_ERROR) {
+            missed++;
+        }
+        sps30_health_update(local_error);
+    }
+    /* the gap lasts the failures until the recovery, not minutes */
+    CHECK_EQUAL(SPS30_HEALTH_FAILURE_THRESHOLD, missed);
+    sps30_health_get_status(0, &status);
+    CHECK_EQUAL(SPS30_HEALTH_ONLINE, status.state);
+    CHECK_EQUAL(SPS30_HEALTH_STEP_RESET, status.last_step);
+    CHECK_EQUAL(1, status.recoveries);
+    CHECK_EQUAL(SPS30_SIMULATOR_MEASURING, simulator.mode);
+    CHECK_EQUAL(0x05, simulator.output_format);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_health_probes_offline_sensor) {
+    struct sps30_health_status status;
+    int16_t local_error = 0;
+    uint32_t i;
+    sensirion_uart_hal_virtual_set_device(faulty_sps30, &simulator);
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    condition = SENSOR_DEAD;
+    for (i = 0; i < SPS30_HEALTH_FAILURE_THRESHOLD; i++) {
+        sps30_health_update(read_serial_number());
+    }
+    sps30_health_get_status(0, &status);
+    CHECK_EQUAL(SPS30_HEALTH_OFFLINE, status.state);
+    CHECK_EQUAL(SPS30_HEALTH_STEP_OFFLINE, status.last_step);
+    CHECK_EQUAL(1, status.failed_recoveries);
+    /* the sensor is replaced by one which needs a reset */
+    condition = SENSOR_HUNG;
+    CHECK_EQUAL(SPS30_HEALTH_OFFLINE,
+                sps30_health_update(read_serial_number()));
+    CHECK_EQUAL(SENSOR_HUNG, condition);
+    sensirion_uart_hal_virtual_advance_usec(SPS30_HEALTH_OFFLINE_PROBE_MS *
+                                            1000);
+    CHECK_EQUAL(SPS30_HEALTH_ONLINE,
+                sps30_health_update(read_serial_number()));
+    CHECK_EQUAL(SPS30_SIMULATOR_MEASURING, simulator.mode);
+    CHECK_EQUAL(0x03, simulator.output_format);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_health_forgets_stopped_measurement) {
+    struct sps30_health_status status;
+    int16_t local_error = 0;
+    uint32_t i;
+    sensirion_uart_hal_virtual_set_device(faulty_sps30, &simulator);
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    local_error = sps30_stop_measurement();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "stop_measurement");
+    condition = SENSOR_HUNG;
+    for (i = 0; i < SPS30_HEALTH_FAILURE_THRESHOLD; i++) {
+        sps30_health_update(read_serial_number());
+    }
+    sps30_health_get_status(0, &status);
+    CHECK_EQUAL(SPS30_HEALTH_ONLINE, status.state);
+    CHECK_EQUAL(SPS30_SIMULATOR_IDLE, simulator.mode);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_discovery_waits_one_timeout) {
+    struct sps30_discovery_device devices[SENSIRION_UART_MAX_PORTS];
+    struct sps30_simulator second;
+    UartDescr paths[SENSIRION_UART_MAX_PORTS];
+    uint16_t i;
+    int16_t found;
+    /* sensors on ports 0 and 2, nothing answers on the others */
+    sps30_simulator_init(&second, 2);
+    sensirion_uart_hal_select_port(2);
+    sensirion_uart_hal_virtual_set_device(simulated_sps30, &second);
+    sensirion_uart_hal_virtual_set_response_delay_usec(
+        SPS30_RESPONSE_DELAY_US);
+    sensirion_uart_hal_select_port(0);
+    for (i = 0; i < SENSIRION_UART_MAX_PORTS; i++) {
+        paths[i] = SERIAL_0;
+    }
+    found = sps30_discovery_scan(paths, SENSIRION_UART_MAX_PORTS, 0,
+                                 SPS30_DEVICE_INFORMATION_TIMEOUT_MS, devices,
+                                 SENSIRION_UART_MAX_PORTS);
+    CHECK_EQUAL(2, found);
+    CHECK_EQUAL(0, devices[0].port);
+    CHECK_EQUAL(2, devices[1].port);
+    STRCMP_EQUAL(SPS30_DISCOVERY_PRODUCT_TYPE,
+                 (const char*)devices[0].product_type);
+    CHECK(devices[0].serial_number[0] != 0);
+    CHECK(strcmp((const char*)devices[0].serial_number,
+                 (const char*)devices[1].serial_number) != 0);
+    CHECK_EQUAL(0, sensirion_uart_hal_get_selected_port());
+    /* one timeout for the empty ports and one round trip for the serials */
+    CHECK(sensirion_uart_hal_get_time_usec() <=
+          SPS30_DEVICE_INFORMATION_TIMEOUT_MS * 1000 +
+              2 * SPS30_RESPONSE_DELAY_US);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_discovery_fills_identity) {
+    struct sps30_discovery_device devices[1];
+    struct sps30_identity identity;
+    UartDescr paths[1] = {SERIAL_0};
+    int16_t local_error = 0;
+    uint32_t requests;
+    int16_t found;
+    found = sps30_discovery_scan(paths, 1, 0,
+                                 SPS30_DEVICE_INFORMATION_TIMEOUT_MS, devices,
+                                 1);
+    CHECK_EQUAL(1, found);
+    /* the version is still missing */
+    local_error = sps30_identity_get(0, &identity);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA, local_error);
+    requests = simulator.requests;
+    local_error = sps30_identity_read(&identity);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "identity_read");
+    CHECK_EQUAL(requests + 1, simulator.requests);
+    STRCMP_EQUAL((const char*)devices[0].product_type,
+                 (const char*)identity.product_type);
+    STRCMP_EQUAL((const char*)devices[0].serial_number,
+                 (const char*)identity.serial_number);
+    CHECK_EQUAL(2, identity.firmware_major);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_identity_is_read_once) {
+    struct sps30_identity identity;
+    int16_t local_error = 0;
+    uint32_t requests;
+    local_error = sps30_identity_get(0, &identity);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA, local_error);
+    local_error = sps30_identity_read(&identity);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "identity_read");
+    requests = simulator.requests;
+    local_error = sps30_identity_read(&identity);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "identity_read from cache");
+    CHECK_EQUAL(requests, simulator.requests);
+    STRCMP_EQUAL("00080000", (const char*)identity.product_type);
+    STRCMP_EQUAL(simulator.serial_number,
+                 (const char*)identity.serial_number);
+    CHECK_EQUAL(2, identity.firmware_major);
+    CHECK_EQUAL(3, identity.firmware_minor);
+    CHECK_EQUAL(SPS30_CAPABILITY_SLEEP | SPS30_CAPABILITY_UINT16_OUTPUT |
+                    SPS30_CAPABILITY_STATUS_REGISTER,
+                identity.capabilities);
+    local_error = sps30_identity_get(0, &identity);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "identity_get");
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_identity_gates_old_firmware) {
+    struct sps30_identity identity;
+    int16_t local_error = 0;
+    uint32_t status_register;
+    uint32_t requests;
+    uint64_t start_us;
+    uint8_t reserved;
+    simulator.firmware_major = 1;
+    simulator.firmware_minor = 0;
+    local_error = sps30_identity_read(&identity);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "identity_read");
+    CHECK_EQUAL(0, identity.capabilities);
+    requests = simulator.requests;
+    start_us = sensirion_uart_hal_get_time_usec();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NOT_SUPPORTED, sps30_sleep());
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NOT_SUPPORTED, sps30_wake_up());
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NOT_SUPPORTED,
+                sps30_read_device_status_register(false, &status_register,
+                                                  &reserved));
+    CHECK_EQUAL(
+        SENSIRION_SHDLC_ERR_NOT_SUPPORTED,
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_UINT16));
+    /* nothing was sent and no time passed */
+    CHECK_EQUAL(requests, simulator.requests);
+    CHECK_EQUAL(start_us, sensirion_uart_hal_get_time_usec());
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement float");
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_config_reconcile_skips_unchanged) {
+    struct sps30_config desired = {604800};
+    struct sps30_config_result result;
+    int16_t local_error = 0;
+    uint32_t requests;
+    local_error = sps30_config_reconcile(&desired, &result);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "config_reconcile");
+    CHECK_EQUAL(SPS30_CONFIG_UNCHANGED, result.outcome);
+    CHECK_EQUAL(1, simulator.requests);
+    /* the cached configuration matches, nothing is sent */
+    requests = simulator.requests;
+    local_error = sps30_config_reconcile(&desired, &result);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "config_reconcile from cache");
+    CHECK_EQUAL(SPS30_CONFIG_UNCHANGED, result.outcome);
+    CHECK_EQUAL(requests, simulator.requests);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_config_reconcile_writes_mismatch) {
+    struct sps30_config desired = {3600};
+    struct sps30_config_result result;
+    int16_t local_error = 0;
+    uint32_t requests;
+    local_error = sps30_config_reconcile(&desired, &result);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "config_reconcile");
+    CHECK_EQUAL(SPS30_CONFIG_WRITTEN, result.outcome);
+    CHECK_EQUAL(3600, simulator.auto_cleaning_interval_s);
+    requests = simulator.requests;
+    local_error = sps30_config_reconcile(&desired, &result);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "config_reconcile again");
+    CHECK_EQUAL(SPS30_CONFIG_UNCHANGED, result.outcome);
+    CHECK_EQUAL(requests, simulator.requests);
+    /* a write through the driver API updates the cache as well */
+    local_error = sps30_write_auto_cleaning_interval(7200);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "write_auto_cleaning_interval");
+    requests = simulator.requests;
+    local_error = sps30_config_reconcile(&desired, &result);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "config_reconcile after write");
+    CHECK_EQUAL(SPS30_CONFIG_WRITTEN, result.outcome);
+    CHECK_EQUAL(requests + 1, simulator.requests);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_config_reconcile_fleet_in_parallel) {
+    struct sps30_config_result results[3];
+    struct sps30_config desired = {3600};
+    const uint16_t ports[3] = {0, 1, 2};
+    struct sps30_simulator second;
+    uint16_t failed;
+    /* sensors on ports 0 and 2, nothing answers on port 1 */
+    sps30_simulator_init(&second, 2);
+    sensirion_uart_hal_select_port(2);
+    sensirion_uart_hal_virtual_set_device(simulated_sps30, &second);
+    sensirion_uart_hal_virtual_set_response_delay_usec(
+        SPS30_RESPONSE_DELAY_US);
+    sensirion_uart_hal_select_port(0);
+    sps30_config_invalidate(1);
+    sps30_config_invalidate(2);
+    failed = sps30_config_reconcile_fleet(
+        ports, 3, &desired, SPS30_AUTO_CLEANING_INTERVAL_TIMEOUT_MS, results);
+    CHECK_EQUAL(1, failed);
+    CHECK_EQUAL(SPS30_CONFIG_WRITTEN, results[0].outcome);
+    CHECK_EQUAL(SPS30_CONFIG_FAILED, results[1].outcome);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, results[1].error);
+    CHECK_EQUAL(SPS30_CONFIG_WRITTEN, results[2].outcome);
+    CHECK_EQUAL(3600, simulator.auto_cleaning_interval_s);
+    CHECK_EQUAL(3600, second.auto_cleaning_interval_s);
+    CHECK_EQUAL(0, sensirion_uart_hal_get_selected_port());
+    /* one timeout for the read round and one round trip for the writes */
+    CHECK(sensirion_uart_hal_get_time_usec() <=
+          SPS30_AUTO_CLEANING_INTERVAL_TIMEOUT_MS * 1000 +
+              SPS30_RESPONSE_DELAY_US);
+}
+
+static const struct sps30_duty_cycle_config battery_duty_cycle = {
+    1000, 120000, 8000, 3.0f};
+
+TEST (SPS30_Virtual_Time_Tests, test_duty_cycle_sleeps_while_stable) {
+    struct sps30_duty_cycle_status status;
+    int16_t local_error = 0;
+    uint32_t samples;
+    /* the simulated concentration only varies within the threshold */
+    local_error = sps30_duty_cycle_set_config(0, &battery_duty_cycle);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "duty_cycle_set_config");
+    local_error = sps30_duty_cycle_start();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "duty_cycle_start");
+    CHECK_EQUAL(SPS30_SIMULATOR_MEASURING, simulator.mode);
+    samples = run_duty_cycle(3600ull * 1000000);
+    sps30_duty_cycle_get_status(0, &status);
+    CHECK_EQUAL(samples, status.samples);
+    CHECK_EQUAL(120000, status.period_ms);
+    /* one sample per period after the warm-up, the fan runs for ~9 s each */
+    CHECK(samples >= 3600 / 120);
+    CHECK(status.wake_ups >= 3600 / 120);
+    CHECK(status.discarded_samples >= 7 * status.wake_ups);
+    CHECK(status.fan_on_ms < 3600000 / 10);
+    CHECK(status.fan_on_ms >= (uint64_t)8000 * status.wake_ups);
+    local_error = sps30_duty_cycle_stop();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "duty_cycle_stop");
+    CHECK_EQUAL(SPS30_SIMULATOR_IDLE, simulator.mode);
+    CHECK_EQUAL(UINT32_MAX, sps30_duty_cycle_get_wait_ms());
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_duty_cycle_speeds_up_on_change) {
+    struct sps30_sample sample;
+    struct sps30_duty_cycle_status status;
+    int16_t local_error = 0;
+    uint32_t wait_ms;
+    local_error = sps30_duty_cycle_set_config(0, &battery_duty_cycle);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "duty_cycle_set_config");
+    local_error = sps30_duty_cycle_start();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "duty_cycle_start");
+    run_duty_cycle(600ull * 1000000);
+    sps30_duty_cycle_get_status(0, &status);
+    CHECK_EQUAL(120000, status.period_ms);
+    /* an event: the next sample restores the shortest period */
+    simulator.concentration_offset = 50;
+    do {
+        wait_ms = sps30_duty_cycle_get_wait_ms();
+        sensirion_uart_hal_sleep_usec(wait_ms * 1000);
+        local_error = sps30_duty_cycle_poll(&sample);
+    } while (local_error == SENSIRION_SHDLC_ERR_NO_DATA);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "duty_cycle_poll");
+    CHECK(sample.mc_2p5 > 60.0f);
+    sps30_duty_cycle_get_status(0, &status);
+    CHECK_EQUAL(1000, status.period_ms);
+    CHECK_EQUAL(SPS30_DUTY_CYCLE_MEASURING, status.state);
+    CHECK_EQUAL(SPS30_SIMULATOR_MEASURING, simulator.mode);
+    CHECK_EQUAL(1000, sps30_duty_cycle_get_wait_ms());
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_cleaning_pauses_duty_cycle) {
+    const struct sps30_duty_cycle_config continuous = {1000, 1000, 0, 3.0f};
+    struct sps30_sample sample;
+    struct sps30_cleaning_status status;
+    int16_t local_error = 0;
+    uint32_t requests;
+    local_error = sps30_duty_cycle_set_config(0, &continuous);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "duty_cycle_set_config");
+    local_error = sps30_duty_cycle_start();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "duty_cycle_start");
+    CHECK_EQUAL(3, run_duty_cycle(3500000));
+    local_error = sps30_start_fan_cleaning();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_fan_cleaning");
+    CHECK(sps30_cleaning_is_active());
+    CHECK_EQUAL(SPS30_CLEANING_DURATION_MS,
+                sps30_cleaning_get_remaining_ms());
+    /* no transaction is spent on the values measured while cleaning */
+    requests = simulator.requests;
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA, sps30_duty_cycle_poll(&sample));
+    CHECK_EQUAL(SPS30_CLEANING_DURATION_MS + 1000,
+                sps30_duty_cycle_get_wait_ms());
+    run_duty_cycle(sensirion_uart_hal_get_time_usec() +
+                   SPS30_CLEANING_DURATION_MS * 1000);
+    CHECK_EQUAL(requests, simulator.requests);
+    CHECK(!sps30_cleaning_is_active());
+    sps30_cleaning_get_status(0, &status);
+    CHECK_EQUAL(1, status.manual_cleanings);
+    CHECK(!status.automatic);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_cleaning_predicts_automatic) {
+    struct sps30_cleaning_status status;
+    int16_t local_error = 0;
+    local_error = sps30_write_auto_cleaning_interval(60);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "write_auto_cleaning_interval");
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    sps30_cleaning_get_status(0, &status);
+    CHECK_EQUAL(sensirion_uart_hal_get_time_usec() + 60000000,
+                status.next_automatic_us);
+    sensirion_uart_hal_virtual_advance_usec(59000000);
+    CHECK(!sps30_cleaning_is_active());
+    sensirion_uart_hal_virtual_advance_usec(2000000);
+    CHECK(sps30_cleaning_is_active());
+    sensirion_uart_hal_virtual_advance_usec(SPS30_CLEANING_DURATION_MS * 1000);
+    CHECK(!sps30_cleaning_is_active());
+    /* a cleaning which falls due while idle runs with the next start */
+    local_error = sps30_stop_measurement();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "stop_measurement");
+    sensirion_uart_hal_virtual_advance_usec(120000000);
+    CHECK(!sps30_cleaning_is_active());
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement again");
+    CHECK(sps30_cleaning_is_active());
+    sps30_cleaning_get_status(0, &status);
+    CHECK_EQUAL(2, status.automatic_cleanings);
+    CHECK_EQUAL(0, status.manual_cleanings);
+    /* an interval of 0 disables the automatic cleaning */
+    local_error = sps30_write_auto_cleaning_interval(0);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "write_auto_cleaning_interval 0");
+    sensirion_uart_hal_virtual_advance_usec(600000000);
+    CHECK(!sps30_cleaning_is_active());
+    sps30_cleaning_get_status(0, &status);
+    CHECK_EQUAL(0, status.next_automatic_us);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_cleaning_staggers_fleet) {
+    struct sps30_config_result results[2];
+    struct sps30_cleaning_status status;
+    struct sps30_config disabled = {0};
+    const uint16_t ports[2] = {0, 2};
+    struct sps30_simulator second;
+    int16_t local_error = 0;
+    uint16_t active;
+    uint16_t i;
+    uint32_t t;
+    sps30_simulator_init(&second, 2);
+    sensirion_uart_hal_select_port(2);
+    sensirion_uart_hal_virtual_set_device(simulated_sps30, &second);
+    sensirion_uart_hal_select_port(0);
+    sps30_config_invalidate(2);
+    sps30_cleaning_invalidate(2);
+    CHECK_EQUAL(0, sps30_config_reconcile_fleet(
+                       ports, 2, &disabled,
+                       SPS30_AUTO_CLEANING_INTERVAL_TIMEOUT_MS, results));
+    local_error = sps30_cleaning_stagger(ports, 2, 100);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "cleaning_stagger");
+    for (i = 0; i < 2; i++) {
+        sensirion_uart_hal_select_port(ports[i]);
+        local_error =
+            sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+        CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    }
+    /* never more than one sensor of the fleet is blind */
+    for (t = 0; t < 250; t++) {
+        active = 0;
+        for (i = 0; i < 2; i++) {
+            sensirion_uart_hal_select_port(ports[i]);
+            local_error = sps30_cleaning_poll();
+            CHECK_EQUAL_ZERO_TEXT(local_error, "cleaning_poll");
+            if (sps30_cleaning_is_active()) {
+                active++;
+            }
+        }
+        CHECK(active <= 1);
+        sensirion_uart_hal_virtual_advance_usec(1000000);
+    }
+    sensirion_uart_hal_select_port(0);
+    for (i = 0; i < 2; i++) {
+        sps30_cleaning_get_status(ports[i], &status);
+        CHECK_EQUAL(2, status.manual_cleanings);
+        CHECK_EQUAL(0, status.automatic_cleanings);
+    }
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_empty_measurement_response_is_no_data) {
+    struct sps30_sample sample;
+    int16_t local_error = 0;
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    sample.mc_2p5 = -1.0f;
+    local_error = sps30_sample_read(&sample);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA, local_error);
+    CHECK(sample.mc_2p5 == -1.0f);
+    sensirion_uart_hal_sleep_usec(1000000);
+    local_error = sps30_sample_read(&sample);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "sample_read");
+    CHECK(sample.mc_2p5 > 0.0f);
+    CHECK_EQUAL(sensirion_uart_hal_get_time_usec(), sample.timestamp_us);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_fast_start_overlaps_spin_up) {
+    const struct sps30_config desired = {3600};
+    const struct sps30_fast_start_config config = {true, &desired, 3000};
+    struct sps30_fast_start_result result;
+    struct sps30_identity identity;
+    int16_t local_error = 0;
+    local_error = sps30_sleep();
+    CHECK_EQUAL_ZERO_TEXT(local_error, "sleep");
+    local_error = sps30_fast_start(&config, &result);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "fast_start");
+    CHECK_EQUAL_ZERO_TEXT(result.identity_error, "identity_read");
+    CHECK_EQUAL(SPS30_CONFIG_WRITTEN, result.config.outcome);
+    CHECK_EQUAL(3600, simulator.auto_cleaning_interval_s);
+    CHECK_EQUAL(SPS30_SIMULATOR_MEASURING, simulator.mode);
+    local_error = sps30_identity_get(0, &identity);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "identity_get");
+    /* identity and configuration took no time of their own */
+    CHECK(result.time_to_first_sample_ms >= 1000);
+    CHECK(result.time_to_first_sample_ms <= 1000 + SPS30_FAST_START_POLL_MS);
+    CHECK(result.sample.mc_2p5 > 0.0f);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_fast_start_fleet_in_parallel) {
+    const struct sps30_fast_start_config config = {false, NULL, 3000};
+    struct sps30_fast_start_result results[3];
+    const uint16_t ports[3] = {0, 1, 2};
+    struct sps30_simulator second;
+    uint16_t started;
+    /* sensors on ports 0 and 2, nothing answers on port 1 */
+    sps30_simulator_init(&second, 2);
+    sensirion_uart_hal_select_port(2);
+    sensirion_uart_hal_virtual_set_device(simulated_sps30, &second);
+    sensirion_uart_hal_virtual_set_response_delay_usec(
+        SPS30_RESPONSE_DELAY_US);
+    sensirion_uart_hal_select_port(0);
+    sps30_identity_invalidate(2);
+    started = sps30_fast_start_fleet(ports, 3, &config, results);
+    CHECK_EQUAL(2, started);
+    CHECK_EQUAL(0, sensirion_uart_hal_get_selected_port());
+    CHECK_EQUAL_ZERO_TEXT(results[0].error, "first sample port 0");
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, results[1].error);
+    CHECK_EQUAL_ZERO_TEXT(results[2].error, "first sample port 2");
+    CHECK_EQUAL(SPS30_SIMULATOR_MEASURING, second.mode);
+    /* both fans spun up at once, despite the timeout of port 1 */
+    CHECK(results[0].time_to_first_sample_ms <=
+          1000 + SPS30_FAST_START_POLL_MS);
+    CHECK(results[2].time_to_first_sample_ms <=
+          1000 + SPS30_START_MEASUREMENT_TIMEOUT_MS +
+              2 * SPS30_FAST_START_POLL_MS);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_ring_acquires_samples) {
+    struct sps30_ring_record storage[4];
+    struct sps30_ring_record record;
+    struct sps30_ring ring;
+    int16_t local_error = 0;
+    sps30_ring_init(&ring, storage, 4);
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    sensirion_uart_hal_sleep_usec(1000000);
+    local_error = sps30_ring_acquire(&ring);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "ring_acquire");
+    /* no new values, nothing is appended */
+    local_error = sps30_ring_acquire(&ring);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA, local_error);
+    CHECK_EQUAL(1, sps30_ring_drain(&ring, &record, 1));
+    CHECK_EQUAL(0, record.port);
+    CHECK(record.sample.mc_2p5 > 0.0f);
+    CHECK(record.sample.timestamp_us >= 1000000);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_latest_table_publishes_driver_state) {
+    static struct sps30_latest_table table;
+    struct sps30_latest_entry entry;
+    struct sps30_sample sample;
+    uint32_t status_register;
+    int16_t local_error = 0;
+    uint8_t reserved;
+    sps30_latest_init(&table);
+    CHECK_EQUAL_ZERO_TEXT(sps30_latest_check(&table), "latest_check");
+    sps30_latest_publish_to(&table);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA,
+                sps30_latest_read(&table, 0, &entry));
+    local_error =
+        sps30_start_measurement(SPS30_OUTPUT_FORMAT_OUTPUT_FORMAT_FLOAT);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "start_measurement");
+    sensirion_uart_hal_sleep_usec(1000000);
+    local_error = sps30_sample_read(&sample);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "sample_read");
+    local_error = sps30_latest_read(&table, 0, &entry);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "latest_read");
+    CHECK_EQUAL(1, entry.samples);
+    CHECK_EQUAL(sample.timestamp_us, entry.sample.timestamp_us);
+    CHECK_EQUAL(sample.mc_2p5, entry.sample.mc_2p5);
+    /* no new values are not a failure */
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA, sps30_sample_read(&sample));
+    simulator.status_register = 0x00200000;
+    local_error =
+        sps30_read_device_status_register(false, &status_register, &reserved);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "read_device_status_register");
+    sensirion_uart_hal_virtual_set_device(faulty_sps30, &simulator);
+    condition = SENSOR_DEAD;
+    sensirion_uart_hal_sleep_usec(1000000);
+    local_error = sps30_sample_read(&sample);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA,
+                sps30_latest_read(&table, 1, &entry));
+    CHECK_EQUAL(SPS30_HEALTH_FAILING, sps30_health_update(local_error));
+    local_error = sps30_latest_read(&table, 0, &entry);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "latest_read");
+    CHECK_EQUAL(1, entry.samples);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, entry.last_error);
+    CHECK_EQUAL(SPS30_HEALTH_FAILING, entry.health);
+    CHECK_EQUAL(0x00200000, entry.device_status);
+    CHECK(entry.device_status_time_us > sample.timestamp_us);
+    CHECK_EQUAL(sensirion_uart_hal_get_time_usec(), entry.updated_us);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_latest_reader_never_waits_for_writer) {
+    static struct sps30_latest_table table;
+    struct sps30_latest_entry entry;
+    struct sps30_sample sample = {0};
+    sps30_latest_init(&table);
+    sps30_latest_publish_to(&table);
+    sps30_latest_sample_read(NO_ERROR, &sample);
+    CHECK_EQUAL(2, table.slots[0].sequence);
+    /* a writer which stopped during an update */
+    table.slots[0].sequence = 3;
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA,
+                sps30_latest_read(&table, 0, &entry));
+    /* a reader built with another layout */
+    table.slots[0].sequence = 2;
+    table.port_count = SENSIRION_UART_MAX_PORTS + 1;
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT,
+                sps30_latest_check(&table));
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_invalid_port_is_rejected) {
+    static struct sps30_latest_table table;
+    const uint16_t port = SENSIRION_UART_MAX_PORTS;
+    struct sensirion_shdlc_retry_policy policy;
+    struct sps30_health_status health;
+    struct sps30_duty_cycle_status duty_cycle;
+    struct sps30_cleaning_status cleaning;
+    struct sps30_config config;
+    struct sps30_identity identity;
+    struct sps30_latest_entry entry;
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT,
+                sensirion_shdlc_retry_get_policy(port, &policy));
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT,
+                sps30_health_get_status(port, &health));
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT,
+                sps30_duty_cycle_get_status(port, &duty_cycle));
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT,
+                sps30_cleaning_get_status(port, &cleaning));
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT,
+                sps30_cleaning_stagger(&port, 1, 3600));
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT,
+                sps30_config_get(port, &config));
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT,
+                sps30_identity_get(port, &identity));
+    sps30_latest_init(&table);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_INVALID_ARGUMENT,
+                sps30_latest_read(&table, port, &entry));
+    /* a valid port without data is told apart */
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA, sps30_config_get(0, &config));
+}
+
+#if SENSIRION_SHDLC_ADAPTIVE_TIMEOUT
+
+/* drop a late response, as a real application would by reopening the port */
+static void discard_late_response() {
+    sensirion_uart_hal_virtual_advance_usec(1000000);
+    sensirion_uart_hal_init(SERIAL_0);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_adaptive_timeout_detects_dead_sensor) {
+    int16_t local_error = 0;
+    uint64_t start_us;
+    uint32_t i;
+    sensirion_uart_hal_virtual_set_response_delay_usec(2000);
+    for (i = 0; i < 20; i++) {
+        local_error = read_version();
+        CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    }
+    sensirion_uart_hal_virtual_set_device(NULL, NULL);
+    start_us = sensirion_uart_hal_get_time_usec();
+    local_error = read_version();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, local_error);
+    CHECK_EQUAL(SENSIRION_SHDLC_TIMEOUT_MIN_MS * 1000,
+                sensirion_uart_hal_get_time_usec() - start_us);
+}
+
+TEST (SPS30_Virtual_Time_Tests, test_adaptive_timeout_follows_slow_sensor) {
+    struct sensirion_shdlc_timeout_estimate estimate;
+    int16_t local_error = 0;
+    uint32_t timeouts = 0;
+    uint32_t i;
+    sensirion_uart_hal_virtual_set_response_delay_usec(2000);
+    for (i = 0; i < 20; i++) {
+        local_error = read_version();
+        CHECK_EQUAL_ZERO_TEXT(local_error, "read_version");
+    }
+    /* the sensor slows down, but stays within the command timeout */
+    sensirion_uart_hal_virtual_set_response_delay_usec(
+        SPS30_READ_VERSION_TIMEOUT_MS * 1000 - 10000);
+    for (i = 0; i < 20; i++) {
+        local_error = read_version();
+        if (local_error != NO_ERROR) {
+            CHECK_EQUAL(SENSIRION_SHDLC_ERR_MISSING_START, local_error);
+            timeouts++;
+            discard_late_response();
+        }
+    }
+    CHECK(timeouts <= 3);
+    /* every timeout doubled the deadline until the responses fit again */
+    for (i = 0; i < 100; i++) {
+        local_error = read_version();
+        CHECK_EQUAL_ZERO_TEXT(local_error, "read_version after adapting");
+    }
+    local_error = sensirion_shdlc_timeout_get_estimate(
+        0, SPS30_READ_VERSION_CMD_ID, &estimate);
+    CHECK_EQUAL_ZERO_TEXT(local_error, "get_estimate");
+    CHECK_EQUAL(0, estimate.timeouts);
+}
+
+#endif /* SENSIRION_SHDLC_ADAPTIVE_TIMEOUT */